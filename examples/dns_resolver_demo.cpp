@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <lim/base/dns_resolver.h>
+
+#define STUB_DNS_PORT 8153
+
+namespace lim {
+  //本地DNS桩服务器: 按查询的域名返回预设的应答, 用于验证应答校验逻辑
+  class StubNameServer {
+  public:
+    StubNameServer(int port): is_running_(true) {
+      fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+      bind(fd_, (struct sockaddr *)&addr, sizeof(addr));
+      thread_ = std::thread(&StubNameServer::Run, this);
+    }
+
+    virtual ~StubNameServer() {
+      is_running_ = false;
+      thread_.join();
+      close(fd_);
+    }
+
+    int GetQueryNum(const std::string &name) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return query_nums_[name];
+    }
+
+  private:
+    static void AppendName(std::string &packet, const std::string &name) {
+      size_t start = 0;
+      while (start < name.size()) {
+        size_t end = name.find('.', start);
+        if (end == std::string::npos) {
+          end = name.size();
+        }
+        packet += (char)(end - start);
+        packet += name.substr(start, end - start);
+        start = end + 1;
+      }
+      packet += '\0';
+    }
+
+    static void AppendUint16(std::string &packet, int value) {
+      packet += (char)((value >> 8) & 0xFF);
+      packet += (char)(value & 0xFF);
+    }
+
+    static void AppendUint32(std::string &packet, uint32_t value) {
+      AppendUint16(packet, (int)(value >> 16));
+      AppendUint16(packet, (int)(value & 0xFFFF));
+    }
+
+    static std::string Header(int id, int flags, int answer_num) {
+      std::string packet;
+      AppendUint16(packet, id);
+      AppendUint16(packet, flags);
+      AppendUint16(packet, 1);
+      AppendUint16(packet, answer_num);
+      AppendUint16(packet, 0);
+      AppendUint16(packet, 0);
+      return packet;
+    }
+
+    static std::string Question(const std::string &name) {
+      std::string packet;
+      AppendName(packet, name);
+      AppendUint16(packet, 1); //A
+      AppendUint16(packet, 1); //IN
+      return packet;
+    }
+
+    static std::string ARecord(const std::string &owner, const std::string &ip, uint32_t ttl) {
+      std::string packet;
+      AppendName(packet, owner);
+      AppendUint16(packet, 1);
+      AppendUint16(packet, 1);
+      AppendUint32(packet, ttl);
+      AppendUint16(packet, 4);
+      struct in_addr addr;
+      inet_pton(AF_INET, ip.c_str(), &addr);
+      packet.append((const char *)&addr, 4);
+      return packet;
+    }
+
+    static std::string CnameRecord(const std::string &owner, const std::string &target, uint32_t ttl) {
+      std::string data;
+      AppendName(data, target);
+      std::string packet;
+      AppendName(packet, owner);
+      AppendUint16(packet, 5);
+      AppendUint16(packet, 1);
+      AppendUint32(packet, ttl);
+      AppendUint16(packet, (int)data.size());
+      return packet + data;
+    }
+
+    void Reply(const std::string &packet, struct sockaddr_in &client) {
+      sendto(fd_, packet.data(), packet.size(), 0, (struct sockaddr *)&client, sizeof(client));
+    }
+
+    void Run() {
+      while (is_running_) {
+        struct pollfd poll_fd = { fd_, POLLIN, 0 };
+        if (poll(&poll_fd, 1, 100) <= 0) {
+          continue;
+        }
+
+        uint8_t query[512];
+        struct sockaddr_in client;
+        socklen_t client_length = sizeof(client);
+        int length = (int)recvfrom(fd_, query, sizeof(query), 0, (struct sockaddr *)&client, &client_length);
+        if (length < 17) {
+          continue;
+        }
+
+        int id = (query[0] << 8) | query[1];
+        std::string name;
+        for (int offset = 12; offset < length && query[offset] != 0; offset += query[offset] + 1) {
+          if (!name.empty()) {
+            name += '.';
+          }
+          name.append((const char *)query + offset + 1, query[offset]);
+        }
+        {
+          std::lock_guard<std::mutex> guard(mutex_);
+          query_nums_[name]++;
+        }
+
+        if (name == "ok.test") {
+          //ID不匹配及问题不匹配的应答应被忽略, 所属域名不是查询域名的A记录应被跳过
+          Reply(Header(id ^ 1, 0x8180, 1) + Question(name) + ARecord(name, "10.0.0.99", 60), client);
+          Reply(Header(id, 0x8180, 1) + Question("other.test") + ARecord("other.test", "10.0.0.98", 60), client);
+          Reply(Header(id, 0x8180, 2) + Question(name) + ARecord("evil.test", "10.0.0.97", 60) +
+            ARecord(name, "10.0.0.1", 60), client);
+        } else if (name == "alias.test") {
+          Reply(Header(id, 0x8180, 3) + Question(name) + CnameRecord(name, "real.test", 30) +
+            ARecord("other.test", "10.0.0.66", 60) + ARecord("real.test", "10.0.0.2", 60), client);
+        } else if (name == "slow.test") {
+          //延迟应答, 期间的并发解析应合并为一次查询
+          usleep(200 * 1000);
+          Reply(Header(id, 0x8180, 1) + Question(name) + ARecord(name, "10.0.0.3", 60), client);
+        } else if (name == "nx.test") {
+          Reply(Header(id, 0x8183, 0) + Question(name), client);
+        } else if (name == "drop.test") {
+          //不应答(模拟服务器不可用)
+        } else {
+          //截断的应答(TC=1)不带任何记录
+          Reply(Header(id, 0x8380, 0) + Question(name), client);
+        }
+      }
+    }
+
+  private:
+    int fd_;
+    std::atomic<bool> is_running_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::map<std::string, int> query_nums_;
+  };
+}
+
+using namespace lim;
+static std::string ResolveSync(DnsResolver &resolver, const std::string &host_name) {
+  std::promise<std::string> promise;
+  std::future<std::string> future = promise.get_future();
+  resolver.Resolve(host_name, [&promise](const std::string &ip) {
+    promise.set_value(ip);
+  });
+  return future.get();
+}
+
+static bool Check(const char *name, const std::string &value, const std::string &expected) {
+  bool is_ok = (value == expected);
+  printf("%-40s expected: %-12s got: %-12s %s\n", name, expected.c_str(), value.c_str(), (is_ok ? "ok" : "FAILED"));
+  return is_ok;
+}
+
+//DnsResolver测试: 对本地DNS桩服务器验证并发解析合并、缓存命中、ID及问题不匹配、CNAME链、NXDOMAIN、超时及截断应答的处理
+int main() {
+  StubNameServer name_server(STUB_DNS_PORT);
+  DnsResolver resolver(1);
+  resolver.SetNameServer("127.0.0.1", STUB_DNS_PORT);
+  resolver.SetQueryTimeout(500, 1);
+
+  bool is_ok = true;
+  //并发解析同一域名只发送一次查询
+  const int kResolveNum = 8;
+  std::atomic<int> done_num(0), match_num(0);
+  for (int i = 0; i < kResolveNum; i++) {
+    resolver.Resolve("slow.test", [&](const std::string &ip) {
+      match_num += (ip == "10.0.0.3" ? 1 : 0);
+      done_num++;
+    });
+  }
+  while (done_num < kResolveNum) {
+    usleep(1000);
+  }
+  is_ok &= Check("concurrent resolves coalesced", std::to_string(match_num) + "/" + std::to_string(name_server.GetQueryNum("slow.test")),
+    std::to_string(kResolveNum) + "/1");
+  //缓存命中时不再查询
+  is_ok &= Check("positive cache hit", ResolveSync(resolver, "slow.test"), "10.0.0.3");
+  is_ok &= Check("positive cache hit not queried", std::to_string(name_server.GetQueryNum("slow.test")), "1");
+
+  is_ok &= Check("id/question mismatch, foreign A record", ResolveSync(resolver, "ok.test"), "10.0.0.1");
+  is_ok &= Check("cname chain", ResolveSync(resolver, "alias.test"), "10.0.0.2");
+
+  is_ok &= Check("nxdomain", ResolveSync(resolver, "nx.test"), "");
+  std::string ip = "-";
+  is_ok &= Check("nxdomain negative cached", (resolver.Lookup("nx.test", ip) ? "[" + ip + "]" : "miss"), "[]");
+  is_ok &= Check("nxdomain not retried", std::to_string(name_server.GetQueryNum("nx.test")), "1");
+
+  //超时重试后失败, 不作为失败结果缓存
+  is_ok &= Check("timeout", ResolveSync(resolver, "drop.test"), "");
+  is_ok &= Check("timeout retried", std::to_string(name_server.GetQueryNum("drop.test")), "2");
+  ip = "-";
+  is_ok &= Check("timeout not cached", (resolver.Lookup("drop.test", ip) ? "[" + ip + "]" : "miss"), "miss");
+
+  //截断的应答改用getaddrinfo解析, 不作为失败结果缓存
+  is_ok &= Check("truncated falls back to getaddrinfo", ResolveSync(resolver, "localhost"), "127.0.0.1");
+  ip = "-";
+  is_ok &= Check("truncated cached from getaddrinfo", (resolver.Lookup("localhost", ip) ? "[" + ip + "]" : "miss"), "[127.0.0.1]");
+  return (is_ok ? 0 : 1);
+}
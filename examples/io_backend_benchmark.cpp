@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <lim/base/bootstrap.h>
+#include <lim/base/server_channel_session.h>
+#include <lim/base/connected_channel_session.h>
+#include <lim/base/time_utils.h>
+
+#define ECHO_MESSAGE_SIZE 64
+
+namespace lim {
+  class EchoMessage : public Message {
+  public:
+    EchoMessage(ByteBuffer &buffer) {
+      buffer.ReadBytes(data_, ECHO_MESSAGE_SIZE);
+    }
+    virtual ~EchoMessage() = default;
+
+  public:
+    virtual int ToBytes(ByteBuffer &buffer) {
+      return buffer.WriteBytes(data_, ECHO_MESSAGE_SIZE);
+    }
+
+  private:
+    char data_[ECHO_MESSAGE_SIZE];
+  };
+
+  //定长报文解码器
+  class EchoMessageDecoder : public MessageDecoder {
+  public:
+    EchoMessageDecoder() = default;
+    virtual ~EchoMessageDecoder() = default;
+
+    virtual void Reset() {
+    }
+
+    virtual bool Decode(ByteBuffer &buffer, HandleMessageCallback &message_callback,
+      HandleErrorCallback &error_callback, bool is_socket_closed) {
+      while (buffer.ReadableBytes() >= ECHO_MESSAGE_SIZE) {
+        EchoMessage message(buffer);
+        if (!message_callback(message)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  class EchoServer : public ConnectedChannelSession {
+  public:
+    EchoServer(SocketChannel &channel, BootstrapConfig &config) :
+      ConnectedChannelSession(channel, config) {
+    }
+    virtual ~EchoServer() = default;
+
+  protected:
+    virtual MessageDecoder *CreateDecoder() {
+      return new EchoMessageDecoder();
+    }
+
+    virtual bool HandleMessage(Message &message) {
+      return WriteMessage(message);
+    }
+
+    virtual void HandleMessageError(MessageError &error) {
+    }
+  };
+}
+
+using namespace lim;
+//echo请求-响应测试: 多个阻塞客户端连接循环收发定长报文, 对比epoll与io_uring后端的吞吐量,
+//以及每个请求的内核态CPU时间与上下文切换次数(进程内无法直接统计系统调用, 以此近似)
+static void RunBenchmark(EventLoopBackend backend, bool is_run_to_completion, int port) {
+  const int kConnectionNum = 16;
+  const int kDurationMillisec = 2000;
+
+  //事件监听器先于工作线程析构(析构时清理的监听会话绑定在工作线程上)
+  ExecuteThreadGroup execute_thread_group(1);
+  EventLoopGroup event_loop_group(1, SelectPolicyType::ROUND_ROBIN, std::vector<int>(), backend);
+  BootstrapConfig config(event_loop_group, execute_thread_group);
+  config.SetRunToCompletion(is_run_to_completion);
+  Bootstrap strap = Bootstrap(config);
+  if (!strap.Bind<ServerChannelSession<EchoServer>>("127.0.0.1", port)) {
+    printf("bind port %d failed\n", port);
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::atomic<bool> is_running(true);
+  std::atomic<int64_t> request_num(0);
+  std::vector<int> fds;
+  for (int i = 0; i < kConnectionNum; i++) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+      printf("connect port %d failed\n", port);
+      close(fd);
+      continue;
+    }
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    fds.push_back(fd);
+  }
+
+  struct rusage start_usage, end_usage;
+  getrusage(RUSAGE_SELF, &start_usage);
+  int64_t start_time = SteadyMicroTime();
+
+  std::vector<std::thread> clients;
+  for (size_t i = 0; i < fds.size(); i++) {
+    int fd = fds[i];
+    clients.push_back(std::thread([&, fd] {
+      char data[ECHO_MESSAGE_SIZE];
+      memset(data, 'a', sizeof(data));
+      while (is_running) {
+        if (send(fd, data, sizeof(data), 0) != sizeof(data)) {
+          break;
+        }
+        int length = 0;
+        while (length < ECHO_MESSAGE_SIZE) {
+          int ret = (int)recv(fd, data + length, sizeof(data) - length, 0);
+          if (ret <= 0) {
+            return;
+          }
+          length += ret;
+        }
+        request_num++;
+      }
+    }));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(kDurationMillisec));
+  is_running = false;
+  for (size_t i = 0; i < clients.size(); i++) {
+    clients[i].join();
+  }
+  int64_t use_time = SteadyMicroTime() - start_time;
+  getrusage(RUSAGE_SELF, &end_usage);
+
+  for (size_t i = 0; i < fds.size(); i++) {
+    close(fds[i]);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  int64_t requests = request_num.load();
+  int64_t sys_time = (end_usage.ru_stime.tv_sec - start_usage.ru_stime.tv_sec) * 1000000 +
+    (end_usage.ru_stime.tv_usec - start_usage.ru_stime.tv_usec);
+  int64_t switches = (end_usage.ru_nvcsw - start_usage.ru_nvcsw) + (end_usage.ru_nivcsw - start_usage.ru_nivcsw);
+  printf("backend: %-8s rtc: %d, throughput: %9.0f req/s, sys cpu: %6.2f us/req, context switches: %5.2f /req\n",
+    (event_loop_group.Get(0).GetBackend() == EventLoopBackend::IO_URING ? "io_uring" : "epoll"), is_run_to_completion,
+    requests * 1000000.0 / use_time, requests > 0 ? (double)sys_time / requests : 0.0,
+    requests > 0 ? (double)switches / requests : 0.0);
+}
+
+int main() {
+  SocketChannel::InitEnviroment();
+  RunBenchmark(EventLoopBackend::EPOLL, false, 8101);
+  RunBenchmark(EventLoopBackend::IO_URING, false, 8102);
+  RunBenchmark(EventLoopBackend::EPOLL, true, 8103);
+  RunBenchmark(EventLoopBackend::IO_URING, true, 8104);
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <lim/base/bootstrap.h>
+#include <lim/base/server_channel_session.h>
+#include <lim/base/connected_channel_session.h>
+#include <lim/base/time_utils.h>
+
+#define ECHO_MESSAGE_SIZE 64
+
+namespace lim {
+  class EchoMessage : public Message {
+  public:
+    EchoMessage(ByteBuffer &buffer) {
+      buffer.ReadBytes(data_, ECHO_MESSAGE_SIZE);
+    }
+    virtual ~EchoMessage() = default;
+
+  public:
+    virtual int ToBytes(ByteBuffer &buffer) {
+      return buffer.WriteBytes(data_, ECHO_MESSAGE_SIZE);
+    }
+
+  private:
+    char data_[ECHO_MESSAGE_SIZE];
+  };
+
+  //定长报文解码器
+  class EchoMessageDecoder : public MessageDecoder {
+  public:
+    EchoMessageDecoder() = default;
+    virtual ~EchoMessageDecoder() = default;
+
+    virtual void Reset() {
+    }
+
+    virtual bool Decode(ByteBuffer &buffer, HandleMessageCallback &message_callback,
+      HandleErrorCallback &error_callback, bool is_socket_closed) {
+      while (buffer.ReadableBytes() >= ECHO_MESSAGE_SIZE) {
+        EchoMessage message(buffer);
+        if (!message_callback(message)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  class EchoServer : public ConnectedChannelSession {
+  public:
+    EchoServer(SocketChannel &channel, BootstrapConfig &config) :
+      ConnectedChannelSession(channel, config) {
+    }
+    virtual ~EchoServer() = default;
+
+  protected:
+    virtual MessageDecoder *CreateDecoder() {
+      return new EchoMessageDecoder();
+    }
+
+    virtual bool HandleMessage(Message &message) {
+      return WriteMessage(message);
+    }
+
+    virtual void HandleMessageError(MessageError &error) {
+    }
+  };
+}
+
+using namespace lim;
+//短连接测试: 多个客户端循环建立连接、收发一个定长报文后关闭, 对比单一监听与每个事件监听器一个SO_REUSEPORT监听的建连速率
+static void RunBenchmark(bool is_reuse_port, int port) {
+  const int kEventLoopNum = 4;
+  const int kClientNum = 16;
+  const int kDurationMillisec = 2000;
+
+  ExecuteThreadGroup execute_thread_group(kEventLoopNum);
+  EventLoopGroup event_loop_group(kEventLoopNum);
+  BootstrapConfig config(event_loop_group, execute_thread_group);
+  config.SetPinExecuteThread(true);
+  Bootstrap strap = Bootstrap(config);
+  bool is_bind = (is_reuse_port ? strap.BindReusePort<ServerChannelSession<EchoServer>>("127.0.0.1", port) :
+    strap.Bind<ServerChannelSession<EchoServer>>("127.0.0.1", port));
+  if (!is_bind) {
+    printf("bind port %d failed\n", port);
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::atomic<bool> is_running(true);
+  std::atomic<int64_t> connection_num(0);
+  int64_t start_time = SteadyMicroTime();
+
+  std::vector<std::thread> clients;
+  for (int i = 0; i < kClientNum; i++) {
+    clients.push_back(std::thread([&] {
+      char data[ECHO_MESSAGE_SIZE];
+      memset(data, 'a', sizeof(data));
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+      while (is_running) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        //关闭时发送RST, 避免大量TIME_WAIT耗尽本地端口
+        struct linger so_linger = { 1, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &so_linger, sizeof(so_linger));
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || send(fd, data, sizeof(data), 0) != sizeof(data)) {
+          close(fd);
+          continue;
+        }
+        int length = 0;
+        while (length < ECHO_MESSAGE_SIZE) {
+          int ret = (int)recv(fd, data + length, sizeof(data) - length, 0);
+          if (ret <= 0) {
+            break;
+          }
+          length += ret;
+        }
+        close(fd);
+        if (length == ECHO_MESSAGE_SIZE) {
+          connection_num++;
+        }
+      }
+    }));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(kDurationMillisec));
+  is_running = false;
+  for (size_t i = 0; i < clients.size(); i++) {
+    clients[i].join();
+  }
+  int64_t use_time = SteadyMicroTime() - start_time;
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  printf("listener: %-10s event loops: %d, throughput: %9.0f conn/s\n",
+    (is_reuse_port ? "reuseport" : "single"), kEventLoopNum, connection_num.load() * 1000000.0 / use_time);
+}
+
+int main() {
+  SocketChannel::InitEnviroment();
+  RunBenchmark(false, 8111);
+  RunBenchmark(true, 8112);
+  return 0;
+}
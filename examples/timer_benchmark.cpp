@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+#include <lim/base/execute_task.h>
+#include <lim/base/time_utils.h>
+
+using namespace lim;
+//定时器重置开销测试: 时间轮中已有N个定时器时, 随机重置定时器的平均耗时(应与N无关)
+int main() {
+  const int kTimerNums[] = { 1000, 10000, 100000, 1000000 };
+  const int kRearmCount = 1000000;
+
+  ExecuteThread execute_thread;
+  for (int timer_num : kTimerNums) {
+    std::vector<ExecuteTimer*> timers;
+    timers.reserve(timer_num);
+    for (int i = 0; i < timer_num; i++) {
+      ExecuteTimer *timer = new ExecuteTimer(execute_thread, NULL);
+      timer->Start(1000 + rand() % (60 * 1000));
+      timers.push_back(timer);
+    }
+
+    int64_t start_time = SteadyMicroTime();
+    for (int i = 0; i < kRearmCount; i++) {
+      timers[rand() % timer_num]->Start(1000 + rand() % (60 * 1000));
+    }
+    int64_t rearm_time = SteadyMicroTime() - start_time;
+
+    start_time = SteadyMicroTime();
+    for (int i = 0; i < timer_num; i++) {
+      timers[i]->Cancel();
+    }
+    int64_t cancel_time = SteadyMicroTime() - start_time;
+
+    printf("timers: %8d, rearm: %7.1f ns/op, cancel: %7.1f ns/op\n", timer_num,
+      rearm_time * 1000.0 / kRearmCount, cancel_time * 1000.0 / timer_num);
+
+    for (int i = 0; i < timer_num; i++) {
+      delete timers[i];
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <lim/base/execute_task.h>
+#include <lim/base/time_utils.h>
+
+using namespace lim;
+//倾斜负载测试: 部分线程上绑定了耗时(阻塞)任务, 统计轻量任务从触发到执行的延迟分布
+class BenchmarkTask : public ExecuteTask {
+public:
+  BenchmarkTask(ExecuteThread &execute_thread, int busy_microsec, std::vector<int64_t> &latencies, std::mutex &mutex) :
+    ExecuteTask(execute_thread), busy_microsec_(busy_microsec), signal_time_(0), latencies_(latencies), mutex_(mutex) {
+  }
+
+  void Trigger() {
+    signal_time_ = SteadyMicroTime();
+    Signal(ExecuteEvent::USER_EVENT);
+  }
+
+private:
+  virtual bool HandleUserEvent(int user_events) {
+    int64_t start_time = SteadyMicroTime();
+    if (busy_microsec_ > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(busy_microsec_));
+    } else {
+      std::lock_guard<std::mutex> guard(mutex_);
+      latencies_.push_back(start_time - signal_time_);
+    }
+    return true;
+  }
+
+private:
+  int busy_microsec_;
+  std::atomic<int64_t> signal_time_;
+  std::vector<int64_t> &latencies_;
+  std::mutex &mutex_;
+};
+
+static void RunBenchmark(bool is_work_stealing) {
+  const int kThreadNum = 4;
+  const int kTaskNum = 64;
+  const int kRoundNum = 200;
+
+  std::vector<int64_t> latencies;
+  std::mutex mutex;
+  ExecuteThreadGroup execute_thread_group(kThreadNum, is_work_stealing);
+  std::vector<BenchmarkTask*> tasks;
+  for (int i = 0; i < kTaskNum; i++) {
+    //轮询分配时, 第0个线程上的任务都是耗时任务
+    int busy_microsec = (i % kThreadNum == 0 && i < kThreadNum * 4) ? 2000 : 0;
+    tasks.push_back(new BenchmarkTask(execute_thread_group.Next(), busy_microsec, latencies, mutex));
+  }
+
+  for (int round = 0; round < kRoundNum; round++) {
+    for (int i = 0; i < kTaskNum; i++) {
+      tasks[i]->Trigger();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  std::sort(latencies.begin(), latencies.end());
+  size_t count = latencies.size();
+  printf("work stealing: %-3s, samples: %6zu, p50: %6lld us, p99: %6lld us, max: %6lld us\n",
+    is_work_stealing ? "on" : "off", count, (long long)latencies[count / 2],
+    (long long)latencies[count * 99 / 100], (long long)latencies[count - 1]);
+}
+
+int main() {
+  RunBenchmark(false);
+  RunBenchmark(true);
+  return 0;
+}
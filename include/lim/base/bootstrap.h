@@ -2,6 +2,7 @@
 #define LIM_BOOTSTRAP_H
 #include <lim/config.h>
 #include <lim/base/bootstrap_config.h>
+#include <lim/base/dns_resolver.h>
 #ifdef ENABLE_OPENSSL
 #include <lim/base/sslcontext.h>
 #endif
@@ -9,7 +10,7 @@
 namespace lim {
   class Bootstrap {
   public:
-    Bootstrap(BootstrapConfig &config): config_(config) {
+    Bootstrap(BootstrapConfig &config): config_(config), dns_resolver_(NULL) {
 #ifdef ENABLE_OPENSSL
       server_ssl_context_ = NULL;
 			client_ssl_context_ = NULL;
@@ -17,6 +18,10 @@ namespace lim {
     }
 
     virtual ~Bootstrap() = default;
+
+    //设置域名解析服务(未设置时使用不缓存结果的默认解析服务; 解析服务需比发起的连接请求存活更久)
+    void SetDnsResolver(DnsResolver *dns_resolver) { dns_resolver_ = dns_resolver; }
+    DnsResolver *GetDnsResolver() { return dns_resolver_; }
 		
 #ifdef ENABLE_OPENSSL
     void SetServerSSLContext(SSLContext *server_ssl_context) { server_ssl_context_ = server_ssl_context; };
@@ -34,7 +39,7 @@ namespace lim {
         channel.SetSSLContext(server_ssl_context_);
       }
 #endif
-      if (!channel.Bind(unix_path)) {
+      if (!channel.Bind(unix_path, config_.GetSocketOptions())) {
         return false;
       }
 
@@ -54,7 +59,7 @@ namespace lim {
         channel.SetSSLContext(server_ssl_context_);
       }
 #endif
-      if (!channel.Bind(local_ip, local_port)) {
+      if (!channel.Bind(local_ip, local_port, config_.GetSocketOptions())) {
         return false;
       }
 
@@ -66,6 +71,46 @@ namespace lim {
       return true;
     }
 
+    /**
+    *每个事件监听器绑定一个SO_REUSEPORT监听socket, 在各自的IO线程中accept, 新连接留在接收它的事件监听器
+    * @param local_ip 本地地址
+    * @param local_port 本地端口
+    * @param is_cpu_steering 是否附加按CPU分配连接的CBPF程序(事件监听器i应绑定在CPU i上, 不支持时按四元组哈希分配)
+    * @param init_params_callback 监听对象初始化回调
+    * @return 成功返回true
+    */
+    template<typename T>
+		bool BindReusePort(const std::string &local_ip, int local_port, bool is_cpu_steering = false, std::function<void(T&)> init_params_callback = NULL) {
+      int event_loop_num = config_.EventLoopNum();
+      std::vector<SocketChannel> channels(event_loop_num);
+      for (int i = 0; i < event_loop_num; i++) {
+#ifdef ENABLE_OPENSSL
+        if (server_ssl_context_ != NULL) {
+          channels[i].SetSSLContext(server_ssl_context_);
+        }
+#endif
+        if (!channels[i].Bind(local_ip, local_port, config_.GetSocketOptions(), true)) {
+          for (int j = 0; j < i; j++) {
+            channels[j].Close();
+          }
+          return false;
+        }
+      }
+
+      if (is_cpu_steering) {
+        channels[0].AttachReusePortCpuFilter(event_loop_num);
+      }
+
+      for (int i = 0; i < event_loop_num; i++) {
+        T *server = new T(channels[i], config_, i);
+        if (init_params_callback != NULL) {
+          init_params_callback(*server);
+        }
+        server->Signal(ExecuteEvent::INIT_EVENT);
+      }
+      return true;
+    }
+
     template<typename T>
 		bool Connect(const std::string &unix_path, std::function<void(T&)> init_params_callback = NULL) {
       SocketChannel channel;
@@ -74,7 +119,7 @@ namespace lim {
         channel.SetSSLContext(client_ssl_context_);
       }
 #endif
-      if (!channel.Connect(unix_path)) {
+      if (!channel.Connect(unix_path, config_.GetSocketOptions())) {
         return false;
       }
 
@@ -86,28 +131,66 @@ namespace lim {
       return true;
     }
 
+    /**
+    *连接远端地址(异步解析域名, 不阻塞调用线程; 解析或连接失败时仍创建连接对象, 通过HandleMessageError报告ConnectError)
+    * @param remote_host 对端域名或IP地址
+    * @param remote_port 对端端口
+    * @param init_params_callback 连接对象初始化回调
+    * @return 总是返回true(失败通过连接对象报告)
+    */
     template<typename T>
-		bool Connect(const std::string &remote_ip, int remote_port, std::function<void(T&)> init_params_callback = NULL) {
+		bool Connect(const std::string &remote_host, int remote_port, std::function<void(T&)> init_params_callback = NULL) {
       SocketChannel channel;
 #ifdef ENABLE_OPENSSL
       if (client_ssl_context_ != NULL) {
         channel.SetSSLContext(client_ssl_context_);
       }
 #endif
-      if (!channel.Connect(remote_ip, remote_port)) {
-        return false;
+      DnsResolver *dns_resolver = (dns_resolver_ != NULL ? dns_resolver_ : DefaultDnsResolver());
+      BootstrapConfig &config = config_;
+      dns_resolver->Resolve(remote_host, [&config, channel, remote_host, remote_port, init_params_callback](const std::string &remote_ip) mutable {
+        ConnectAddress<T>(config, channel, remote_host, remote_ip, remote_port, init_params_callback);
+      });
+      return true;
+    }
+
+  private:
+    //未设置域名解析服务时使用的默认解析服务(单线程调用getaddrinfo且不缓存, 进程退出前不释放)
+    static DnsResolver *DefaultDnsResolver() {
+      static DnsResolver *dns_resolver = []() {
+        DnsResolver *resolver = new DnsResolver(1);
+        resolver->SetCacheTtl(0, 0);
+        return resolver;
+      }();
+      return dns_resolver;
+    }
+
+    //连接已解析的地址并创建连接对象(解析或连接失败时由连接对象报告错误后退出)
+    template<typename T>
+    static void ConnectAddress(BootstrapConfig &config, SocketChannel &channel, const std::string &remote_host,
+      const std::string &remote_ip, int remote_port, std::function<void(T&)> init_params_callback) {
+      std::string connect_error;
+      if (remote_ip.empty()) {
+        connect_error = "resolve host[" + remote_host + "] failed";
+      } else if (!channel.Connect(remote_host, remote_ip, remote_port, config.GetSocketOptions())) {
+        connect_error = "connect host[" + remote_host + ":" + std::to_string(remote_port) + "] failed";
       }
-			
-      T *client = new T(channel, config_);
+
+      T *client = new T(channel, config);
 			if (init_params_callback != NULL) {
 				init_params_callback(*client);
 			}
+      if (!connect_error.empty()) {
+        client->SetConnectError(connect_error);
+        client->Signal(ExecuteEvent::KILL_EVENT);
+        return;
+      }
       client->Signal(ExecuteEvent::INIT_EVENT);
-      return true;
     }
 
   protected:
     BootstrapConfig &config_;
+    DnsResolver *dns_resolver_; /***域名解析服务(为NULL时使用默认解析服务)***/
 #ifdef ENABLE_OPENSSL
     SSLContext *server_ssl_context_;
 		SSLContext *client_ssl_context_;
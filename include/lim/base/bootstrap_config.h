@@ -6,9 +6,9 @@
 namespace lim {
   enum class LoggerLevel { LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR };
   /**
-  * ־ص
-  * @param [in] LoggerLevel ־ȼ
-  * @param [in] string ־
+  * 日志回调函数申明
+  * @param [in] LoggerLevel 日志等级
+  * @param [in] string 日志内容
   */
   typedef std::function<void(LoggerLevel, const std::string&)> LoggerCallback;
   
@@ -17,7 +17,10 @@ namespace lim {
     BootstrapConfig(EventLoopGroup &event_loop_group, ExecuteThreadGroup &execute_thread_group):
       event_loop_group_(event_loop_group), execute_thread_group_(execute_thread_group),
       server_event_loop_(event_loop_group.Next()), server_execute_thread_(execute_thread_group.Next()),
-      max_buffer_size_(1024*1024*4), logger_callback_(NULL), timeout_millisec_(60*1000) {
+      max_buffer_size_(1024*1024*4), logger_callback_(NULL), timeout_millisec_(60*1000),
+      is_run_to_completion_(false), is_pin_execute_thread_(false),
+      write_low_watermark_(0), write_high_watermark_(-1),
+      max_write_memory_(-1), write_memory_(0), zero_copy_threshold_(-1), connect_timeout_millisec_(10 * 1000) {
     }
 
     BootstrapConfig(EventLoopGroup &event_loop_group,
@@ -26,47 +29,141 @@ namespace lim {
                   ExecuteThread &server_execute_thread) :
       event_loop_group_(event_loop_group), execute_thread_group_(execute_thread_group),
       server_event_loop_(server_event_loop), server_execute_thread_(server_execute_thread),
-      max_buffer_size_(1024 * 1024 * 4), logger_callback_(NULL), timeout_millisec_(60 * 1000) {
+      max_buffer_size_(1024 * 1024 * 4), logger_callback_(NULL), timeout_millisec_(60 * 1000),
+      is_run_to_completion_(false), is_pin_execute_thread_(false),
+      write_low_watermark_(0), write_high_watermark_(-1),
+      max_write_memory_(-1), write_memory_(0), zero_copy_threshold_(-1), connect_timeout_millisec_(10 * 1000) {
 
     }
 
     virtual ~BootstrapConfig() = default;
 
-    //ȡһõ¼(connect/accept)
+    //获取一个可用的事件监听器(用于connect/accept对象)
     EventLoop &NextEventLoop() { return event_loop_group_.Next(); }
-    //ȡһõĹ߳(connect/accept)
+    //获取一个可用的工作线程(用于connect/accept对象)
     ExecuteThread &NextExecuteThread() { return execute_thread_group_.Next(); }
+    //获取一个可用的事件监听器下标(用于connect/accept对象, 当前线程指定了本地事件监听器时直接使用)
+    int NextEventLoopIndex() {
+      int event_loop_index = LocalEventLoopIndex();
+      return (event_loop_index >= 0 ? event_loop_index : event_loop_group_.NextIndex());
+    }
+    //获取事件监听器数
+    int EventLoopNum() { return event_loop_group_.Size(); }
+    //设置当前线程新建连接使用的事件监听器下标(-1为按选择策略获取), SO_REUSEPORT监听器借此将连接留在接收它的事件监听器
+    static void SetLocalEventLoopIndex(int event_loop_index) { LocalEventLoopIndex() = event_loop_index; }
+    //获取指定下标的事件监听器
+    EventLoop &GetEventLoop(int event_loop_index) { return event_loop_group_.Get(event_loop_index); }
+    //获取与事件监听器配对的工作线程(启用绑定时取相同下标, 否则按选择策略获取)
+    ExecuteThread &PairedExecuteThread(int event_loop_index) {
+      return is_pin_execute_thread_ ? execute_thread_group_.Get(event_loop_index) : execute_thread_group_.Next();
+    }
 
-    //ȡ¼(listen)
+    //获取事件监听器(用于listen对象)
     EventLoop &ServerEventLoop() { return server_event_loop_; }
-    //ȡ߳(listen)
+    //获取工作线程(用于listen对象)
     ExecuteThread &ServerExecuteThread() { return server_execute_thread_; }
 
-    //־ص
+    //设置日志回调函数
     void SetLoggerCallback(LoggerCallback callback) { logger_callback_ = callback; }
-    //ȡ־ص
+    //获取日志回调函数
     LoggerCallback GetLoggerCallback() { return logger_callback_; }
 
-    //ջС
+    //设置最大接收缓存大小
     void SetMaxBufferSize(int max_buffer_size) { max_buffer_size_ = max_buffer_size; }
-    //ȡջС
+    //获取最大接收缓存大小
     int GetMaxBufferSize() { return max_buffer_size_; }
 
-    //óʱʱ()
+    //设置超时时间(毫秒)
     void SetTimeout(int timeout_millisec) { timeout_millisec_ = timeout_millisec; }
-    //ȡʱʱ()
+    //获取超时时间(毫秒)
     int GetTimeout() { return timeout_millisec_; }
 
+    //设置连接超时时间(毫秒, -1为不启用), 非阻塞连接超时未完成时关闭连接
+    void SetConnectTimeout(int connect_timeout_millisec) { connect_timeout_millisec_ = connect_timeout_millisec; }
+    //获取连接超时时间(毫秒)
+    int GetConnectTimeout() { return connect_timeout_millisec_; }
+
+    //设置run-to-completion模式: 连接的读写事件直接在所属事件监听器的IO线程中处理(处理函数不能阻塞)
+    void SetRunToCompletion(bool is_run_to_completion) { is_run_to_completion_ = is_run_to_completion; }
+    //是否为run-to-completion模式
+    bool IsRunToCompletion() { return is_run_to_completion_; }
+
+    //设置连接的工作线程与事件监听器配对(使用相同下标, 可绑定到同一CPU核心)
+    void SetPinExecuteThread(bool is_pin_execute_thread) { is_pin_execute_thread_ = is_pin_execute_thread; }
+    //工作线程是否与事件监听器配对
+    bool IsPinExecuteThread() { return is_pin_execute_thread_; }
+
+    /**
+    *设置发送队列的高低水位(字节, 默认不启用, 与未设置水位时的行为一致)
+    * @param low_watermark 低水位, 未发送数据降到低水位以下时恢复可写并继续读取
+    * @param high_watermark 高水位, 未发送数据超过高水位时不可写并暂停读取(<=0为不启用)
+    */
+    void SetWriteWatermark(int low_watermark, int high_watermark) {
+      write_low_watermark_ = low_watermark;
+      write_high_watermark_ = high_watermark;
+    }
+    //获取发送队列低水位(字节)
+    int GetWriteLowWatermark() { return write_low_watermark_; }
+    //获取发送队列高水位(字节)
+    int GetWriteHighWatermark() { return write_high_watermark_; }
+
+    //设置所有连接发送队列的内存上限(字节, -1为不限制), 超过时拒绝发送并关闭连接
+    void SetMaxWriteMemory(int64_t max_write_memory) { max_write_memory_ = max_write_memory; }
+    //获取所有连接发送队列的内存上限(字节)
+    int64_t GetMaxWriteMemory() { return max_write_memory_; }
+    //获取所有连接发送队列占用的内存(字节)
+    int64_t GetWriteMemory() { return write_memory_.load(std::memory_order_relaxed); }
+    /**
+    *申请发送队列内存(所有连接共享)
+    * @param size 字节数
+    * @return 超过内存上限返回false, 成功返回true
+    */
+    bool AcquireWriteMemory(int64_t size) {
+      int64_t write_memory = write_memory_.fetch_add(size, std::memory_order_relaxed) + size;
+      if (max_write_memory_ >= 0 && write_memory > max_write_memory_) {
+        write_memory_.fetch_sub(size, std::memory_order_relaxed);
+        return false;
+      }
+      return true;
+    }
+    //释放发送队列内存
+    void ReleaseWriteMemory(int64_t size) { write_memory_.fetch_sub(size, std::memory_order_relaxed); }
+
+    //设置零拷贝发送阈值(字节): 一次发送的数据达到阈值时使用MSG_ZEROCOPY(仅epoll后端的非SSL连接), -1为不启用
+    void SetZeroCopyThreshold(int zero_copy_threshold) { zero_copy_threshold_ = zero_copy_threshold; }
+    //获取零拷贝发送阈值(字节)
+    int GetZeroCopyThreshold() { return zero_copy_threshold_; }
+
+    //设置socket选项(应用于监听、accept及connect得到的socket)
+    void SetSocketOptions(const SocketOptions &socket_options) { socket_options_ = socket_options; }
+    //获取socket选项
+    const SocketOptions &GetSocketOptions() { return socket_options_; }
+
+  private:
+    static int &LocalEventLoopIndex() {
+      static thread_local int event_loop_index = -1;
+      return event_loop_index;
+    }
+
 	protected:
-    int max_buffer_size_; /***ջС***/
-    int timeout_millisec_; /***ʱʱ(),-1Ϊóʱ***/
-    LoggerCallback logger_callback_; /***־ص***/
+    int max_buffer_size_; /***最大接收缓存大小***/
+    int timeout_millisec_; /***超时时间(毫秒),-1为不启用超时***/
+    bool is_run_to_completion_; /***是否在IO线程中直接处理连接事件***/
+    bool is_pin_execute_thread_; /***工作线程是否与事件监听器配对***/
+    int write_low_watermark_; /***发送队列低水位(字节)***/
+    int write_high_watermark_; /***发送队列高水位(字节),<=0为不启用(默认)***/
+    int64_t max_write_memory_; /***所有连接发送队列的内存上限(字节),-1为不限制***/
+    std::atomic<int64_t> write_memory_; /***所有连接发送队列占用的内存(字节)***/
+    int zero_copy_threshold_; /***零拷贝发送阈值(字节),-1为不启用***/
+    SocketOptions socket_options_; /***socket选项***/
+    int connect_timeout_millisec_; /***连接超时时间(毫秒),-1为不启用***/
+    LoggerCallback logger_callback_; /***日志回调函数***/
 		
-    EventLoopGroup &event_loop_group_; /***¼(connect/accept)***/
-    ExecuteThreadGroup &execute_thread_group_; /***̳߳(connect/accept)***/
+    EventLoopGroup &event_loop_group_; /***事件监听器数组(用于connect/accept对象)***/
+    ExecuteThreadGroup &execute_thread_group_; /***工作线程池(用于connect/accept对象)***/
 		
-    EventLoop &server_event_loop_; /***¼(listen)***/
-    ExecuteThread &server_execute_thread_; /***߳(listen)***/  
+    EventLoop &server_event_loop_; /***事件监听器(用于listen对象)***/
+    ExecuteThread &server_execute_thread_; /***工作线程(用于listen对象)***/  
   };
 }
 #endif
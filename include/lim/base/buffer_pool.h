@@ -0,0 +1,28 @@
+#ifndef LIM_BUFFER_POOL_H
+#define LIM_BUFFER_POOL_H
+#include <stddef.h>
+
+namespace lim {
+	#define BUFFER_POOL_MIN_SHIFT 8 /***最小级别256B***/
+	#define BUFFER_POOL_MAX_SHIFT 20 /***最大级别1MB, 超过时直接向系统申请***/
+	#define BUFFER_POOL_CLASS_NUM (BUFFER_POOL_MAX_SHIFT - BUFFER_POOL_MIN_SHIFT + 1)
+
+	//线程本地的分级内存池(按2的幂分级, 每个线程缓存释放的内存块, 命中线程缓存时无锁; 缓存满时放入各级别的共享溢出链表, 缓存空时从中批量取回)
+	class BufferPool {
+	public:
+		/**
+		*申请内存
+		* @param size 需要的大小
+		* @param allocate_size 返回实际可用的大小(级别大小)
+		* @return 内存地址
+		*/
+		static void *Allocate(int size, int &allocate_size);
+		/**
+		*释放内存(放入当前线程的缓存, 缓存已满时放入共享溢出链表, 均已满时归还系统)
+		* @param memory 内存地址
+		* @param allocate_size 申请时返回的实际大小
+		*/
+		static void Free(void *memory, int allocate_size);
+	};
+}
+#endif
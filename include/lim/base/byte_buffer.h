@@ -4,7 +4,8 @@
 #include <atomic>
 
 namespace lim {
-  //üֽڻ(̰߳ȫ)
+  struct ByteBufferBlock;
+  //带引用计数的字节缓冲区(非线程安全, 控制块与数据区从线程本地内存池申请, 已读空间写入时复用, 数据区可被切片共享)
   class ByteBuffer {
   public:
     ByteBuffer(int max_buffer_size = -1);
@@ -14,34 +15,64 @@ namespace lim {
     virtual ~ByteBuffer();
 
   public:
-    //ջ
+    //清空缓冲区
     void Clear();
-    //ȡС
+    //获取缓冲区大小
     int Capacity();
-    //ַл
+    //字符序列化缓冲区内容
     std::string ToString();
 
-    //ȡɶֽ
+    //获取缓冲区可读字节数
     int ReadableBytes();
-    //ȡдֽ
+    //获取缓冲区可写字节数
     int WritableBytes();
 
-    //skipָɶֽ
+    //skip指定可读字节数
     int SkipBytes(int size);
     /**
-    *ȡָСֽ
-    * @param bytes 
-    * @param size С
-    * @return ʵʶֽ
+    *读取指定大小字节数
+    * @param bytes 读缓冲区
+    * @param size 读缓冲区大小
+    * @return 返回实际读出的字节数
     */
     int ReadBytes(char *bytes, int size);
     /**
-    *ȡָСֽ
-    * @param other 
-    * @param size С,-1ʾ
-    * @return ʵʶֽ
+    *读取指定大小字节数(不移动读偏移)
+    * @param bytes 读缓冲区
+    * @param size 读缓冲区大小
+    * @return 返回实际读出的字节数
+    */
+    int PeekBytes(char *bytes, int size);
+    /**
+    *读取指定大小字节数
+    * @param other 读缓冲区
+    * @param size 读缓冲区大小,-1表示读所有数据
+    * @return 返回实际读出的字节数
     */
     int ReadBytes(ByteBuffer &other, int size = -1);
+    /**
+    *读取指定大小字节数为切片(与当前缓冲区共享数据区, 不拷贝数据)
+    * @param size 切片大小,-1表示读所有数据
+    * @return 返回切片缓冲区(可继续写入, 写入时重新申请数据区)
+    */
+    ByteBuffer ReadSlice(int size = -1);
+    /**
+    *读取指定大小字节数为共享切片(小数据也不拷贝, 切片释放前这部分数据区不会被覆盖, 用于零拷贝发送)
+    * @param size 切片大小,-1表示读所有数据
+    * @return 返回切片缓冲区
+    */
+    ByteBuffer ReadSharedSlice(int size = -1);
+    //获取可读数据的起始地址(下一次写入或读取前有效)
+    char *ReadableData();
+    /**
+    *预留连续的可写空间(直接写入数据区后调用CommitWrite提交)
+    * @param size 最少需要的连续可写字节数
+    * @param writable_size 返回实际连续可写的字节数
+    * @return 返回可写地址, 超出最大缓存区大小返回NULL
+    */
+    char *ReserveWritable(int size, int &writable_size);
+    //提交直接写入预留空间的字节数
+    void CommitWrite(int size);
 		
     uint8_t ReadUInt8();
     void WriteUInt8(uint8_t value);
@@ -56,60 +87,65 @@ namespace lim {
     void WriteUInt64(uint64_t value);
 		
     /**
-    *дָСֽ
-    * @param bytes д
-    * @param size дС
-    * @return ʵдֽ
+    *写指定大小字节数
+    * @param bytes 写缓冲区
+    * @param size 写缓冲区大小
+    * @return 返回实际写入的字节数
     */
     int WriteBytes(const char *bytes, int size);
     /**
-    *дָСֽ
-    * @param other д
-    * @param size дС,-1ʾд
-    * @return ʵдֽ
+    *写指定大小字节数
+    * @param other 写缓冲区
+    * @param size 写缓冲区大小,-1表示写所有数据
+    * @return 返回实际写入的字节数
     */
     int WriteBytes(ByteBuffer &other, int size = -1);
     /**
-    *ָλдָСֽ
-    * @param bytes д
-    * @param bytes д
-    * @param size дС
-    * @return ɹtrue,ʧfalse
+    *从指定位置写入指定大小字节数
+    * @param bytes 写缓冲区
+    * @param bytes 写缓冲区
+    * @param size 写缓冲区大小
+    * @return 成功true,失败false
     */
     bool InsertWriteBytes(int position, const char *bytes, int size);
 
     /**
-    *ȡһ
-    * @param line ص
-    * @param delim ַָ
-    * @return ɹtrue,ʧfalse
+    *获取一行数据
+    * @param line 返回的行数据
+    * @param delim 分割字符串
+    * @return 成功true,失败false
     */
     bool GetLine(std::string &line, const std::string &delim);
 		
   private:
+    ByteBuffer(ByteBufferBlock *block);
+
     /**
-    *ֽڴ
-    * @param size Ҫȡֽsize <= sizeof(uint64_t)
-    * @return ֽڴ
+    *读网络字节次序数据
+    * @param size 需要读取的字节数，size <= sizeof(uint64_t)
+    * @return 返回网络字节次序数据
     */
     uint64_t ReadValue(int size);
     /**
-    *дֽڴ
-    * @param value Ҫдֵ
-    * @param size valueֵĴСsize <= sizeof(uint64_t)
+    *写网络字节次序数据
+    * @param value 需要写的字值
+    * @param size value值的大小，size <= sizeof(uint64_t)
     */
     void WriteValue(uint64_t value, int size);
 
-    //뻺
+    //申请缓存区
     bool AllocateMemory(int memory_size);
+    /**
+    *保证数据区尾部有指定大小的可写空间(优先前移未读数据复用已读空间, 不足或数据区被切片共享时重新申请)
+    * @param size 需要写入的字节数
+    * @return 成功true,失败false
+    */
+    bool EnsureWritable(int size);
+    //数据读完时重置读写偏移, 数据区过大或被切片共享时改用初始数据区
+    void ReclaimMemory();
 		
   private:
-    char *buffer_; /******/
-    int *buffer_read_index_; /***ƫָ***/
-    int *buffer_write_index_; /***дƫָ***/
-    int *buffer_size_; /***ǰСָ***/
-    int *max_buffer_size_; /***󻺴Сָ***/
-    std::atomic<int> *reference_count_; /***üָ***/
+    ByteBufferBlock *block_; /***共享的控制块(包含读写偏移、引用计数及数据区)***/
   };
 }
 #endif
@@ -0,0 +1,76 @@
+#ifndef LIM_COMPOSITE_BYTE_BUFFER_H
+#define LIM_COMPOSITE_BYTE_BUFFER_H
+#include <vector>
+#include <lim/base/byte_buffer.h>
+
+namespace lim {
+  //组合字节缓冲区(按顺序串联多个ByteBuffer组件, 不拼接数据, 发送时按组件分散/聚集写, 非线程安全)
+  class CompositeByteBuffer {
+  public:
+    CompositeByteBuffer();
+    virtual ~CompositeByteBuffer() = default;
+
+  public:
+    //清空缓冲区
+    void Clear();
+    //字符序列化缓冲区内容
+    std::string ToString();
+    //交换两个缓冲区的内容(转移数据所有权, 不复制组件)
+    void Swap(CompositeByteBuffer &other);
+
+    //获取缓冲区可读字节数
+    int ReadableBytes();
+    //获取组件个数
+    int ComponentNum() { return (int)components_.size() - first_component_; }
+    //获取指定组件
+    ByteBuffer &Component(int index) { return components_[first_component_ + index]; }
+
+    /**
+    *追加缓冲区的全部可读数据(以切片共享数据区, 小数据拷贝合并到末尾组件)
+    * @param buffer 追加的缓冲区(数据被消费)
+    * @return 返回追加的字节数
+    */
+    int AddComponent(ByteBuffer &buffer);
+    /**
+    *追加组合缓冲区的全部组件
+    * @param other 追加的组合缓冲区(数据被消费)
+    * @return 返回追加的字节数
+    */
+    int AddComponents(CompositeByteBuffer &other);
+    /**
+    *写指定大小字节数(写入末尾由组合缓冲区自己创建的组件)
+    * @param bytes 写缓冲区
+    * @param size 写缓冲区大小
+    * @return 返回实际写入的字节数
+    */
+    int WriteBytes(const char *bytes, int size);
+
+    //skip指定可读字节数(读完的组件被移除)
+    int SkipBytes(int size);
+    /**
+    *读取指定大小字节数
+    * @param bytes 读缓冲区
+    * @param size 读缓冲区大小
+    * @return 返回实际读出的字节数
+    */
+    int ReadBytes(char *bytes, int size);
+    /**
+    *读取指定大小字节数为共享切片追加到other(不拷贝也不合并, 切片释放前数据区不会被覆盖, 用于零拷贝发送)
+    * @param other 目标组合缓冲区
+    * @param size 读取的字节数
+    * @return 返回实际读出的字节数
+    */
+    int ReadSharedSlices(CompositeByteBuffer &other, int size);
+
+  private:
+    //移除已读完的首个组件
+    void PopComponent();
+
+  private:
+    std::vector<ByteBuffer> components_; /***组件列表***/
+    int first_component_; /***首个未读完组件的下标***/
+    int readable_bytes_; /***所有组件的可读字节数***/
+    bool is_tail_writable_; /***末尾组件是否由组合缓冲区创建(可直接追加写入)***/
+  };
+}
+#endif
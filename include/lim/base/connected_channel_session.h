@@ -2,6 +2,8 @@
 #define LIM_CONNECTED_CHANNEL_SESSION_H
 #include <lim/config.h>
 #include <lim/base/socket_channel.h>
+#include <deque>
+#include <vector>
 #include <lim/base/execute_task.h>
 #include <lim/base/event_loop.h>
 #include <lim/base/byte_buffer.h>
@@ -10,13 +12,21 @@
 
 namespace lim {
 	using WriteCompleteCallback = std::function<void()>;
-	using WriteUnit = std::tuple<ByteBuffer, WriteCompleteCallback>;
+	using WriteUnit = std::tuple<CompositeByteBuffer, WriteCompleteCallback, FileRegion*>;
+	//等待完成通知的零拷贝发送(完成后的下一个发送序号, 内核引用的数据, 完成后执行的回调)
+	using ZeroCopyUnit = std::tuple<uint32_t, CompositeByteBuffer, std::vector<WriteCompleteCallback>>;
 	class ChannelClosedError : public MessageError {
 	public:
 		ChannelClosedError(const std::string &error_message): MessageError(error_message) {
 		};
 		virtual ~ChannelClosedError() = default;
 	};
+	class ConnectError : public MessageError {
+	public:
+		ConnectError(const std::string &error_message): MessageError(error_message) {
+		};
+		virtual ~ConnectError() = default;
+	};
 	class ReadBufferOverflowError : public MessageError {
 	public:
 		ReadBufferOverflowError(const std::string &error_message): MessageError(error_message) {
@@ -35,60 +45,150 @@ namespace lim {
 	public:
 		ConnectedChannelSession(SocketChannel &channel, BootstrapConfig &config);
 		virtual ~ConnectedChannelSession();
-		
+
+	private:
+		//event_loop_index为选中的事件监听器下标(先选事件监听器, 再选配对的工作线程)
+		ConnectedChannelSession(SocketChannel &channel, BootstrapConfig &config, int event_loop_index);
+
+	public:		
 		/**
-		*첽
-		* @param buffer ͻ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*异步发送数据
+		* @param buffer 发送缓冲区
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteData(ByteBuffer &buffer, WriteCompleteCallback callback = NULL);
 		/**
-		*첽Ϣ
-		* @param message Ϣ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*异步发送组合缓冲区数据(各组件不拼接, 按组件聚集写)
+		* @param buffer 发送缓冲区
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
+		*/
+		bool WriteData(CompositeByteBuffer &buffer, WriteCompleteCallback callback = NULL);
+		/**
+		*异步发送消息报文
+		* @param message 消息报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteMessage(Message &message, WriteCompleteCallback callback = NULL);
+		/**
+		*异步发送文件区域(普通连接由sendfile在内核中直接发送, SSL连接分块读取后加密发送)
+		* @param region 文件区域(由会话接管, 发送结束后释放)
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
+		*/
+		bool WriteFile(FileRegion *region, WriteCompleteCallback callback = NULL);
+		/**
+		*异步发送消息报文及其后的文件区域(如http响应头及文件内容)
+		* @param message 消息报文
+		* @param region 文件区域(由会话接管, 发送结束后释放)
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
+		*/
+		bool WriteFile(Message &message, FileRegion *region, WriteCompleteCallback callback = NULL);
+		//发送队列是否可写(未发送数据超过高水位后不可写, 降到低水位以下恢复)
+		bool IsWritable();
+		/**
+		*设置建立连接前的错误(域名解析或发起连接失败时由Bootstrap设置, 随后的KILL_EVENT中以ConnectError报告)
+		* @param error_message 错误信息
+		*/
+		void SetConnectError(const std::string &error_message);
 		
 	protected:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder() = 0;
-		//ıĴ
+		//解码后的报文处理函数
 		virtual bool HandleMessage(Message &message) = 0;
 
-		//ʼ¼
+		//初始化事件处理函数
 		virtual bool HandleInitEvent();
-		//¼
+		//读事件处理函数
 		virtual bool HandleReadEvent();
-		//д¼
+		//写事件处理函数
 		virtual bool HandleWriteEvent();
-		//Ϣ
+		//错误信息处理函数
 		virtual void HandleMessageError(MessageError &error);
+		/**
+		*可写状态变化处理函数(不可写时可在调用WriteData的线程中执行, 恢复可写时在工作线程中执行)
+		* @param is_writable 发送队列是否可写
+		*/
+		virtual void HandleWritabilityChanged(bool is_writable);
 #ifdef ENABLE_OPENSSL
-		//SSLֳɹ
+		//SSL握手成功处理函数
 		virtual bool HandleSSLHandshaked();
 #endif	
 
+	private:
+		/**
+		*加入发送队列(队列为空时先在调用线程直接发送, 内核发送缓冲区满时才监听写事件)
+		* @param buffer 发送缓冲区
+		* @param region 缓冲区之后发送的文件区域(可为NULL, 由会话接管)
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
+		*/
+		bool PushWriteUnit(CompositeByteBuffer &buffer, FileRegion *region, WriteCompleteCallback callback);
+		/**
+		*首次注册到事件监听器(fd超出可注册范围等失败时记录日志, 返回false使会话退出)
+		* @param has_write_op 是否监听写事件
+		* @return 失败返回false, 成功返回true
+		*/
+		bool AddToEventLoop(bool has_write_op);
+		//Kill事件处理函数(存在建立连接前的错误时先通过HandleMessageError报告)
+		virtual bool HandleKillEvent();
+		/**
+		*发送缓冲区(启用零拷贝且数据量达到阈值时以MSG_ZEROCOPY发送)
+		* @param buffers 发送缓冲区数组
+		* @param buffer_num 缓冲区个数
+		* @param zero_copy_buffer 追加零拷贝发送的数据(收到完成通知前保持有效)
+		* @param zero_copy_num 返回零拷贝发送次数
+		* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+		*/
+		int WriteBuffers(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer &zero_copy_buffer, int &zero_copy_num);
+#ifdef ENABLE_OPENSSL
+		//SSL握手完成后, 发送方向已由内核TLS加密时改用普通发送路径(多个单元聚集写, 文件由sendfile发送)
+		void UpdateSSLWriteMode();
+#endif
+		//记录等待完成通知的零拷贝发送(调用方持有mutex_)
+		void PushZeroCopyUnit(CompositeByteBuffer &zero_copy_buffer, int zero_copy_num);
+		/**
+		*检查非阻塞连接的结果(失败或超时时报告错误)
+		* @return 连接失败返回-1, 连接中返回0, 连接成功返回1
+		*/
+		int CheckConnected();
+
 	protected:
-		SocketChannel channel_; /***socketӶ***/
-		EventLoop &event_loop_; /***¼***/
-		ByteBuffer recv_buffer_; /***ջ***/
+		SocketChannel channel_; /***socket连接对象***/
+		EventLoop &event_loop_; /***事件监听器***/
+		ByteBuffer recv_buffer_; /***接收缓存***/
 		
-		BootstrapConfig &config_; /***(Э)***/
-		MessageDecoder *message_decoder_; /***Ľ(Э)***/
+		BootstrapConfig &config_; /***引导配置(报文协议相关)***/
+		MessageDecoder *message_decoder_; /***报文解码器(报文协议相关)***/
 		
-		int64_t last_read_timestamp_; /***һζʱ()***/
-		int64_t last_write_timestamp_; /***һдʱ()***/
-		ExecuteTimer *timeout_timer_; /***дʱʱ(ʱ˳)***/
+		std::atomic<int64_t> last_read_timestamp_; /***最近一次读时间戳(毫秒,超时回调可能在其它线程读取)***/
+		std::atomic<int64_t> last_write_timestamp_; /***最近一次写时间戳(毫秒)***/
+		ExecuteTimer *timeout_timer_; /***读写超时计时器(超时退出)***/
+		ExecuteTimer *connect_timer_; /***连接超时计时器***/
+		std::atomic<bool> is_connect_timeout_; /***非阻塞连接是否已超时***/
+		std::string connect_error_; /***建立连接前的错误(域名解析或发起连接失败)***/
 
 #ifdef ENABLE_OPENSSL
 		int read_waiton_flag_;
 		int write_waiton_flag_;
+		bool is_ssl_write_; /***是否由SSL_write在用户态加密发送(启用内核TLS后为false)***/
 #endif
 		
 		std::mutex mutex_;
 		std::deque<WriteUnit> write_unit_que_;
+		int64_t write_queue_bytes_; /***发送队列中未发送的字节数***/
+		bool is_writable_; /***发送队列是否可写***/
+		bool is_connecting_; /***是否正在进行非阻塞连接(连接完成前数据只加入发送队列)***/
+		bool is_read_paused_; /***是否因发送队列超过高水位暂停读取***/
+
+		bool is_zero_copy_; /***是否启用零拷贝发送***/
+		uint32_t zero_copy_seq_; /***下一次零拷贝发送的序号***/
+		uint32_t zero_copy_complete_seq_; /***下一个未完成的零拷贝发送序号***/
+		std::deque<ZeroCopyUnit> zero_copy_que_; /***等待完成通知的零拷贝发送队列***/
   };
 }
 #endif
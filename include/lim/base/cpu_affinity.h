@@ -0,0 +1,33 @@
+#ifndef LIM_CPU_AFFINITY_H
+#define LIM_CPU_AFFINITY_H
+#include <vector>
+
+namespace lim {
+  //CPU分配方式
+  enum class CpuPlacement {
+    COMPACT, /***按NUMA节点依次分配(先占满一个节点)***/
+    SCATTER  /***在NUMA节点间交错分配***/
+  };
+
+  //获取CPU核数
+  int GetCpuNum();
+  //获取在线的NUMA节点编号列表(编号可能不连续; 不支持NUMA时返回[0])
+  std::vector<int> GetNumaNodes();
+  //获取NUMA节点数(不支持NUMA时返回1)
+  int GetNumaNodeNum();
+  //获取NUMA节点上的CPU列表
+  std::vector<int> GetNumaNodeCpus(int numa_node);
+  /**
+  *按分配方式生成CPU列表(作为线程组的cpu_list参数,第i个线程绑定到第i%size个CPU)
+  * @param placement 分配方式
+  * @return CPU列表
+  */
+  std::vector<int> GetPlacementCpus(CpuPlacement placement);
+  /**
+  *将当前线程绑定到指定CPU
+  * @param cpu CPU编号
+  * @return 失败返回false, 成功返回true
+  */
+  bool BindCurrentThreadToCpu(int cpu);
+}
+#endif
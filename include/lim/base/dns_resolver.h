@@ -0,0 +1,118 @@
+#ifndef LIM_DNS_RESOLVER_H
+#define LIM_DNS_RESOLVER_H
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+namespace lim {
+	#define DNS_RESOLVER_SHARD_NUM 16 /***缓存分片数***/
+
+	/**
+	*域名解析回调函数申明(在解析线程中执行, 缓存命中时在调用线程中执行)
+	* @param [in] string 解析得到的IPv4地址, 失败时为空
+	*/
+	typedef std::function<void(const std::string&)> ResolveCallback;
+
+	//异步域名解析服务(解析线程池 + 分片TTL缓存, 相同域名的并发请求只解析一次)
+	class DnsResolver {
+	public:
+		/**
+		*域名解析服务构造函数
+		* @param thread_num 解析线程数
+		*/
+		DnsResolver(int thread_num = 2);
+		virtual ~DnsResolver();
+
+	private:
+		DnsResolver(const DnsResolver& other) = delete;
+		DnsResolver &operator=(const DnsResolver& other) = delete;
+
+	public:
+		/**
+		*设置DNS服务器(设置后通过UDP直接查询A记录并使用应答中的TTL, 应答被截断或服务器出错时改用getaddrinfo; 未设置时在解析线程中调用getaddrinfo)
+		* @param server_ip DNS服务器地址
+		* @param server_port DNS服务器端口
+		*/
+		void SetNameServer(const std::string &server_ip, int server_port = 53);
+		/**
+		*设置缓存时间(秒)
+		* @param max_ttl_sec 解析成功的最长缓存时间(应答TTL超过时截断, getaddrinfo解析时直接使用)
+		* @param negative_ttl_sec 域名不存在或没有A记录时的缓存时间(0为不缓存, 超时等临时失败不缓存)
+		*/
+		void SetCacheTtl(int max_ttl_sec, int negative_ttl_sec);
+		/**
+		*设置UDP查询的超时时间及重试次数
+		* @param timeout_millisec 每次查询的超时时间(毫秒)
+		* @param retry_num 超时后的重试次数
+		*/
+		void SetQueryTimeout(int timeout_millisec, int retry_num);
+
+		/**
+		*异步解析域名(IP地址或缓存命中时直接在调用线程中回调)
+		* @param host_name 域名
+		* @param callback 解析完成回调函数
+		*/
+		void Resolve(const std::string &host_name, ResolveCallback callback);
+		/**
+		*查询缓存
+		* @param host_name 域名
+		* @param ip 返回缓存的IPv4地址(缓存的失败结果为空)
+		* @return 缓存未命中或已过期返回false
+		*/
+		bool Lookup(const std::string &host_name, std::string &ip);
+
+	private:
+		//缓存项
+		struct CacheEntry {
+			std::string ip; /***IPv4地址,为空表示解析失败***/
+			int64_t expire_time; /***过期时间(单调时钟,微秒)***/
+		};
+		//缓存分片
+		struct CacheShard {
+			std::mutex mutex;
+			std::unordered_map<std::string, CacheEntry> entries;
+		};
+
+		//解析线程主函数
+		void Run();
+		/**
+		*解析域名(阻塞)
+		* @param host_name 域名
+		* @param ttl_sec 返回缓存时间(秒, 0为不缓存)
+		* @return 失败返回空
+		*/
+		std::string Query(const std::string &host_name, int &ttl_sec);
+		//通过UDP向DNS服务器查询A记录
+		std::string QueryNameServer(const std::string &host_name, int &ttl_sec);
+		//通过getaddrinfo解析
+		std::string QuerySystem(const std::string &host_name, int &ttl_sec);
+		//写入缓存(缓存时间<=0时不缓存)
+		void Store(const std::string &host_name, const std::string &ip, int ttl_sec);
+		CacheShard &GetShard(const std::string &host_name);
+
+	private:
+		std::string server_ip_; /***DNS服务器地址,为空时使用getaddrinfo***/
+		int server_port_; /***DNS服务器端口***/
+		int max_ttl_sec_; /***解析成功的最长缓存时间(秒)***/
+		int negative_ttl_sec_; /***解析失败的缓存时间(秒)***/
+		int timeout_millisec_; /***每次UDP查询的超时时间(毫秒)***/
+		int retry_num_; /***UDP查询超时后的重试次数***/
+
+		CacheShard shards_[DNS_RESOLVER_SHARD_NUM]; /***分片缓存***/
+
+		std::mutex mutex_;
+		std::condition_variable cond_;
+		bool is_running_;
+		std::deque<std::string> query_que_; /***等待解析的域名***/
+		std::map<std::string, std::vector<ResolveCallback>> pending_callbacks_; /***解析中的域名及等待的回调(合并相同请求)***/
+		std::vector<std::thread> threads_; /***解析线程***/
+	};
+}
+#endif
@@ -5,14 +5,38 @@
 #endif
 #include <lim/base/socket_channel.h>
 #include <lim/base/execute_task.h>
+#ifdef ENABLE_IO_URING
+#include <lim/base/io_uring_queue.h>
+#endif
 #include <map>
 #include <mutex>
 #include <thread> 
+#include <atomic>
+#include <condition_variable>
 
 namespace lim {
+	//事件循环后端(io_uring不可用时自动退回epoll)
+	enum class EventLoopBackend { EPOLL, IO_URING };
+#ifndef _WIN32
+	struct UringChannel;
+	//fd索引的channel注册槽(分发路径无锁访问)
+	struct ChannelSlot {
+		std::atomic<ExecuteTask*> execute_task; /***绑定的可执行任务***/
+		std::atomic<uint32_t> generation; /***注册代数(用于过滤fd复用后的旧事件)***/
+		std::atomic<bool> is_dispatching; /***事件循环线程是否正在分发该槽***/
+		std::atomic<UringChannel*> uring_channel; /***io_uring后端的连接状态***/
+		std::atomic<bool> has_write_op; /***当前是否监听写事件***/
+	};
+
+#endif
 	class EventLoop: public ExecuteThread {
 	public:
-		EventLoop();
+		/**
+		*事件监听器构造函数
+		* @param cpu IO线程绑定的CPU(-1表示不绑定)
+		* @param backend 事件循环后端
+		*/
+		EventLoop(int cpu = -1, EventLoopBackend backend = EventLoopBackend::EPOLL);
 		virtual ~EventLoop();
 		
 	private:
@@ -20,31 +44,148 @@ namespace lim {
 		EventLoop &operator=(const EventLoop& other) = delete;
 
 	public:
-		void AddChannel(const SocketChannel &channel, ExecuteTask *execute_task, bool has_write_op=false);
+		/**
+		*注册连接(已注册时只更新写事件监听)
+		* @param channel 连接
+		* @param execute_task 绑定的可执行任务
+		* @param has_write_op 是否监听写事件
+		* @return fd超出可注册范围或注册失败返回false, 成功返回true
+		*/
+		bool AddChannel(const SocketChannel &channel, ExecuteTask *execute_task, bool has_write_op=false);
 		void RemoveChannel(const SocketChannel &channel);
+		/**
+		*更新已注册连接的写事件监听(监听状态不变时不修改注册, 同一连接的调用由调用方串行化)
+		* @param channel 已注册的连接
+		* @param has_write_op 是否监听写事件
+		*/
+		void UpdateChannel(const SocketChannel &channel, bool has_write_op);
+		//唤醒阻塞在epoll_wait上的事件循环线程(跨线程通知)
+		void Wakeup();
+		//获取注册的连接数
+		int GetChannelNum() { return channel_num_.load(std::memory_order_relaxed); }
+		//获取实际使用的事件循环后端
+		EventLoopBackend GetBackend() { return backend_; }
+
+		/**
+		*读取连接数据(io_uring后端从已完成的接收数据中读取, epoll后端直接读socket)
+		* @param channel 已注册的连接
+		* @param buffer 接收缓冲区
+		* @return 连接关闭或出错返回-1, 否则返回读取的字节数
+		*/
+		int ReadBytes(SocketChannel &channel, ByteBuffer &buffer);
+		/**
+		*发送连接数据(io_uring后端提交异步发送, 上一次发送完成前返回0, 完成后触发写事件)
+		* @param channel 已注册的连接
+		* @param buffer 发送缓冲区(epoll后端按组件聚集写)
+		* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+		*/
+		int WriteBytes(SocketChannel &channel, CompositeByteBuffer &buffer);
+		/**
+		*按顺序发送多个缓冲区的数据(epoll后端一次系统调用聚集写, io_uring后端合并提交)
+		* @param channel 已注册的连接
+		* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+		* @param buffer_num 缓冲区个数
+		* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+		*/
+		int WriteBytes(SocketChannel &channel, CompositeByteBuffer **buffers, int buffer_num);
+		/**
+		*发送文件区域(epoll后端由sendfile直接发送, io_uring后端读取到连接的发送区后提交)
+		* @param channel 已注册的连接
+		* @param region 文件区域, 按发送的字节数消费
+		* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+		*/
+		int64_t WriteFile(SocketChannel &channel, FileRegion &region);
+		//接收新连接(io_uring后端从已完成的accept中获取)
+		void Accept(SocketChannel &channel, std::vector<SocketChannel> &socket_channels);
 		
 	private:
 		void ClearChannels();
 		virtual void Run();
+		//唤醒IO线程(绑定在本事件循环上的任务及定时器由IO线程执行)
+		virtual void Notify();
+		//计算IO线程的等待时间(微秒): 有排队任务或定时器已到期时返回0, 没有定时器时返回-1
+		int64_t GetWaitTime();
+		//执行排队的任务及到期的定时器(IO线程每轮事件分发后调用)
+		void RunPendingTasks();
+#ifndef _WIN32
+		/**
+		*获取fd对应的注册槽
+		* @param fd socket句柄
+		* @param is_create 槽不存在时是否创建
+		* @return 槽不存在且不创建时返回NULL
+		*/
+		ChannelSlot *GetChannelSlot(int fd, bool is_create);
+		//分发事件(channel_handle为generation<<32|fd)
+		void DispatchEvent(uint64_t channel_handle, int execute_events);
+#endif
+#ifdef ENABLE_IO_URING
+		//io_uring事件循环
+		void RunUring();
+		/**
+		*投递命令到事件循环线程(提交队列只由事件循环线程访问)
+		* @return 命令序号
+		*/
+		uint64_t PostUringCommand(int command, UringChannel *uring_channel);
+		void ProcessUringCommands();
+		void HandleUringCompletion(struct io_uring_cqe *cqe);
+		void SubmitUringOp(UringChannel *uring_channel, int op);
+		void SubmitUringCancel(UringChannel *uring_channel, int op);
+		void SubmitUringWakeup();
+		//重新提交因提交队列满而未能提交的操作(完成队列处理后调用)
+		void RetryUringOps();
+		/**
+		*拷贝待发送数据到连接的发送区并提交发送(上一次发送完成前返回0)
+		* @param buffers 发送缓冲区数组(按顺序拷贝)
+		* @param buffer_num 缓冲区个数
+		* @param region 缓冲区之后发送的文件区域(可为NULL)
+		* @return 出错返回-1, 否则返回提交的字节数
+		*/
+		int SubmitUringSend(UringChannel *uring_channel, CompositeByteBuffer **buffers, int buffer_num, FileRegion *region);
+		//标记注销并取消未完成的操作, 返回前已提交给内核(之后可以安全关闭fd)
+		void RemoveUringChannel(UringChannel *uring_channel);
+		//连接已注销且没有未完成的操作时释放
+		void ReleaseUringChannel(UringChannel *uring_channel);
+#endif
 
 	private:
 #ifdef _WIN32
 		fd_set read_channel_set_;
 		fd_set write_channel_set_;
 		int max_socket_channel_;
+		std::mutex mutex_;
+		std::map<int, ExecuteTask*> channel_task_map_;
 #else
 		int fd_epoll_;
+		int fd_wakeup_; /***eventfd唤醒句柄(退出及跨线程通知)***/
+		std::atomic<ChannelSlot*> *channel_slot_chunks_; /***fd索引的注册表(按块延迟分配)***/
 #endif
-		std::mutex mutex_;
-		std::map<int, ExecuteTask*> channel_task_map_;
-
-		bool is_running_;
+#ifdef ENABLE_IO_URING
+		IoUringQueue *io_uring_; /***io_uring队列(仅事件循环线程访问)***/
+		uint64_t wakeup_value_; /***eventfd读缓冲***/
+		std::mutex uring_mutex_;
+		std::vector<std::pair<int, UringChannel*>> uring_commands_; /***待处理的命令***/
+		std::condition_variable uring_cond_;
+		uint64_t uring_post_seq_; /***已投递的命令序号***/
+		uint64_t uring_done_seq_; /***已处理的命令序号***/
+		std::vector<std::pair<UringChannel*, int>> uring_retry_ops_; /***提交队列满时等待重新提交的操作(仅事件循环线程访问)***/
+#endif
+		std::atomic<bool> is_running_;
+		std::atomic<int> channel_num_; /***注册的连接数***/
+		EventLoopBackend backend_; /***事件循环后端***/
 		std::thread io_thread_;
   };
 
 	class EventLoopGroup {
 	public:
-		EventLoopGroup(int event_loop_num = 0);
+		/**
+		*事件监听器组构造函数
+		* @param event_loop_num 事件监听器数(小于等于0时为CPU核数)
+		* @param policy_type 事件监听器选择策略
+		* @param cpu_list 绑定的CPU列表(第i个事件监听器绑定到第i%size个CPU,为空时不绑定)
+		* @param backend 事件循环后端
+		*/
+		EventLoopGroup(int event_loop_num = 0, SelectPolicyType policy_type = SelectPolicyType::ROUND_ROBIN,
+			const std::vector<int> &cpu_list = std::vector<int>(), EventLoopBackend backend = EventLoopBackend::EPOLL);
 		virtual ~EventLoopGroup();
 
 	private:
@@ -52,12 +193,18 @@ namespace lim {
 		EventLoopGroup &operator=(const EventLoopGroup& other) = delete;
 
 	public:
-		EventLoop &Next();
+		//按选择策略获取一个事件监听器
+		EventLoop &Next() { return Get(NextIndex()); }
+		//按选择策略获取一个事件监听器下标
+		int NextIndex();
+		//获取指定下标的事件监听器
+		EventLoop &Get(int index) { return *event_loops_[index % event_loop_num_]; }
+		//获取事件监听器数
+		int Size() { return event_loop_num_; }
 		
 	protected:
-		std::mutex mutex_;
+		SelectPolicy *select_policy_; /***事件监听器选择策略***/
 		int event_loop_num_;
-		int event_loop_index_;
 		EventLoop **event_loops_;
 	};
 }
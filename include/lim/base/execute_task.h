@@ -1,10 +1,14 @@
 #ifndef LIM_EXECUTE_TASK_H
 #define LIM_EXECUTE_TASK_H
-#include <deque>
 #include <vector>
 #include <mutex>
+#include <atomic>
 #include <thread> 
 #include <condition_variable>
+#include <functional>
+#include <tuple>
+#include <lim/base/timer_wheel.h>
+#include <lim/base/select_policy.h>
 
 namespace lim {
 	namespace ExecuteEvent { 
@@ -18,16 +22,16 @@ namespace lim {
 	
 	class ExecuteTask;
 	class ExecuteThread;
+	class ExecuteThreadGroup;
 	class ExecuteTimer;
-	using MaxHeapUnit = std::tuple<int64_t, ExecuteTimer*, bool>; //std::tuple<timestamp, ExecuteTimer, is_in_heap>
 	using TimeoutCallback = std::function<void()>;
-	//ʱ(ײͨʵ)
+	//定时器(底层通过分层时间轮实现,启动/取消均为O(1))
 	class ExecuteTimer {
 	public:
 		/**
-		*ʱ캯
-		* @param execute_thread ʱִ߳
-		* @param callback ʱص
+		*定时器构造函数
+		* @param execute_thread 定时器执行线程
+		* @param callback 定时器回调函数
 		*/
 		ExecuteTimer(ExecuteThread &execute_thread, TimeoutCallback callback);
 		virtual ~ExecuteTimer();
@@ -41,18 +45,26 @@ namespace lim {
 
 	private:
 		TimeoutCallback callback_;
-		MaxHeapUnit timeout_unit_;
+		TimerWheelNode timeout_node_;
 		ExecuteThread &execute_thread_;
 		friend class ExecuteThread;
 	};
 	
-	using DeQueueUnit = std::tuple<ExecuteTask*, bool>; //std::tuple<ExecuteTask, is_in_queue>
-	//ִ,̹߳(󲻴¼ͳʱ,пڴй©)
+	//任务队列节点(侵入式双向循环链表节点,嵌入在任务对象中)
+	struct TaskQueueNode {
+		TaskQueueNode *prev;
+		TaskQueueNode *next;
+		ExecuteTask *execute_task; /***所属任务***/
+	};
+
+	//可执行任务,任务对象的生命周期由宿主线程管理(如果任务对象不触发事件和超时,有可能造成内存泄漏)
+	//工作窃取模式下Run可能在其它线程执行(同一任务的Run不会并发执行),定时器回调仍在宿主线程执行,
+	//回调与Run之间共享的状态需自行同步; 定时器的取消/销毁会等待正在其它线程执行的回调结束
 	class ExecuteTask {
 	public:
 		/**
-		*ִ캯
-		* @param execute_thread ִ߳
+		*可执行任务构造函数
+		* @param execute_thread 执行线程
 		*/
 		ExecuteTask(ExecuteThread &execute_thread);
 		virtual ~ExecuteTask();
@@ -62,26 +74,26 @@ namespace lim {
 		ExecuteTask &operator=(const ExecuteTask& other) = delete;
 
 	public:
-		//¼
+		//事件触发函数
 		void Signal(int execute_events);
-		//ȡ¼Ϣ
+		//获取事件信息
 		int GetEvents();
-		//ȡִ߳
+		//获取执行线程
 		ExecuteThread &GetExecuteThread() { return execute_thread_; }
 
-		//ʼ
+		//初始化
 		virtual bool Initialize();
 
 	private:
-		//Kill¼
+		//Kill事件处理函数
 		virtual bool HandleKillEvent();
-		//ʼ¼
+		//初始化事件处理函数
 		virtual bool HandleInitEvent();
-		//¼
+		//读事件处理函数
 		virtual bool HandleReadEvent();
-		//д¼
+		//写事件处理函数
 		virtual bool HandleWriteEvent();
-		//Զ¼
+		//自定义事件处理函数
 		virtual bool HandleUserEvent(int user_events);
 	
 	protected:
@@ -89,45 +101,103 @@ namespace lim {
 
 	private:
 		std::mutex mutex_;
-		int execute_events_;  /***ǰ¼***/
-		DeQueueUnit deque_unit_; /***¼еԪ***/
-		ExecuteThread &execute_thread_; /***󶨵ִ߳***/
+		int execute_events_;  /***当前触发的事件***/
+		TaskQueueNode queue_node_; /***事件处理队列节点***/
+		std::atomic<int> queue_state_; /***调度状态(空闲/排队/执行中/执行中且有新事件)***/
+		ExecuteThread &execute_thread_; /***绑定的执行线程***/
 		friend class ExecuteThread;
   };
 	
 	class ExecuteThread {
 	public:
-		ExecuteThread();
+		/**
+		*执行线程构造函数
+		* @param thread_group 所属线程池(仅工作窃取模式下设置,空闲时从池中其它线程窃取任务)
+		* @param cpu 绑定的CPU(-1表示不绑定)
+		* @param is_start_thread 是否创建线程执行任务(为false时由派生类的线程驱动任务队列及定时器,如EventLoop的IO线程)
+		*/
+		ExecuteThread(ExecuteThreadGroup *thread_group = NULL, int cpu = -1, bool is_start_thread = true);
 		virtual ~ExecuteThread();
 
 	private:
 		ExecuteThread(const ExecuteThread& other) = delete;
 		ExecuteThread &operator=(const ExecuteThread& other) = delete;
+
+	public:
+		//获取绑定的任务数(连接数)
+		int GetTaskNum() { return task_num_.load(std::memory_order_relaxed); }
+		//获取排队等待执行的任务数
+		int GetQueueDepth() { return queue_depth_.load(std::memory_order_relaxed); }
+		//获取绑定的CPU(-1表示不绑定)
+		int GetCpu() { return cpu_; }
 		
 	protected:
 		virtual void Run();
+		//唤醒阻塞等待的线程(调用方持有mutex_)
+		virtual void Notify();
+		//取走全部待执行任务放入执行列表(调用方持有mutex_)
+		void SpliceTasks();
+		//逐个执行执行列表中的任务
+		void RunTasks();
+		//销毁队列中未执行的任务(线程退出时调用)
+		void DestroyTasks();
 
-		void AddToQueue(DeQueueUnit *deque_unit);
-		void RemoveFromQueue(DeQueueUnit *deque_unit);
+		void AddToQueue(ExecuteTask *execute_task);
+		void RemoveFromQueue(ExecuteTask *execute_task);
+		//任务加入队尾(调用前任务已标记为排队状态)
+		void PushTask(ExecuteTask *execute_task);
+		//执行任务,执行期间有新事件时重新加入宿主线程队列
+		void RunTask(ExecuteTask *execute_task);
+		/**
+		*在调用线程中直接执行任务(run-to-completion),任务已排队或正在执行时只合并事件
+		* @param execute_task 可执行任务
+		* @param execute_events 触发的事件
+		*/
+		void RunInline(ExecuteTask *execute_task, int execute_events);
+		//从本线程队尾窃取一个任务(由窃取线程调用,失败返回NULL)
+		TaskQueueNode *TrySteal();
+		//执行已到期的定时器回调
+		void RunExpiredTimers();
+		//停止并等待线程退出
+		void Stop();
 
-		void AddToMaxHeap(MaxHeapUnit *heap_unit);
-		void RemoveFromMaxHeap(MaxHeapUnit *heap_unit);
+		void AddToTimerWheel(TimerWheelNode *timer_node, int64_t expire_time);
+		void RemoveFromTimerWheel(TimerWheelNode *timer_node);
 
 	protected:
 		bool is_running_;
+		int cpu_; /***绑定的CPU(-1表示不绑定)***/
+		ExecuteThreadGroup *thread_group_; /***所属线程池(工作窃取模式)***/
 		std::thread thread_;
 		std::mutex mutex_;
 		std::condition_variable condvar_;
     
-		std::vector<MaxHeapUnit*> timeout_heap_; /***ʱб()***/
-		std::deque<DeQueueUnit*> task_que_; /***б***/
+		TimerWheel timer_wheel_; /***定时器列表(分层时间轮)***/
+		std::atomic<int64_t> wakeup_time_; /***线程阻塞等待的截止时间(微秒),-1表示未阻塞***/
+		TaskQueueNode task_que_; /***待执行任务列表(链表头)***/
+		TaskQueueNode run_que_; /***当前批次正在执行的任务列表(链表头,持有mutex_访问,只包含本线程的任务)***/
+		std::atomic<int> task_num_; /***绑定的任务数***/
+		std::atomic<int> queue_depth_; /***排队等待执行的任务数***/
+		ExecuteTimer *firing_timer_; /***正在执行回调的定时器***/
+		std::thread::id firing_thread_id_; /***执行定时器回调的线程***/
+		std::condition_variable timer_condvar_; /***等待定时器回调结束***/
 		friend class ExecuteTimer;
 		friend class ExecuteTask;
+		friend class ExecuteThreadGroup;
   };
 
+	//执行线程池,工作窃取模式下空闲线程从繁忙线程的队列中窃取任务执行
 	class ExecuteThreadGroup {
 	public:
-		ExecuteThreadGroup(int execute_thread_num = 0);
+		/**
+		*执行线程池构造函数
+		* @param execute_thread_num 线程数(小于等于0时为CPU核数的2倍)
+		* @param is_work_stealing 是否启用工作窃取
+		* @param policy_type 线程选择策略
+		* @param cpu_list 绑定的CPU列表(第i个线程绑定到第i%size个CPU,为空时不绑定)
+		*/
+		ExecuteThreadGroup(int execute_thread_num = 0, bool is_work_stealing = false,
+			SelectPolicyType policy_type = SelectPolicyType::ROUND_ROBIN, const std::vector<int> &cpu_list = std::vector<int>());
 		virtual ~ExecuteThreadGroup();
 
 	private:
@@ -135,13 +205,28 @@ namespace lim {
 		ExecuteThreadGroup &operator=(const ExecuteThreadGroup& other) = delete;
 
 	public:
-		ExecuteThread &Next();
+		//按选择策略获取一个工作线程
+		ExecuteThread &Next() { return Get(NextIndex()); }
+		//按选择策略获取一个工作线程下标
+		int NextIndex();
+		//获取指定下标的工作线程
+		ExecuteThread &Get(int index) { return *execute_threads_[index % execute_thread_num_]; }
+		//获取线程数
+		int Size() { return execute_thread_num_; }
+
+	private:
+		//为空闲线程窃取一个任务(不链入任何队列,由窃取线程直接执行),失败返回NULL
+		TaskQueueNode *StealTask(ExecuteThread *execute_thread);
+		//任务宿主线程繁忙时唤醒一个空闲线程
+		void WakeupIdleThread(ExecuteThread *execute_thread);
 		
 	protected:
-		std::mutex mutex_;
+		SelectPolicy *select_policy_; /***线程选择策略***/
 		int execute_thread_num_;
-		int execute_thread_index_;
+		std::atomic<bool> is_work_stealing_; /***是否启用工作窃取(所有线程创建完成后才启用)***/
+		std::atomic<unsigned int> steal_index_; /***窃取/唤醒的起始线程下标***/
 		ExecuteThread **execute_threads_;
+		friend class ExecuteThread;
 	};
 }
 #endif
@@ -0,0 +1,66 @@
+#ifndef LIM_FILE_REGION_H
+#define LIM_FILE_REGION_H
+#include <stdint.h>
+#include <string>
+
+namespace lim {
+	//文件区域(发送文件的指定范围, 普通连接由sendfile在内核中直接发送, 不可直接发送时分块读取后发送, 非线程安全)
+	class FileRegion {
+	public:
+		/**
+		*文件区域构造函数
+		* @param file_path 文件路径
+		* @param offset 起始偏移
+		* @param length 长度(-1为到文件末尾, 超出文件大小时截断)
+		*/
+		FileRegion(const std::string &file_path, int64_t offset = 0, int64_t length = -1);
+		virtual ~FileRegion();
+
+	private:
+		FileRegion(const FileRegion &other) = delete;
+		FileRegion &operator=(const FileRegion &other) = delete;
+
+	public:
+		//文件是否打开成功
+		bool IsOpen() { return fd_ != -1; }
+		//获取文件句柄
+		int GetFd() { return fd_; }
+		//获取文件大小
+		int64_t GetFileSize() { return file_size_; }
+		//获取下一个待发送字节的文件偏移
+		int64_t GetPosition() { return position_; }
+		//获取未发送的字节数
+		int64_t ReadableBytes() { return remain_length_; }
+
+		/**
+		*跳过已发送的字节
+		* @param size 字节数
+		* @return 返回跳过的字节数
+		*/
+		int64_t SkipBytes(int64_t size);
+		/**
+		*读取数据(拷贝到data并消费)
+		* @param data 数据区
+		* @param size 数据区大小
+		* @return 出错返回-1, 否则返回读取的字节数
+		*/
+		int ReadBytes(char *data, int size);
+		/**
+		*获取当前待发送的数据块(块为空时从文件读取, 未消费时重复调用返回同一数据区, 满足SSL重试的要求)
+		* @param size 返回数据块大小
+		* @return 出错返回NULL
+		*/
+		char *ReadableChunk(int &size);
+
+	private:
+		int fd_; /***文件句柄***/
+		int64_t file_size_; /***文件大小***/
+		int64_t position_; /***下一个待发送字节的文件偏移***/
+		int64_t remain_length_; /***未发送的字节数***/
+
+		char *chunk_; /***分块发送时的数据区***/
+		int chunk_offset_; /***数据块中已发送的字节数***/
+		int chunk_size_; /***数据块大小***/
+	};
+}
+#endif
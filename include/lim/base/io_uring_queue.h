@@ -0,0 +1,86 @@
+#ifndef LIM_IO_URING_QUEUE_H
+#define LIM_IO_URING_QUEUE_H
+#include <lim/config.h>
+#ifdef ENABLE_IO_URING
+#include <linux/io_uring.h>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace lim {
+	//io_uring提交/完成队列(直接使用系统调用,不依赖liburing,非线程安全,仅由事件循环线程访问)
+	class IoUringQueue {
+	public:
+		IoUringQueue();
+		virtual ~IoUringQueue();
+
+	private:
+		IoUringQueue(const IoUringQueue& other) = delete;
+		IoUringQueue &operator=(const IoUringQueue& other) = delete;
+
+	public:
+		/**
+		*创建io_uring实例
+		* @param entries 提交队列长度
+		* @return 内核不支持时返回false
+		*/
+		bool Initialize(unsigned int entries);
+		/**
+		*注册接收缓冲区环(内核在接收完成时从中选择缓冲区)
+		* @param group_id 缓冲区组id
+		* @param buffer_num 缓冲区个数(2的幂)
+		* @param buffer_size 单个缓冲区大小
+		* @return 内核不支持时返回false
+		*/
+		bool RegisterBufferRing(int group_id, int buffer_num, int buffer_size);
+
+		//获取一个空闲的提交项(队列满时先提交已有的提交项)
+		struct io_uring_sqe *GetSqe();
+		/**
+		*批量提交所有待提交项并等待完成事件
+		* @param wait_num 至少等待的完成事件数(0为不等待)
+		* @param timeout_microsec 等待超时(微秒,-1为不超时,超时返回-ETIME)
+		* @return 失败返回-errno
+		*/
+		int Submit(int wait_num, int64_t timeout_microsec = -1);
+		//获取一个完成事件,没有时返回NULL
+		struct io_uring_cqe *PeekCqe();
+		//标记当前完成事件已处理
+		void SeenCqe();
+
+		//获取接收缓冲区
+		char *GetBuffer(int buffer_id) { return buffer_memory_ + (int64_t)buffer_id * buffer_size_; }
+		//接收缓冲区使用完毕, 归还给内核
+		void RecycleBuffer(int buffer_id);
+		//获取单个接收缓冲区大小
+		int GetBufferSize() { return buffer_size_; }
+
+	private:
+		int fd_ring_; /***io_uring句柄***/
+		unsigned int sq_pending_; /***已填充未提交的提交项数***/
+
+		void *sq_ring_; /***提交队列映射内存***/
+		size_t sq_ring_size_;
+		void *cq_ring_; /***完成队列映射内存(SINGLE_MMAP时与提交队列相同)***/
+		size_t cq_ring_size_;
+		struct io_uring_sqe *sqes_; /***提交项数组***/
+		size_t sqes_size_;
+
+		unsigned int *sq_head_;
+		unsigned int *sq_tail_;
+		unsigned int sq_mask_;
+		unsigned int sq_entries_;
+		unsigned int *sq_array_;
+		unsigned int *cq_head_;
+		unsigned int *cq_tail_;
+		unsigned int cq_mask_;
+		struct io_uring_cqe *cqes_;
+
+		struct io_uring_buf_ring *buffer_ring_; /***接收缓冲区环***/
+		size_t buffer_ring_size_;
+		char *buffer_memory_; /***接收缓冲区内存***/
+		int buffer_num_;
+		int buffer_size_;
+	};
+}
+#endif
+#endif
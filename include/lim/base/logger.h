@@ -15,43 +15,43 @@ namespace lim {
 		Logger &operator=(const Logger &other) = delete;
 
 	public:
-		//ȡ־
+		//获取日志对象
 		static Logger *GetLogger(const std::string &log_name);
 		/**
-		*־
-		* @param file ļ
-		* @param line ļк
-		* @param level ־ȼ
-		* @param format ־ʽ
+		*输出日志
+		* @param file 代码文件名称
+		* @param line 代码文件行号
+		* @param level 日志等级
+		* @param format 日志输出格式
 		*/
 		void Trace(const std::string &file, int line, int level, const char *format, ...);
 
-		//־ļʽ־ȼ
+		//设置日志文件输出方式包含的日志等级类别
 		void SetLogFileLevel(int log_file_level);
-		//ÿ̨ʽ־ȼ
+		//设置控制台输出方式包含的日志等级类别
 		void SetLogConsoleLevel(int log_console_level);
-		//־ļ·
+		//设置日志文件路径
 		bool SetLogFilePath(const std::string &log_path);
 
   private:
-		//ʼ
+		//初始化
 		bool Initialize(const std::string &log_name);
-		//־ļ
+		//滚动日志文件
 		void RollFile(const std::string day_time);
-		//ļС־ļ
+		//按天和文件大小滚动日志文件
 		void LogRollOver();
   private:
 		std::mutex mutex_;
-		FILE * log_file_fd_; /***־ļ***/
-		std::string log_path_; /***־ļ·***/
-		std::string log_name_; /***־ļ***/
+		FILE * log_file_fd_; /***日志文件句柄***/
+		std::string log_path_; /***日志文件路径***/
+		std::string log_name_; /***日志文件名称***/
 		
-		int log_file_level_; /***ļ־ȼ***/
-		int log_console_level_; /***̨־ȼ***/
+		int log_file_level_; /***文件输出日志等级***/
+		int log_console_level_; /***控制台输出日志等级***/
 		
-		int log_rotate_max_file_size_; /***־ļֽ***/
-		int log_rotate_max_file_num_; /***ÿ־ļ***/
-		std::string last_day_time_; /***һ***/
+		int log_rotate_max_file_size_; /***单个日志文件最大字节数***/
+		int log_rotate_max_file_num_; /***每天日志文件的最大个数***/
+		std::string last_day_time_; /***上一次日期***/
 	};
 
 #define		TRACE_DEBUG(logger, ...)		logger->Trace(__FILE__, __LINE__, Logger::LOG_LEVEL_DEBUG, __VA_ARGS__)
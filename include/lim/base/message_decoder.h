@@ -1,6 +1,7 @@
 #ifndef LIM_MESSAGE_CODER_H
 #define LIM_MESSAGE_CODER_H
 #include <lim/base/byte_buffer.h>
+#include <lim/base/composite_byte_buffer.h>
 #include <functional>
 
 namespace lim {
@@ -11,6 +12,13 @@ namespace lim {
 		
 	public:
 		virtual int ToBytes(ByteBuffer &buffer) = 0;
+		//序列化到组合缓冲区(默认整体序列化为一个组件, 带大数据内容的报文可重载为共享切片)
+		virtual int ToBytes(CompositeByteBuffer &buffer) {
+			ByteBuffer bytes;
+			int length = ToBytes(bytes);
+			buffer.AddComponent(bytes);
+			return length;
+		}
 	};
 	class MessageError {
 	public:
@@ -34,11 +42,11 @@ namespace lim {
 
 		virtual void Reset() = 0;
 		/**
-		*뺯
-		* @param buffer ݻ
-		* @param message_callback messageص
-		* @param error_callback Ϣص
-		* @param is_socket_closed socketǷѶϿ
+		*解码函数
+		* @param buffer 数据缓冲区
+		* @param message_callback 解码后的message回调函数
+		* @param error_callback 错误信息回调函数
+		* @param is_socket_closed socket连接是否已断开
 		*/
 		virtual bool Decode(ByteBuffer &buffer, 
                         HandleMessageCallback &message_callback, 
@@ -0,0 +1,72 @@
+#ifndef LIM_SELECT_POLICY_H
+#define LIM_SELECT_POLICY_H
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+
+namespace lim {
+	enum class SelectPolicyType { ROUND_ROBIN, LEAST_CONNECTIONS, POWER_OF_TWO_CHOICES };
+	/**
+	*负载获取函数申明
+	* @param [in] int 成员下标
+	* @return 成员当前负载(连接数+排队任务数)
+	*/
+	typedef std::function<int64_t(int)> LoadFunction;
+
+	//事件监听器/工作线程选择策略(无锁,可被多个线程并发调用)
+	class SelectPolicy {
+	public:
+		SelectPolicy() = default;
+		virtual ~SelectPolicy() = default;
+
+	private:
+		SelectPolicy(const SelectPolicy& other) = delete;
+		SelectPolicy &operator=(const SelectPolicy& other) = delete;
+
+	public:
+		/**
+		*选择一个成员
+		* @param member_num 成员数
+		* @param load_function 负载获取函数
+		* @return 选中的成员下标
+		*/
+		virtual int Select(int member_num, const LoadFunction &load_function) = 0;
+
+		//按类型创建选择策略
+		static SelectPolicy *CreatePolicy(SelectPolicyType policy_type);
+	};
+
+	//轮询
+	class RoundRobinPolicy : public SelectPolicy {
+	public:
+		RoundRobinPolicy() : index_(0) {}
+		virtual ~RoundRobinPolicy() = default;
+
+		virtual int Select(int member_num, const LoadFunction &load_function);
+
+	private:
+		std::atomic<unsigned int> index_; /***下一个成员下标***/
+	};
+
+	//最少连接(遍历所有成员, 负载相同时从轮询位置开始取第一个)
+	class LeastConnectionsPolicy : public SelectPolicy {
+	public:
+		LeastConnectionsPolicy() : index_(0) {}
+		virtual ~LeastConnectionsPolicy() = default;
+
+		virtual int Select(int member_num, const LoadFunction &load_function);
+
+	private:
+		std::atomic<unsigned int> index_; /***遍历起始下标***/
+	};
+
+	//随机选择两个成员, 取负载较小者
+	class PowerOfTwoChoicesPolicy : public SelectPolicy {
+	public:
+		PowerOfTwoChoicesPolicy() = default;
+		virtual ~PowerOfTwoChoicesPolicy() = default;
+
+		virtual int Select(int member_num, const LoadFunction &load_function);
+	};
+}
+#endif
@@ -8,36 +8,60 @@ namespace lim {
 	class ServerChannelSession: public ExecuteTask {
 	public:
 		ServerChannelSession(SocketChannel &channel, BootstrapConfig &config):
-			channel_(channel), config_(config),
+			channel_(channel), config_(config), event_loop_index_(-1),
 			event_loop_(config.ServerEventLoop()), ExecuteTask(config.ServerExecuteThread()) {
 		}
+
+		/**
+		*SO_REUSEPORT分片监听构造函数(在事件监听器的IO线程中accept, 新连接留在该事件监听器)
+		* @param channel 监听socket(每个事件监听器一个)
+		* @param config 引导配置
+		* @param event_loop_index 事件监听器下标
+		*/
+		ServerChannelSession(SocketChannel &channel, BootstrapConfig &config, int event_loop_index):
+			channel_(channel), config_(config), event_loop_index_(event_loop_index),
+			event_loop_(config.GetEventLoop(event_loop_index)), ExecuteTask(config.GetEventLoop(event_loop_index)) {
+		}
 				
 		virtual ~ServerChannelSession() {
 			event_loop_.RemoveChannel(channel_);
 		}
 		
 	private:
-		//ʼ¼
+		//初始化事件处理函数
 		virtual bool HandleInitEvent() {
-			event_loop_.AddChannel(channel_, this);
+			if (!event_loop_.AddChannel(channel_, this)) {
+				LoggerCallback logger_callback = config_.GetLoggerCallback();
+				if (logger_callback != NULL) {
+					logger_callback(LoggerLevel::LOG_ERROR, "[" + channel_.ToString() + "] " + "add channel to event loop failed");
+				}
+				return false;
+			}
 			return true;
 		}
 		
-		//¼
+		//读事件处理函数
 		virtual bool HandleReadEvent() {
 			std::vector<SocketChannel>socket_channels;
-			channel_.Accept(socket_channels);
+			event_loop_.Accept(channel_, socket_channels);
+			BootstrapConfig::SetLocalEventLoopIndex(event_loop_index_);
 			for (size_t i = 0; i < socket_channels.size(); i++) {
+#ifndef __linux__
+				//Linux下accept的连接继承监听socket的选项(已在listen前设置), 不需要逐个设置
+				socket_channels[i].SetSocketOptions(config_.GetSocketOptions());
+#endif
 				T *session = new T(socket_channels[i], config_);
 				session->Signal(ExecuteEvent::INIT_EVENT);
 			}
+			BootstrapConfig::SetLocalEventLoopIndex(-1);
 			return true;
 		}
 
 	private:
-		SocketChannel channel_; /***socketӶ***/
-		EventLoop &event_loop_; /***¼***/
-		BootstrapConfig &config_; /***(Э)***/
+		SocketChannel channel_; /***socket连接对象***/
+		int event_loop_index_; /***分片监听时所属事件监听器下标,-1为单一监听***/
+		EventLoop &event_loop_; /***事件监听器***/
+		BootstrapConfig &config_; /***引导配置(报文协议相关)***/
   };
 }
 #endif
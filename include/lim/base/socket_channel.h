@@ -2,6 +2,8 @@
 #define LIM_SOCKET_CHANNEL_H
 #include <lim/config.h>
 #include <lim/base/byte_buffer.h>
+#include <lim/base/composite_byte_buffer.h>
+#include <lim/base/file_region.h>
 #ifdef ENABLE_OPENSSL	
 #include <lim/base/sslcontext.h>
 #endif
@@ -9,7 +11,29 @@
 #include <vector>
 #include <atomic>
 
+struct sockaddr;
 namespace lim {
+	//socket选项(数值为-1时使用系统默认值)
+	struct SocketOptions {
+		bool tcp_nodelay; /***禁用Nagle算法(TCP_NODELAY)***/
+		bool tcp_cork; /***分段发送(如响应头+文件)时用TCP_CORK合并报文段(仅Linux的epoll后端)***/
+		int recv_buffer_size; /***接收缓冲区大小(SO_RCVBUF)***/
+		int send_buffer_size; /***发送缓冲区大小(SO_SNDBUF)***/
+		bool keepalive; /***启用TCP保活(SO_KEEPALIVE)***/
+		int keepalive_idle_sec; /***空闲多久后开始保活探测(秒, TCP_KEEPIDLE)***/
+		int keepalive_interval_sec; /***保活探测间隔(秒, TCP_KEEPINTVL)***/
+		int keepalive_count; /***保活探测失败多少次后断开(TCP_KEEPCNT)***/
+		int user_timeout_millisec; /***已发送数据未被确认的最长时间(毫秒, TCP_USER_TIMEOUT)***/
+		int defer_accept_sec; /***监听socket: 收到数据后才唤醒accept的等待时间(秒, TCP_DEFER_ACCEPT)***/
+		int fastopen_queue_num; /***监听socket: TCP Fast Open请求队列长度(TCP_FASTOPEN)***/
+		bool fastopen_connect; /***发起的连接: 首次发送时随SYN携带数据(TCP_FASTOPEN_CONNECT, 仅适用于客户端先发送的协议)***/
+
+		SocketOptions(): tcp_nodelay(true), tcp_cork(false), recv_buffer_size(-1), send_buffer_size(-1),
+			keepalive(false), keepalive_idle_sec(-1), keepalive_interval_sec(-1), keepalive_count(-1),
+			user_timeout_millisec(-1), defer_accept_sec(-1), fastopen_queue_num(-1), fastopen_connect(false) {
+		}
+	};
+
 	class SocketChannel {
 	public:
 		SocketChannel(int socket_channel = -1);
@@ -23,23 +47,65 @@ namespace lim {
 		static bool InitEnviroment();
 		static bool FreeEnviroment();
 		
-		bool Bind(const std::string &unix_path);
-		bool Bind(const std::string &local_host, int local_port);
+		bool Bind(const std::string &unix_path, const SocketOptions &options = SocketOptions());
+		/**
+		*绑定并监听地址
+		* @param local_host 本地地址
+		* @param local_port 本地端口
+		* @param options socket选项
+		* @param is_reuse_port 是否启用SO_REUSEPORT(多个socket监听同一端口, 由内核分配连接)
+		* @return 成功返回true
+		*/
+		bool Bind(const std::string &local_host, int local_port, const SocketOptions &options = SocketOptions(), bool is_reuse_port = false);
+		/**
+		*为SO_REUSEPORT监听组附加按CPU分配连接的CBPF程序(处理软中断的CPU号对监听socket数取模, 作为组内socket的下标)
+		* @param socket_num 监听组中的socket数(组内下标按bind顺序)
+		* @return 不支持或失败返回false(仍按四元组哈希分配)
+		*/
+		bool AttachReusePortCpuFilter(int socket_num);
 
-		bool Connect(const std::string &unix_path);
-		bool Connect(const std::string &remote_host, int remote_port);
+		bool Connect(const std::string &unix_path, const SocketOptions &options = SocketOptions());
+		bool Connect(const std::string &remote_host, int remote_port, const SocketOptions &options = SocketOptions());
+		/**
+		*连接已解析的地址(不再解析域名)
+		* @param remote_host 对端域名(用于SSL主机名校验)
+		* @param remote_ip 对端IPv4地址
+		* @param remote_port 对端端口
+		* @param options socket选项
+		* @return 成功(或连接中)返回true
+		*/
+		bool Connect(const std::string &remote_host, const std::string &remote_ip, int remote_port, const SocketOptions &options = SocketOptions());
 
 		void Accept(std::vector<SocketChannel> &socket_channels);
+		//是否正在进行非阻塞连接(Connect立即返回, 连接结果在socket可写后由FinishConnect获取)
+		bool IsConnecting() { return is_connecting_; }
+		/**
+		*获取非阻塞连接的结果(socket可写或出错后调用)
+		* @param error_code 连接失败时返回错误码
+		* @return 连接失败返回-1, 连接中返回0, 连接成功返回1
+		*/
+		int FinishConnect(int &error_code);
 		
 		bool Close();
 		
 		bool SetNonBlock();
+		/**
+		*设置socket选项(非TCP连接只设置缓冲区大小, 不支持的选项跳过)
+		* @param options socket选项
+		* @param is_listen 是否为监听socket(额外设置TCP_DEFER_ACCEPT/TCP_FASTOPEN, 需在listen前调用; 否则为发起的连接, 需在connect前调用)
+		* @return 有选项设置失败返回false
+		*/
+		bool SetSocketOptions(const SocketOptions &options, bool is_listen = false);
+		//塞住/推出连接(TCP_CORK, 塞住期间不发送未满的报文段), 不支持时返回false
+		bool SetCork(bool is_cork);
 		
 		std::string HostToIp(const std::string &host_name);
 
 #ifdef ENABLE_OPENSSL		
 		bool IsSSLChannel() { return (ssl_context_ != NULL); };
 		bool IsSSLHandshaked() { return is_handshaked_; };
+		//握手后发送方向是否已由内核TLS加密(此时可直接使用send/sendmsg/sendfile发送明文)
+		bool IsKernelTLSSend();
     bool SSLCheckHostName();
 
 		void SetSSLContext(SSLContext *ssl_context) { ssl_context_ = ssl_context; };
@@ -52,16 +118,59 @@ namespace lim {
 		bool SSLHandshake(int &waiton_flag);
 		int SSLReadBytes(ByteBuffer &buffer, int &waiton_flag);
 		int SSLWriteBytes(ByteBuffer &buffer, int &waiton_flag);
+		int SSLWriteBytes(CompositeByteBuffer &buffer, int &waiton_flag);
+		//分块读取文件后加密发送(未发送成功的数据块保留在region中, 重试时参数不变)
+		int64_t SSLWriteFile(FileRegion &region, int &waiton_flag);
 #endif
 
 		int ReadBytes(ByteBuffer &buffer);
 		int WriteBytes(ByteBuffer &buffer);
+		//按组件聚集写(一次系统调用发送多个组件, 发送缓冲区满时未发送的数据留在buffer中)
+		int WriteBytes(CompositeByteBuffer &buffer);
+		/**
+		*按顺序聚集写多个缓冲区(一次系统调用最多发送IOV_MAX个组件)
+		* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+		* @param buffer_num 缓冲区个数
+		* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+		*/
+		int WriteBytes(CompositeByteBuffer **buffers, int buffer_num);
+		//启用零拷贝发送(SO_ZEROCOPY, Linux 4.14及以上), 不支持时返回false
+		bool EnableZeroCopy();
+		/**
+		*以MSG_ZEROCOPY聚集写多个缓冲区(已发送的数据以共享切片移入zero_copy_buffer, 收到完成通知前必须保持有效)
+		* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+		* @param buffer_num 缓冲区个数
+		* @param zero_copy_buffer 追加已发送数据的共享切片
+		* @param zero_copy_num 返回成功的零拷贝发送次数(每次发送占用一个完成通知序号)
+		* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+		*/
+		int WriteBytes(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer &zero_copy_buffer, int &zero_copy_num);
+		/**
+		*读取错误队列中的零拷贝完成通知
+		* @param complete_seq 传入已知的下一个未完成发送序号, 返回更新后的值(取各通知中的最大值, 序号回绕安全)
+		* @return 出错返回-1, 否则返回读取的通知数
+		*/
+		int ReadZeroCopyCompletions(uint32_t &complete_seq);
+		/**
+		*发送文件区域(Linux下由sendfile在内核中直接发送, 不支持时分块读取后发送)
+		* @param region 文件区域, 按发送的字节数消费
+		* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+		*/
+		int64_t WriteFile(FileRegion &region);
 
 		std::string GetRemoteHostName() { return remote_host_name_; }
 		int GetRemoteHostPort() { return remote_host_port_; }
 
 		std::string GetLocalHostName() { return local_host_name_; }
 		int GetLocalHostPort() { return local_host_port_; }
+
+	protected:
+		//封装accept得到的socket句柄(设置非阻塞及SSL, accept4得到的句柄已是非阻塞)
+		SocketChannel AcceptedChannel(int accept_socket_channel);
+		//发起非阻塞连接(连接未立即完成时标记为连接中, 由FinishConnect获取结果)
+		bool StartConnect(const struct sockaddr *remote_addr, int addr_length);
+		//聚集写多个缓冲区(zero_copy_buffer非NULL时以MSG_ZEROCOPY发送)
+		int GatherWriteBytes(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer *zero_copy_buffer, int &zero_copy_num);
 		
 	protected:
 		int socket_channel_;
@@ -70,11 +179,12 @@ namespace lim {
 		SSL *ssl_handle_;
 		bool is_handshaked_;
 #endif
-		std::string remote_host_name_; /***Զ˵ַ***/
-		int remote_host_port_; /***Զ˶˿***/
+		std::string remote_host_name_; /***对端地址***/
+		int remote_host_port_; /***对端端口***/
 
-		std::string local_host_name_; /***صַ***/
-		int local_host_port_; /***ض˿***/
+		std::string local_host_name_; /***本地地址***/
+		int local_host_port_; /***本地端口***/
+		bool is_connecting_; /***是否正在进行非阻塞连接***/
 		
 		std::atomic<int> *reference_count_;
 		friend class EventLoop;
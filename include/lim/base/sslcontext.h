@@ -3,70 +3,214 @@
 #include <string>
 #include <vector>
 #include <stdint.h>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 #include <openssl/ssl.h>
 
 namespace lim {
+  #define SSL_SESSION_CACHE_SHARD_NUM 16 /***会话缓存分片数***/
+  #define SSL_TICKET_KEY_NUM 3 /***保留的会话票据密钥数(当前密钥及之前轮换下来的密钥)***/
+
+  //SSL会话缓存(按key分片, 每个分片独立加锁并按LRU淘汰, 保存序列化后的会话)
+  class SSLSessionCache {
+  public:
+    SSLSessionCache();
+    virtual ~SSLSessionCache() = default;
+
+  private:
+    SSLSessionCache(const SSLSessionCache& other) = delete;
+    SSLSessionCache &operator=(const SSLSessionCache& other) = delete;
+
+  public:
+    /**
+    *设置缓存容量
+    * @param max_session_num 最大会话数(平均分配到各分片)
+    * @param timeout_sec 会话缓存时间(秒)
+    */
+    void SetCapacity(int max_session_num, int timeout_sec);
+    void Put(const std::string &key, const std::string &session_data);
+    /**
+    *查询会话
+    * @param key 会话key
+    * @param session_data 返回序列化后的会话
+    * @return 未命中或已过期返回false
+    */
+    bool Get(const std::string &key, std::string &session_data);
+    void Remove(const std::string &key);
+
+  private:
+    //缓存项
+    struct CacheEntry {
+      std::string key;
+      std::string session_data; /***i2d_SSL_SESSION序列化后的会话***/
+      int64_t expire_time; /***过期时间(单调时钟,微秒)***/
+    };
+    //缓存分片
+    struct CacheShard {
+      std::mutex mutex;
+      std::list<CacheEntry> lru_list; /***表头为最近使用***/
+      std::unordered_map<std::string, std::list<CacheEntry>::iterator> entries;
+    };
+
+    CacheShard &GetShard(const std::string &key);
+
+  private:
+    int shard_capacity_; /***每个分片的最大会话数***/
+    int timeout_sec_; /***会话缓存时间(秒)***/
+    CacheShard shards_[SSL_SESSION_CACHE_SHARD_NUM];
+  };
+
+  //会话复用统计
+  struct SSLSessionStats {
+    int64_t handshake_num; /***完成的握手次数***/
+    int64_t resumed_num; /***其中复用会话的握手次数***/
+    int64_t cache_hit_num; /***会话缓存命中次数***/
+    int64_t cache_miss_num; /***会话缓存未命中次数***/
+  };
+
 	class SSLContext {
 	public:
     SSLContext(bool is_client = false);
 		virtual ~SSLContext();
 
 		/**
-		*SSLʼ
-		* @return ʧܷfalse, ɹtrue
+		*SSL环境初始化
+		* @return 失败返回false, 成功返回true
 		*/
 		static bool InitEnviroment();
 		/**
-		*SSL
-		* @return ʧܷfalse, ɹtrue
+		*SSL环境销毁
+		* @return 失败返回false, 成功返回true
 		*/
 		static bool FreeEnviroment();
 	
 		/**
-		*CA֤
-		* @param ca_file һ PEM ʽ֤ļ·()
-		* @param ca_path һ PEM ʽļ·ļʹضĸʽ(Ϊ)
-		* @return ʧܷfalse, ɹtrue
+		*加载CA证书
+		* @param ca_file 包含一个或多个 PEM 格式的证书的文件的路径(必需)
+		* @param ca_path 一个或多个 PEM 格式文件的路径，不过文件名必须使用特定的格式(可为空)
+		* @return 失败返回false, 成功返回true
 		*/
 		bool LoadCALocations(const std::string &ca_file, const std::string &ca_path);
 		/**
-		*֤飬ڷ͸Զ
-		* @param certificate_file PEM ʽ֤ļ
-		* @return ʧܷfalse, ɹtrue
+		*加载数字证书，用于发送给对端
+		* @param certificate_file PEM 格式数字证书文件
+		* @return 失败返回false, 成功返回true
 		*/
 		bool LoadCertificateFile(const std::string &certificate_file);
 		/**
-		*˽Կļ
-		* @param private_key_file PEM ʽ˽Կļ
-		* @return ʧܷfalse, ɹtrue
+		*加载私钥文件
+		* @param private_key_file PEM 格式私钥文件
+		* @return 失败返回false, 成功返回true
 		*/
 		bool LoadPrivateKeyFile(const std::string &private_key_file);
 		/**
-		*֤ص˽Կ֤Ƿƥ
-		* @return ʧܷfalse, ɹtrue
+		*验证所加载的私钥和证书是否相匹配
+		* @return 失败返回false, 成功返回true
 		*/
 		bool CheckPrivateKey();
 
 		/**
-		*Ƿ֤Զ
-		* @param is_verify_peer, Ƿ֤Զ
+		*设置是否验证对端
+		* @param is_verify_peer, 是否验证对端
 		*/
 		void SetVerifyPeer(int is_verify_peer);
 
     /**
-    *ǷУHostNameֻClientģʽ
-    * @param is_verify_host_name ǷУHostName
+    *是否校验HostName（只适用于Client模式）
+    * @param is_verify_host_name 是否校验HostName
     */
     void SetVerifyHostName(bool is_verify_host_name);
     bool IsVerifyHostName();
 
+    /**
+    *设置是否启用内核TLS(kTLS, 握手后由内核加解密记录, 需OpenSSL 3.0及内核tls模块支持, 不支持的加密套件仍在用户态加密)
+    * @param is_kernel_tls 是否启用内核TLS
+    * @return OpenSSL不支持时返回false
+    */
+    bool SetKernelTLS(bool is_kernel_tls);
+
+    /**
+    *启用会话缓存(所有EventLoop共享同一个SSLContext, 因此共享同一份缓存)
+    * 服务端: 按会话ID缓存会话, 替代OpenSSL内置的单锁缓存
+    * 客户端: 按"主机:端口"缓存服务端下发的会话, Connect时自动复用
+    * @param max_session_num 最大会话数
+    * @param timeout_sec 会话有效时间(秒)
+    */
+    void SetSessionCache(int max_session_num, int timeout_sec);
+    /**
+    *设置会话票据密钥轮换周期(只适用于Server模式), 旧密钥在之后的轮换周期内仍可解密票据(并签发新票据)
+    * @param rotation_sec 轮换周期(秒), 小于等于0时关闭会话票据, 只通过会话缓存复用
+    * @return 失败返回false
+    */
+    bool SetTicketKeyRotation(int rotation_sec);
+    //立即生成新的会话票据密钥
+    void RotateTicketKeys();
+    //获取会话复用统计
+    void GetSessionStats(SSLSessionStats &stats);
+
     bool IsClientContext() { return is_client_; };
 
+  protected:
+    /**
+    *客户端连接前设置待复用的会话
+    * @param ssl_handle SSL连接
+    * @param session_key 会话key("主机:端口")
+    */
+    void PrepareClientSession(SSL *ssl_handle, const std::string &session_key);
+    //握手完成, 更新统计
+    void HandshakeDone(SSL *ssl_handle);
+
+  private:
+    //会话票据密钥
+    struct TicketKey {
+      unsigned char name[16];
+      unsigned char aes_key[32];
+      unsigned char hmac_key[32];
+      int64_t create_time; /***生成时间(单调时钟,微秒)***/
+    };
+
+    static int NewSessionCallback(SSL *ssl_handle, SSL_SESSION *session);
+    static SSL_SESSION *GetSessionCallback(SSL *ssl_handle, const unsigned char *session_id, int length, int *copy);
+    static void RemoveSessionCallback(SSL_CTX *context, SSL_SESSION *session);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static int TicketKeyCallback(SSL *ssl_handle, unsigned char *key_name, unsigned char *iv,
+      EVP_CIPHER_CTX *cipher_context, EVP_MAC_CTX *mac_context, int is_encrypt);
+#else
+    static int TicketKeyCallback(SSL *ssl_handle, unsigned char *key_name, unsigned char *iv,
+      EVP_CIPHER_CTX *cipher_context, HMAC_CTX *hmac_context, int is_encrypt);
+#endif
+    static int SessionKeyIndex();
+    /**
+    *查找会话票据密钥(加密时按轮换周期自动轮换)
+    * @param key_name 加密时返回密钥名称, 解密时传入票据中的密钥名称
+    * @param key 返回密钥
+    * @return 解密时密钥不存在返回-1, 为当前密钥返回0, 为旧密钥返回1
+    */
+    int FindTicketKey(unsigned char *key_name, bool is_encrypt, TicketKey &key);
+    //生成新密钥作为当前密钥, 淘汰最旧的密钥(调用方持有ticket_mutex_)
+    void AddTicketKey();
+
 	protected:
     bool is_client_;
 		SSL_CTX	*context_;
     bool is_verify_host_name_;
     friend class SocketChannel;
+
+  private:
+    SSLSessionCache session_cache_; /***会话缓存***/
+    bool is_session_cache_; /***是否启用会话缓存***/
+
+    std::mutex ticket_mutex_;
+    TicketKey ticket_keys_[SSL_TICKET_KEY_NUM]; /***会话票据密钥,[0]为当前密钥***/
+    int ticket_key_num_; /***已生成的会话票据密钥数***/
+    int ticket_rotation_sec_; /***会话票据密钥轮换周期(秒)***/
+
+    std::atomic<int64_t> handshake_num_;
+    std::atomic<int64_t> resumed_num_;
+    std::atomic<int64_t> cache_hit_num_;
+    std::atomic<int64_t> cache_miss_num_;
 	};
 }
 #endif
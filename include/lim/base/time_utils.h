@@ -5,6 +5,8 @@
 
 namespace lim {
   int64_t CurrentMilliTime();
+  //单调时钟(微秒),用于定时器截止时间
+  int64_t SteadyMicroTime();
   std::string TimeToString(uint64_t millisec, const char *format = NULL);
   std::string GetCurrentTimeString(const char* format = NULL);
 }
@@ -0,0 +1,88 @@
+#ifndef LIM_TIMER_WHEEL_H
+#define LIM_TIMER_WHEEL_H
+#include <stdint.h>
+#include <stddef.h>
+
+namespace lim {
+	#define TIMER_WHEEL_LEVEL_NUM 4
+	#define TIMER_WHEEL_SLOT_BITS 8
+	#define TIMER_WHEEL_SLOT_NUM (1 << TIMER_WHEEL_SLOT_BITS)
+
+	class ExecuteTimer;
+	//时间轮节点(侵入式双向链表节点,嵌入在定时器对象中)
+	struct TimerWheelNode {
+		TimerWheelNode *prev;
+		TimerWheelNode *next;
+		int64_t expire_tick; /***到期tick***/
+		int slot_level; /***所在层级,-1表示在到期链表中***/
+		int slot_index; /***所在槽位***/
+		bool is_linked; /***是否已加入时间轮***/
+		ExecuteTimer *execute_timer; /***所属定时器***/
+	};
+
+	//分层时间轮(非线程安全,由宿主线程加锁保护),Add/Remove均为O(1)
+	class TimerWheel {
+	public:
+		/**
+		*时间轮构造函数
+		* @param current_time 当前时间(微秒)
+		* @param tick_microsec 每个tick的时长(微秒)
+		*/
+		TimerWheel(int64_t current_time, int64_t tick_microsec);
+		virtual ~TimerWheel() = default;
+
+	private:
+		TimerWheel(const TimerWheel& other) = delete;
+		TimerWheel &operator=(const TimerWheel& other) = delete;
+
+	public:
+		/**
+		*加入时间轮(已在时间轮中则重新加入)
+		* @param node 时间轮节点
+		* @param expire_time 到期时间(微秒)
+		*/
+		void Add(TimerWheelNode *node, int64_t expire_time);
+		//从时间轮中移除
+		void Remove(TimerWheelNode *node);
+
+		/**
+		*获取下一次需要处理的时间(到期或降级)
+		* @return 时间轮为空返回-1, 否则返回时间(微秒)
+		*/
+		int64_t NextExpireTime();
+		/**
+		*推进时间轮并取出一个到期节点
+		* @param current_time 当前时间(微秒)
+		* @return 没有到期节点返回NULL
+		*/
+		TimerWheelNode *PopExpired(int64_t current_time);
+
+		size_t Size() { return node_count_; }
+
+	private:
+		//按到期tick放入对应层级的槽位
+		void Link(TimerWheelNode *node);
+		void Unlink(TimerWheelNode *node);
+		//将高层槽位中的节点重新分配到低层
+		void Cascade(int level, int index);
+		//推进时间轮到指定tick
+		void Advance(int64_t current_tick);
+		//下一次需要处理的tick
+		int64_t NextEventTick();
+		//从start开始循环查找第一个非空槽位,没有返回-1
+		int FindNextSlot(int level, int start);
+		//槽位下一次被处理的tick
+		int64_t FirstSlotTick(int level, int index);
+
+	private:
+		int64_t tick_microsec_; /***每个tick的时长(微秒)***/
+		int64_t current_tick_; /***下一个待处理的tick***/
+		size_t node_count_; /***节点数(包含到期链表)***/
+		size_t wheel_node_count_; /***时间轮槽位中的节点数***/
+
+		TimerWheelNode slots_[TIMER_WHEEL_LEVEL_NUM][TIMER_WHEEL_SLOT_NUM]; /***槽位链表头***/
+		uint64_t slot_bitmaps_[TIMER_WHEEL_LEVEL_NUM][TIMER_WHEEL_SLOT_NUM / 64]; /***非空槽位位图***/
+		TimerWheelNode expired_; /***到期链表头***/
+	};
+}
+#endif
@@ -17,21 +17,21 @@ namespace lim {
 					 READ_CHUNK_FOOTER };
 	public:
 		/**
-		*Http
-		* @param max_first_line_size 󳤶
-		* @param max_header_size header󳤶
-		* @param max_content_size content󳤶
+		*Http解码器基类
+		* @param max_first_line_size 首行数据最大长度
+		* @param max_header_size header最大长度
+		* @param max_content_size content最大长度
 		*/
 		HttpBaseDecoder(int max_first_line_size, int max_header_size, int max_content_size);
 		virtual ~HttpBaseDecoder() = default;
 
 		virtual void Reset();
 		/**
-		*뺯
-		* @param buffer ݻ
-		* @param message_callback messageص
-		* @param error_callback Ϣص
-		* @param is_socket_closed socketǷѶϿ
+		*解码函数
+		* @param buffer 数据缓冲区
+		* @param message_callback 解码后的message回调函数
+		* @param error_callback 错误信息回调函数
+		* @param is_socket_closed socket连接是否已断开
 		*/
 		virtual bool Decode(ByteBuffer &buffer, 
                       HandleMessageCallback &message_callback, 
@@ -43,23 +43,23 @@ namespace lim {
 		virtual int64_t GetContentLength() = 0;
 		virtual bool CreatHttpMessage(const std::string &http_first_line) = 0;
 		virtual void SetHeaderValue(const std::string &header_name, const std::string &header_value) = 0;
-		//http message
+		//http message处理函数
 		virtual bool DoHttpMessage(HandleMessageCallback &message_callback) = 0;
-		//http content
+		//http content处理函数
 		virtual bool DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback) = 0;
 
 	private:
 		int ReadContent(ByteBuffer &buffer, HttpContent &content);
 
 	protected:
-		int current_state_; /***ǰ״̬***/
-		int64_t chunk_size_; /***content/chunkС***/
-		HttpHeaders trailing_headers_; /***ֻchunkʽ***/
+		int current_state_; /***当前状态***/
+		int64_t chunk_size_; /***content/chunk大小***/
+		HttpHeaders trailing_headers_; /***只存在于chunk方式***/
 
-		int max_first_line_size_; /***󳤶***/
-		int max_header_size_; /***header󳤶***/
-		int max_content_size_; /***content󳤶***/
-		int bytes_for_current_state_; /***ǰ״̬Ѿյֽ***/
+		int max_first_line_size_; /***首行数据最大长度***/
+		int max_header_size_; /***header最大长度***/
+		int max_content_size_; /***content最大长度***/
+		int bytes_for_current_state_; /***当前状态已经接收的字节数***/
 	};
 }
 #endif
@@ -39,11 +39,11 @@ namespace lim {
     std::string GetServerName() { return server_name_; }
 		
 	protected:
-		int max_first_line_size_; /***󳤶***/
-		int max_header_size_; /***header󳤶***/
-		int max_content_size_; /***content󳤶***/
-		std::string user_agent_; /***User-Agentֶ***/
-		std::string server_name_; /***Serverֶ***/
+		int max_first_line_size_; /***首行数据最大长度***/
+		int max_header_size_; /***header最大长度***/
+		int max_content_size_; /***content最大长度***/
+		std::string user_agent_; /***User-Agent字段名称***/
+		std::string server_name_; /***Server字段名称***/
   };
 }
 #endif
@@ -88,6 +88,8 @@ namespace lim {
 		HttpHeaders &TrailingHeaders() { return trailing_headers_; }
 
 		virtual int ToBytes(ByteBuffer &buffer);
+		//content以切片方式作为独立组件, 不拷贝
+		virtual int ToBytes(CompositeByteBuffer &buffer);
 		
 	protected:
 		bool is_last_;
@@ -134,6 +136,8 @@ namespace lim {
 		HttpContent &Content() { return http_content_; }
 
 		virtual int ToBytes(ByteBuffer &buffer);
+		//首行及header为一个组件, content以切片方式追加
+		virtual int ToBytes(CompositeByteBuffer &buffer);
 
 	protected:
 		HttpContent http_content_;
@@ -147,6 +151,8 @@ namespace lim {
 		HttpContent &Content() { return http_content_; }
 
 		virtual int ToBytes(ByteBuffer &buffer);
+		//首行及header为一个组件, content以切片方式追加
+		virtual int ToBytes(CompositeByteBuffer &buffer);
 
 	protected:
 		HttpContent http_content_;
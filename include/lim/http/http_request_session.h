@@ -7,10 +7,10 @@ namespace lim {
 	class HttpRequestDecoder: public HttpBaseDecoder {
 	public:
 		/**
-		*Http
-		* @param max_first_line_size 󳤶
-		* @param max_header_size header󳤶
-		* @param max_content_size content󳤶
+		*Http请求解码器
+		* @param max_first_line_size 首行数据最大长度
+		* @param max_header_size header最大长度
+		* @param max_content_size content最大长度
 		*/
 		HttpRequestDecoder(int max_first_line_size, int max_header_size, int max_content_size);
 		virtual ~HttpRequestDecoder();
@@ -22,9 +22,9 @@ namespace lim {
 		virtual int64_t GetContentLength();
 		virtual bool CreatHttpMessage(const std::string &http_first_line);
 		virtual void SetHeaderValue(const std::string &header_name, const std::string &header_value);
-		//http message
+		//http message处理函数
 		virtual bool DoHttpMessage(HandleMessageCallback &message_callback);
-		//http content
+		//http content处理函数
 		virtual bool DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback);
 
 	protected:
@@ -38,33 +38,42 @@ namespace lim {
 		virtual ~HttpRequestSession() = default;
 
 		/**
-		*httpӦ(ԶServerͷϢ)
-		* @param response httpӦ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送http响应报文(自动加上Server头信息)
+		* @param response http响应报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteHttpResponse(HttpResponse &response, WriteCompleteCallback callback = NULL);
 
 		/**
-		*http bodyӦ
-		* @param content http bodyӦ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送http body响应报文
+		* @param content http body响应报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteHttpConent(HttpContent &content, WriteCompleteCallback callback = NULL);
+
+		/**
+		*发送http响应报文及文件内容(按文件区域长度设置Content-Length, 文件内容由sendfile直接发送, 可用于Range请求)
+		* @param response http响应报文(只包含首行及header)
+		* @param region 文件区域(由会话接管, 发送结束后释放)
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
+		*/
+		bool WriteHttpFile(HttpResponse &response, FileRegion *region, WriteCompleteCallback callback = NULL);
 	protected:
 		/**
-		*עᴦ·
-		* @param method 
-		* @param path ·
-		* @param handle ص
+		*注册处理路由
+		* @param method 方法名称
+		* @param path 路径
+		* @param handle 回调函数
 		*/
 		bool RegistHandleRouter(const std::string &method, const std::string &path, HttpRequstHandle &handle);
 
 	private:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
-		//ıĴ
+		//解码后的报文处理函数
 		virtual bool HandleMessage(Message &message);
 
 	protected:
@@ -76,19 +85,19 @@ namespace lim {
 	class HttpFullRequestDecoder: public HttpRequestDecoder {
 	public:
 		/**
-		*Http full
-		* @param max_first_line_size 󳤶
-		* @param max_header_size header󳤶
-		* @param max_content_size content󳤶
+		*Http full请求解码器
+		* @param max_first_line_size 首行数据最大长度
+		* @param max_header_size header最大长度
+		* @param max_content_size content最大长度
 		*/
 		HttpFullRequestDecoder(int max_first_line_size, int max_header_size, int max_content_size);
 		virtual ~HttpFullRequestDecoder() = default;
 
 	protected:
 		virtual bool CreatHttpMessage(const std::string &http_first_line);
-		//http message
+		//http message处理函数
 		virtual bool DoHttpMessage(HandleMessageCallback &message_callback);
-		//http content
+		//http content处理函数
 		virtual bool DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback);
 	};
 
@@ -98,7 +107,7 @@ namespace lim {
 		virtual ~HttpFullRequestSession() = default;
 
 	private:	
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
 	};
 }
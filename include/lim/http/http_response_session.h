@@ -7,10 +7,10 @@ namespace lim {
 	class HttpResponseDecoder: public HttpBaseDecoder {
 	public:
 		/**
-		*HttpӦ
-		* @param max_first_line_size 󳤶
-		* @param max_header_size header󳤶
-		* @param max_content_size content󳤶
+		*Http响应解码器
+		* @param max_first_line_size 首行数据最大长度
+		* @param max_header_size header最大长度
+		* @param max_content_size content最大长度
 		*/
 		HttpResponseDecoder(int max_first_line_size, int max_header_size, int max_content_size);
 		virtual ~HttpResponseDecoder();
@@ -22,9 +22,9 @@ namespace lim {
 		virtual int64_t GetContentLength();
 		virtual bool CreatHttpMessage(const std::string &http_first_line);
 		virtual void SetHeaderValue(const std::string &header_name, const std::string &header_value);
-		//http message
+		//http message处理函数
 		virtual bool DoHttpMessage(HandleMessageCallback &message_callback);
-		//http content
+		//http content处理函数
 		virtual bool DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback);
 
 	protected:
@@ -37,42 +37,42 @@ namespace lim {
 		virtual ~HttpResponseSession() = default;
 		
 		/**
-		*http(ԶUser-AgentHostͷϢ)
-		* @param response httpӦ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送http请求报文(自动加上User-Agent、Host头信息)
+		* @param response http响应报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteHttpRequest(HttpRequest &request, WriteCompleteCallback callback = NULL);
 		/**
-		*http body
-		* @param content http body
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送http body请求报文
+		* @param content http body请求报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteHttpConent(HttpContent &content, WriteCompleteCallback callback = NULL);
 	private:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
-		//ıĴ
+		//解码后的报文处理函数
 		virtual bool HandleMessage(Message &message) = 0;
 	};
 
 	class HttpFullResponseDecoder: public HttpResponseDecoder {
 	public:
 		/**
-		*Http fullӦ
-		* @param max_first_line_size 󳤶
-		* @param max_header_size header󳤶
-		* @param max_content_size content󳤶
+		*Http full响应解码器
+		* @param max_first_line_size 首行数据最大长度
+		* @param max_header_size header最大长度
+		* @param max_content_size content最大长度
 		*/
 		HttpFullResponseDecoder(int max_first_line_size, int max_header_size, int max_content_size);
 		virtual ~HttpFullResponseDecoder() = default;
 
 	protected:
 		virtual bool CreatHttpMessage(const std::string &http_first_line);
-		//http message
+		//http message处理函数
 		virtual bool DoHttpMessage(HandleMessageCallback &message_callback);
-		//http content
+		//http content处理函数
 		virtual bool DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback);
 	};
 	
@@ -82,7 +82,7 @@ namespace lim {
 		virtual ~HttpFullResponseSession() = default;
 
 	private:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
 	};
 }
@@ -24,7 +24,7 @@ namespace lim {
 		int GetMaxPayloadSize() { return max_payload_size_; }
 
 	protected:
-		int max_payload_size_; /***websocket󳤶***/
+		int max_payload_size_; /***websocket报文最大长度***/
 	};
 }
 #endif
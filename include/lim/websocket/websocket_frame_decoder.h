@@ -23,11 +23,11 @@ namespace lim {
 
 		virtual void Reset();
 		/**
-		*뺯
-		* @param buffer ݻ
-		* @param message_callback messageص
-		* @param error_callback Ϣص
-		* @param is_socket_closed socketǷѶϿ
+		*解码函数
+		* @param buffer 数据缓冲区
+		* @param message_callback 解码后的message回调函数
+		* @param error_callback 错误信息回调函数
+		* @param is_socket_closed socket连接是否已断开
 		*/
 		virtual bool Decode(ByteBuffer &buffer, 
                       HandleMessageCallback &callback, 
@@ -37,21 +37,21 @@ namespace lim {
   protected:
     WebSocketFrame *CreateWebSocketFream(ByteBuffer &buffer);
     WebSocketFrame *CloneWebSocketFream(WebSocketFrame &frame);
-		//websocket frame
+		//websocket frame处理函数
     virtual bool DoContent(WebSocketFrame &frame, HandleMessageCallback &message_callback, HandleErrorCallback &error_callback);
 		
 	protected:
-		int current_state_; /***ǰ״̬***/
-		int max_payload_size_; /***websocket󳤶***/
-		bool expected_frame_masked_flag_; /***ϢǷ***/
+		int current_state_; /***当前状态***/
+		int max_payload_size_; /***websocket报文最大长度***/
+		bool expected_frame_masked_flag_; /***掩码信息是否必须***/
 
-		bool frame_final_flag_; /***ϢǷ***/
-		int frame_rsv_; /***չλ***/
-		int frame_opcode_; /***չλ***/
-		bool frame_masked_; /***Ϣ***/
+		bool frame_final_flag_; /***描述消息是否结束***/
+		int frame_rsv_; /***扩展位***/
+		int frame_opcode_; /***扩展位***/
+		bool frame_masked_; /***消息类型***/
 
-		char frame_mask_[4]; /***Ϣ***/
-    int64_t frame_payload_length_; /***Ϣ***/
+		char frame_mask_[4]; /***掩码信息***/
+    int64_t frame_payload_length_; /***消息长度***/
 	};
 	
 	class WebSocketFullFrameDecoder : public WebSocketFrameDecoder {
@@ -60,7 +60,7 @@ namespace lim {
 		virtual ~WebSocketFullFrameDecoder();
 
 	protected:
-		//websocket frame
+		//websocket frame处理函数
 		virtual bool DoContent(WebSocketFrame &frame, HandleMessageCallback &message_callback, HandleErrorCallback &error_callback);
   
 	private:
@@ -16,13 +16,19 @@ namespace lim {
 		bool &FrameMasked() { return frame_masked_; }
 		ByteBuffer &FrameContent() { return frame_content_; }
 		virtual int ToBytes(ByteBuffer &buffer);
+		//不带掩码时payload以切片方式作为独立组件, 不拷贝
+		virtual int ToBytes(CompositeByteBuffer &buffer);
 
 	private:
-		bool frame_final_flag_; /***ϢǷ***/
-		int frame_rsv_; /***չλ***/
-		int frame_opcode_; /***չλ***/
-		bool frame_masked_; /***Ϣ***/
-		ByteBuffer frame_content_; /***Ϣ***/
+		//写frame头部(不包含掩码)
+		void WriteFrameHeader(ByteBuffer &buffer);
+
+	private:
+		bool frame_final_flag_; /***描述消息是否结束***/
+		int frame_rsv_; /***扩展位***/
+		int frame_opcode_; /***扩展位***/
+		bool frame_masked_; /***消息类型***/
+		ByteBuffer frame_content_; /***消息内容***/
   };
 
 	class ContinuationWebSocketFrame: public WebSocketFrame {
@@ -13,31 +13,31 @@ namespace lim {
 		virtual ~WebSocketRequestSession() = default;
 
 		/**
-		*websocket frame
-		* @param websocket frameӦ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送websocket frame报文
+		* @param websocket frame响应报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteWebSocketFrame(WebSocketFrame &frame, WriteCompleteCallback callback = NULL);
 		
 	protected:
 		/**
-		*עᴦ·
-		* @param path ·
-		* @param handle ص
+		*注册处理路由
+		* @param path 路径
+		* @param handle 回调函数
 		*/
 		bool RegistHandleRouter(const std::string &path, WebSocketFrameHandle &handle);
 
 	private:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
-		//ıĴ
+		//解码后的报文处理函数
 		virtual bool HandleMessage(Message &message);
-		//ִ
+		//握手处理
 		bool Handshake(HttpFullRequest& request);
 
 	protected:
-		int current_state_; /***ǰ״̬***/
+		int current_state_; /***当前状态***/
 		//std::map<path, handle>
 		std::map<std::string, WebSocketFrameHandle> handle_routers_;
 		WebSocketFrameHandle current_handle_;
@@ -49,7 +49,7 @@ namespace lim {
 		virtual ~WebSocketFullRequestSession() = default;
 
 	protected:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
 	};
 }
@@ -12,33 +12,33 @@ namespace lim {
 		virtual ~WebSocketResponseSession() = default;
 
 		/**
-		*websocket frame
-		* @param websocket frameӦ
-		* @param callback ͽĻص
-		* @return ʧܷfalse, ɹtrue
+		*发送websocket frame报文
+		* @param websocket frame响应报文
+		* @param callback 发送结束后的回调函数
+		* @return 失败返回false, 成功返回true
 		*/
 		bool WriteWebSocketFrame(WebSocketFrame &frame, WriteCompleteCallback callback = NULL);
 			
 	protected:
-		//ֱ
+		//发送握手报文
 		void DoHandshake(const std::string &path, std::map< std::string, std::string> *header = NULL);
 		
 	private:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
-		//ıĴ
+		//解码后的报文处理函数
 		virtual bool HandleMessage(Message &message);
-		//ִ
+		//握手处理
 		bool Handshake(HttpFullResponse& response);
 
-		//ֳɹ
+		//握手成功后
 		virtual void HandleHandshaked();
-		//websocket frameĴ
+		//websocket frame报文处理
 		virtual bool HandleWebSocketFrame(WebSocketFrame&) = 0;
 
 	protected:
-		int current_state_; /***ǰ״̬***/
-		std::string expected_accept_key_; /***ֱĺSec-Websocket-Acceptֵ***/
+		int current_state_; /***当前状态***/
+		std::string expected_accept_key_; /***握手报文后期望的Sec-Websocket-Accept值***/
 	};
 	
 	class WebSocketFullResponseSession: public WebSocketResponseSession {
@@ -47,7 +47,7 @@ namespace lim {
 		virtual ~WebSocketFullResponseSession() = default;
 
 	protected:
-		//Ľ
+		//创建报文解码器
 		virtual MessageDecoder *CreateDecoder();
 	};
 }
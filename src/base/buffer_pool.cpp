@@ -0,0 +1,169 @@
+#include <lim/base/buffer_pool.h>
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+
+namespace lim {
+	#define BUFFER_POOL_CACHE_BYTES (256 * 1024) /***每个级别缓存的最大字节数***/
+	#define BUFFER_POOL_CACHE_MIN_NUM 2 /***每个级别至少可缓存的块数***/
+	#define BUFFER_POOL_SHARED_BYTES (4 * 1024 * 1024) /***每个级别共享溢出链表的最大字节数***/
+
+	//空闲块链表节点(复用空闲块的起始字节)
+	struct BufferPoolNode {
+		BufferPoolNode *next;
+	};
+
+	//线程缓存(平凡析构, 线程退出释放后仍可安全访问)
+	struct BufferPoolCache {
+		BufferPoolNode *free_lists[BUFFER_POOL_CLASS_NUM];
+		int free_nums[BUFFER_POOL_CLASS_NUM];
+		bool is_closed; /***缓存已释放(线程正在退出)***/
+	};
+	static thread_local BufferPoolCache pool_cache;
+
+	//共享溢出链表(线程缓存已满时放入, 线程缓存为空时批量取回, 跨线程释放的内存块可回到申请线程)
+	struct BufferPoolShared {
+		std::mutex mutexs[BUFFER_POOL_CLASS_NUM];
+		BufferPoolNode *free_lists[BUFFER_POOL_CLASS_NUM];
+		std::atomic<int> free_nums[BUFFER_POOL_CLASS_NUM];
+	};
+
+	//获取共享溢出链表(进程退出前不释放, 其它线程退出清理时仍可访问)
+	static BufferPoolShared &SharedPool() {
+		static BufferPoolShared *shared_pool = []() {
+			BufferPoolShared *pool = new BufferPoolShared();
+			for (int i = 0; i < BUFFER_POOL_CLASS_NUM; i++) {
+				pool->free_lists[i] = NULL;
+				pool->free_nums[i] = 0;
+			}
+			return pool;
+		}();
+		return *shared_pool;
+	}
+
+	//级别对应的线程缓存最大块数
+	static inline int CacheMaxNum(int class_index) {
+		int max_num = (BUFFER_POOL_CACHE_BYTES >> (class_index + BUFFER_POOL_MIN_SHIFT));
+		return (max_num < BUFFER_POOL_CACHE_MIN_NUM ? BUFFER_POOL_CACHE_MIN_NUM : max_num);
+	}
+
+	//放入共享溢出链表(已满时返回false)
+	static bool PushShared(int class_index, BufferPoolNode *node) {
+		BufferPoolShared &shared_pool = SharedPool();
+		int max_num = (BUFFER_POOL_SHARED_BYTES >> (class_index + BUFFER_POOL_MIN_SHIFT));
+		std::lock_guard<std::mutex> guard(shared_pool.mutexs[class_index]);
+		if (shared_pool.free_nums[class_index].load(std::memory_order_relaxed) >= max_num) {
+			return false;
+		}
+
+		node->next = shared_pool.free_lists[class_index];
+		shared_pool.free_lists[class_index] = node;
+		shared_pool.free_nums[class_index].fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//从共享溢出链表批量取回空闲块到当前线程缓存(最多取回缓存容量的一半)
+	static void RefillCache(int class_index) {
+		BufferPoolShared &shared_pool = SharedPool();
+		if (shared_pool.free_nums[class_index].load(std::memory_order_relaxed) <= 0) {
+			return;
+		}
+
+		int refill_num = (CacheMaxNum(class_index) + 1) / 2;
+		std::lock_guard<std::mutex> guard(shared_pool.mutexs[class_index]);
+		while (refill_num-- > 0 && shared_pool.free_lists[class_index] != NULL) {
+			BufferPoolNode *node = shared_pool.free_lists[class_index];
+			shared_pool.free_lists[class_index] = node->next;
+			shared_pool.free_nums[class_index].fetch_sub(1, std::memory_order_relaxed);
+			node->next = pool_cache.free_lists[class_index];
+			pool_cache.free_lists[class_index] = node;
+			pool_cache.free_nums[class_index]++;
+		}
+	}
+
+	//线程退出时将缓存的空闲块放入共享溢出链表(已满时归还系统)
+	struct BufferPoolCleaner {
+		~BufferPoolCleaner() {
+			for (int i = 0; i < BUFFER_POOL_CLASS_NUM; i++) {
+				while (pool_cache.free_lists[i] != NULL) {
+					BufferPoolNode *node = pool_cache.free_lists[i];
+					pool_cache.free_lists[i] = node->next;
+					if (!PushShared(i, node)) {
+						free(node);
+					}
+				}
+				pool_cache.free_nums[i] = 0;
+			}
+			pool_cache.is_closed = true;
+		}
+	};
+	static thread_local BufferPoolCleaner pool_cleaner;
+
+	//大小对应的级别(超过最大级别时返回BUFFER_POOL_CLASS_NUM)
+	static inline int SizeClass(int size) {
+		int shift = BUFFER_POOL_MIN_SHIFT;
+		while (shift <= BUFFER_POOL_MAX_SHIFT && (1 << shift) < size) {
+			shift++;
+		}
+		return shift - BUFFER_POOL_MIN_SHIFT;
+	}
+
+	/**
+	*申请内存
+	* @param size 需要的大小
+	* @param allocate_size 返回实际可用的大小(级别大小)
+	* @return 内存地址
+	*/
+	void *BufferPool::Allocate(int size, int &allocate_size) {
+		int class_index = SizeClass(size);
+		if (class_index >= BUFFER_POOL_CLASS_NUM) {
+			allocate_size = size;
+			return malloc(size);
+		}
+
+		allocate_size = (1 << (class_index + BUFFER_POOL_MIN_SHIFT));
+		if (pool_cache.free_lists[class_index] == NULL && !pool_cache.is_closed) {
+			RefillCache(class_index);
+		}
+
+		BufferPoolNode *node = pool_cache.free_lists[class_index];
+		if (node != NULL) {
+			pool_cache.free_lists[class_index] = node->next;
+			pool_cache.free_nums[class_index]--;
+			return node;
+		}
+		return malloc(allocate_size);
+	}
+
+	/**
+	*释放内存(放入当前线程的缓存, 缓存已满时放入共享溢出链表, 均已满时归还系统)
+	* @param memory 内存地址
+	* @param allocate_size 申请时返回的实际大小
+	*/
+	void BufferPool::Free(void *memory, int allocate_size) {
+		if (memory == NULL) {
+			return;
+		}
+
+		int class_index = SizeClass(allocate_size);
+		if (class_index >= BUFFER_POOL_CLASS_NUM) {
+			free(memory);
+			return;
+		}
+
+		//线程正在退出或缓存已满时放入共享溢出链表
+		if (pool_cache.is_closed || pool_cache.free_nums[class_index] >= CacheMaxNum(class_index)) {
+			if (!PushShared(class_index, (BufferPoolNode*)memory)) {
+				free(memory);
+			}
+			return;
+		}
+
+		//首次缓存时注册线程退出清理
+		(void)&pool_cleaner;
+		BufferPoolNode *node = (BufferPoolNode*)memory;
+		node->next = pool_cache.free_lists[class_index];
+		pool_cache.free_lists[class_index] = node;
+		pool_cache.free_nums[class_index]++;
+	}
+}
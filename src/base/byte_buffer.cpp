@@ -1,133 +1,301 @@
 #include <lim/base/byte_buffer.h>
 #include <lim/base/string_utils.h>
+#include <lim/base/buffer_pool.h>
 #include <assert.h>
 #include <string.h>
+#include <new>
 
 namespace lim {
+	#define BYTE_BUFFER_RETAIN_SIZE (64 * 1024) /***数据读完后保留的最大数据区, 超过时归还内存池***/
+
+	#define BYTE_BUFFER_MAX_SIZE ((int)((unsigned)(-1) >> 1)) /***不限制大小时的最大缓存区大小***/
+
+	//数据区内存(带引用计数, 可被多个控制块(切片)共享, 数据紧随其后)
+	struct ByteBufferMemory {
+		std::atomic<int> reference_count; /***引用计数***/
+		int allocate_size; /***内存池申请的大小, 0表示嵌在控制块之后***/
+	};
+
+	//缓冲区控制块(与初始数据区在同一块内存中, 被多个ByteBuffer对象共享)
+	struct ByteBufferBlock {
+		std::atomic<int> reference_count; /***引用计数***/
+		int read_index; /***读偏移***/
+		int write_index; /***写偏移***/
+		int buffer_size; /***当前数据区大小***/
+		int max_buffer_size; /***最大缓存区大小***/
+		int block_size; /***控制块所在内存的大小***/
+		ByteBufferMemory *memory; /***当前数据区所在内存(控制块持有一个引用)***/
+		char *buffer; /***数据区起始地址***/
+	};
+
+	//控制块之后的初始数据区内存(控制块所在内存随其引用计数释放)
+	static inline ByteBufferMemory *InlineMemory(ByteBufferBlock *block) {
+		return (ByteBufferMemory*)(block + 1);
+	}
+
+	static void ReleaseMemory(ByteBufferMemory *memory) {
+		if (--memory->reference_count > 0) {
+			return;
+		}
+
+		if (memory->allocate_size == 0) {
+			ByteBufferBlock *block = (ByteBufferBlock*)memory - 1;
+			int block_size = block->block_size;
+			block->~ByteBufferBlock();
+			BufferPool::Free(block, block_size);
+		} else {
+			BufferPool::Free(memory, memory->allocate_size);
+		}
+	}
+
+	//申请控制块及初始数据区(一次内存池申请)
+	static ByteBufferBlock *AllocateBlock(int init_buffer_size, int max_buffer_size) {
+		int block_size = 0;
+		void *address = BufferPool::Allocate(sizeof(ByteBufferBlock) + sizeof(ByteBufferMemory) + init_buffer_size, block_size);
+		ByteBufferBlock *block = new (address) ByteBufferBlock();
+		block->reference_count.store(1);
+		block->read_index = block->write_index = 0;
+		block->block_size = block_size;
+		block->max_buffer_size = max_buffer_size;
+
+		ByteBufferMemory *memory = InlineMemory(block);
+		memory->reference_count.store(1);
+		memory->allocate_size = 0;
+		block->memory = memory;
+		//初始数据区使用内存池级别中的全部剩余空间
+		block->buffer = (char*)(memory + 1);
+		block->buffer_size = block_size - (int)(sizeof(ByteBufferBlock) + sizeof(ByteBufferMemory));
+		return block;
+	}
+
+	//切换控制块的数据区(释放原数据区的引用)
+	static void ResetMemory(ByteBufferBlock *block, ByteBufferMemory *memory, char *buffer, int buffer_size) {
+		if (block->memory != InlineMemory(block)) {
+			ReleaseMemory(block->memory);
+		}
+		block->memory = memory;
+		block->buffer = buffer;
+		block->buffer_size = buffer_size;
+	}
+
+	static void ReleaseBlock(ByteBufferBlock *block) {
+		if (--block->reference_count > 0) {
+			return;
+		}
+
+		//先释放单独申请的数据区, 再释放控制块所在内存(可能仍被切片引用)
+		ResetMemory(block, InlineMemory(block), NULL, 0);
+		ReleaseMemory(InlineMemory(block));
+	}
+
+	ByteBuffer::ByteBuffer(ByteBufferBlock *block): block_(block) {
+	}
+
 	ByteBuffer::ByteBuffer(int max_buffer_size) {
 		if (max_buffer_size == -1) {
-			max_buffer_size = ((unsigned)(-1) >> 1);
+			max_buffer_size = BYTE_BUFFER_MAX_SIZE;
 		}
 
 		int init_buffer_size = (max_buffer_size > 1024 ? 1024 : max_buffer_size);
-		
-		buffer_read_index_ = new int(0);
-		buffer_write_index_ = new int(0);
-		buffer_size_ = new int(init_buffer_size);
-		max_buffer_size_ = new int(max_buffer_size);
-		buffer_ = new char[*buffer_size_];
-		reference_count_ = new std::atomic<int>(1);
+		block_ = AllocateBlock(init_buffer_size, max_buffer_size);
 	}
 	
 	ByteBuffer::ByteBuffer(int init_buffer_size, int max_buffer_size) {
 		assert(init_buffer_size > 0 && init_buffer_size <= max_buffer_size);
-
-		buffer_read_index_ = new int(0);
-		buffer_write_index_ = new int(0);
-		buffer_size_ = new int(init_buffer_size);
-		max_buffer_size_ = new int(max_buffer_size);
-		buffer_ = new char[*buffer_size_];
-		reference_count_ = new std::atomic<int>(1);
+		block_ = AllocateBlock(init_buffer_size, max_buffer_size);
 	}
 
-	ByteBuffer::ByteBuffer(const ByteBuffer &other)     {
-		buffer_read_index_ = other.buffer_read_index_;
-		buffer_write_index_ = other.buffer_write_index_;
-		buffer_size_ = other.buffer_size_;
-		max_buffer_size_ = other.max_buffer_size_;
-		buffer_ = other.buffer_;
-		
-		reference_count_ = other.reference_count_;
-		(*reference_count_) ++;
+	ByteBuffer::ByteBuffer(const ByteBuffer &other) {
+		block_ = other.block_;
+		block_->reference_count++;
 	}
 
 	ByteBuffer &ByteBuffer::operator =(const ByteBuffer& other) {
-		if (this == &other) {
+		if (this == &other || block_ == other.block_) {
 			return *this;
 		}
 
-		if(--(*reference_count_) <= 0) {
-			delete[] buffer_read_index_;
-			delete[] buffer_write_index_;
-			delete[] buffer_size_;
-			delete[] max_buffer_size_;			
-			delete[] buffer_;			
-			delete reference_count_;	
-		}
-
-		buffer_read_index_ = other.buffer_read_index_;
-		buffer_write_index_ = other.buffer_write_index_;
-		buffer_size_ = other.buffer_size_;
-		max_buffer_size_ = other.max_buffer_size_;
-		buffer_ = other.buffer_;
-		
-		reference_count_ = other.reference_count_;
-		(*reference_count_) ++;
-		
+		ReleaseBlock(block_);
+		block_ = other.block_;
+		block_->reference_count++;
 		return *this;
 	}
 	
 	ByteBuffer::~ByteBuffer() {
-		if (--(*reference_count_) <= 0) {
-			delete[] buffer_read_index_;
-			delete[] buffer_write_index_;
-			delete[] buffer_size_;
-			delete[] max_buffer_size_;			
-			delete[] buffer_;
-			delete reference_count_;	
-		}
+		ReleaseBlock(block_);
 	}
 
-	//ջ
+	//获取缓冲区大小
 	int ByteBuffer::Capacity() {
-		return *max_buffer_size_;
+		return block_->max_buffer_size;
 	}
 
-	//ȡС
+	//清空缓冲区
 	void ByteBuffer::Clear() {
-		*buffer_read_index_ = *buffer_write_index_ = 0;
+		block_->read_index = block_->write_index;
+		ReclaimMemory();
 	}
 
-	//ַл
+	//字符序列化缓冲区内容
 	std::string ByteBuffer::ToString() {
-		std::string value(buffer_ + *buffer_read_index_, ReadableBytes());
+		std::string value(block_->buffer + block_->read_index, ReadableBytes());
 		return value;
 	}
 	
-	//ȡɶֽ
+	//获取缓冲区可读字节数
 	int ByteBuffer::ReadableBytes() {
-		return (*buffer_write_index_ - *buffer_read_index_);
+		return (block_->write_index - block_->read_index);
 	}
 
-	//ȡдֽ
+	//获取缓冲区可写字节数(已读空间可被复用)
 	int ByteBuffer::WritableBytes() {
-		return (*max_buffer_size_ - *buffer_write_index_);
+		return (block_->max_buffer_size - ReadableBytes());
 	}
 
-	//뻺
+	//申请缓存区(扩容后的数据区从内存池单独申请, 只搬移未读数据, 原数据区的引用被释放)
 	bool ByteBuffer::AllocateMemory(int memory_size) {
-		int allocate_size = *buffer_size_;
-		while (true) {
-			allocate_size = ((allocate_size * 3 / 2) <= *max_buffer_size_ ? (allocate_size * 3 / 2) : *max_buffer_size_);
-			if (allocate_size >= memory_size)
-				break;
-			else if (allocate_size == *max_buffer_size_)
-				return false;
+		if (memory_size > block_->max_buffer_size) {
+			return false;
 		}
 
-		char *allocate_buffer = new char[allocate_size];
-		memcpy(allocate_buffer, buffer_, *buffer_size_);
+		int allocate_size = block_->buffer_size;
+		if (allocate_size < memory_size) {
+			allocate_size = (allocate_size * 2 < memory_size ? memory_size : allocate_size * 2);
+			allocate_size = (allocate_size > block_->max_buffer_size ? block_->max_buffer_size : allocate_size);
+		}
 
-		buffer_ = allocate_buffer;
-		*buffer_size_ = allocate_size;
+		ByteBufferMemory *memory = (ByteBufferMemory*)BufferPool::Allocate(sizeof(ByteBufferMemory) + allocate_size, allocate_size);
+		memory->reference_count.store(1);
+		memory->allocate_size = allocate_size;
 
+		int readable_bytes = ReadableBytes();
+		memcpy((char*)(memory + 1), block_->buffer + block_->read_index, readable_bytes);
+		ResetMemory(block_, memory, (char*)(memory + 1), allocate_size - (int)sizeof(ByteBufferMemory));
+		block_->read_index = 0;
+		block_->write_index = readable_bytes;
 		return true;
 	}
 
+	/**
+	*保证数据区尾部有指定大小的可写空间(优先前移未读数据复用已读空间, 不足或数据区被切片共享时重新申请)
+	* @param size 需要写入的字节数
+	* @return 成功true,失败false
+	*/
+	bool ByteBuffer::EnsureWritable(int size) {
+		if (block_->write_index + size <= block_->buffer_size) {
+			return true;
+		}
+
+		int readable_bytes = ReadableBytes();
+		if (readable_bytes + size > block_->buffer_size || block_->memory->reference_count > 1) {
+			return AllocateMemory(readable_bytes + size);
+		}
+
+		memmove(block_->buffer, block_->buffer + block_->read_index, readable_bytes);
+		block_->read_index = 0;
+		block_->write_index = readable_bytes;
+		return true;
+	}
+
+	//数据读完时重置读写偏移, 数据区过大或被切片共享时改用初始数据区
+	void ByteBuffer::ReclaimMemory() {
+		if (block_->read_index != block_->write_index) {
+			return;
+		}
+
+		ByteBufferMemory *inline_memory = InlineMemory(block_);
+		if (block_->memory != inline_memory && inline_memory->reference_count == 1 &&
+			(block_->buffer_size > BYTE_BUFFER_RETAIN_SIZE || block_->memory->reference_count > 1)) {
+			ResetMemory(block_, inline_memory, (char*)(inline_memory + 1),
+				block_->block_size - (int)(sizeof(ByteBufferBlock) + sizeof(ByteBufferMemory)));
+		}
+
+		//数据区被切片共享时已读数据不能被覆盖
+		if (block_->memory->reference_count == 1) {
+			block_->read_index = block_->write_index = 0;
+		}
+	}
+
+	/**
+	*读取指定大小字节数为切片(与当前缓冲区共享数据区, 不拷贝数据)
+	* @param size 切片大小,-1表示读所有数据
+	* @return 返回切片缓冲区(可继续写入, 写入时重新申请数据区)
+	*/
+	ByteBuffer ByteBuffer::ReadSlice(int size) {
+		int length = ((size < 0 || size > ReadableBytes()) ? ReadableBytes() : size);
+		ByteBufferBlock *block = AllocateBlock(0, BYTE_BUFFER_MAX_SIZE);
+		ByteBuffer slice(block);
+		if (length <= block->buffer_size) {
+			//小数据直接拷贝到切片的初始数据区, 避免长期占用当前数据区
+			ReadBytes(block->buffer, length);
+			block->write_index = length;
+			return slice;
+		}
+
+		block_->memory->reference_count++;
+		ResetMemory(block, block_->memory, block_->buffer + block_->read_index, length);
+		block->write_index = length;
+		SkipBytes(length);
+		return slice;
+	}
+
+	/**
+	*读取指定大小字节数为共享切片(小数据也不拷贝, 切片释放前这部分数据区不会被覆盖, 用于零拷贝发送)
+	* @param size 切片大小,-1表示读所有数据
+	* @return 返回切片缓冲区
+	*/
+	ByteBuffer ByteBuffer::ReadSharedSlice(int size) {
+		int length = ((size < 0 || size > ReadableBytes()) ? ReadableBytes() : size);
+		ByteBufferBlock *block = AllocateBlock(0, BYTE_BUFFER_MAX_SIZE);
+		ByteBuffer slice(block);
+		if (length == 0) {
+			return slice;
+		}
+
+		//数据区被共享后, 当前缓冲区写入时不会覆盖切片范围内的数据(见EnsureWritable及ReclaimMemory)
+		block_->memory->reference_count++;
+		ResetMemory(block, block_->memory, block_->buffer + block_->read_index, length);
+		block->write_index = length;
+		SkipBytes(length);
+		return slice;
+	}
+
+	//获取可读数据的起始地址(下一次写入或读取前有效)
+	char *ByteBuffer::ReadableData() {
+		return block_->buffer + block_->read_index;
+	}
+
+	/**
+	*预留连续的可写空间(直接写入数据区后调用CommitWrite提交)
+	* @param size 最少需要的连续可写字节数
+	* @param writable_size 返回实际连续可写的字节数
+	* @return 返回可写地址, 超出最大缓存区大小返回NULL
+	*/
+	char *ByteBuffer::ReserveWritable(int size, int &writable_size) {
+		writable_size = 0;
+		if (size > WritableBytes() || !EnsureWritable(size)) {
+			return NULL;
+		}
+
+		writable_size = block_->buffer_size - block_->write_index;
+		writable_size = (writable_size < WritableBytes() ? writable_size : WritableBytes());
+		return block_->buffer + block_->write_index;
+	}
+
+	//提交直接写入预留空间的字节数
+	void ByteBuffer::CommitWrite(int size) {
+		if (size <= 0) {
+			return;
+		}
+
+		int length = block_->buffer_size - block_->write_index;
+		block_->write_index += (size < length ? size : length);
+	}
+
   /**
-  *ֽڴ
-  * @param size Ҫȡֽsize <= sizeof(uint64_t)
-  * @return ֽڴ
+  *读网络字节次序数据
+  * @param size 需要读取的字节数，size <= sizeof(uint64_t)
+  * @return 返回网络字节次序数据
   */
 	uint64_t ByteBuffer::ReadValue(int size) {
 		if (size > ReadableBytes() || size > sizeof(uint64_t)) {
@@ -136,26 +304,27 @@ namespace lim {
 
 		uint64_t value = 0;
 		for (int i = 0; i < size; i++) {
-			value = (value << i*8) + (uint8_t)(*(buffer_ + *buffer_read_index_ + i));
+			value = (value << i*8) + (uint8_t)(*(block_->buffer + block_->read_index + i));
 		}
 
-		*buffer_read_index_ += size;
+		block_->read_index += size;
+		ReclaimMemory();
 		return value;
 	}
 
   /**
-  *дֽڴ
-  * @param value Ҫдֵ
-  * @param size valueֵĴСsize <= sizeof(uint64_t)
+  *写网络字节次序数据
+  * @param value 需要写的字值
+  * @param size value值的大小，size <= sizeof(uint64_t)
   */
 	void ByteBuffer::WriteValue(uint64_t value, int size) {
-		if (size > WritableBytes() || size > sizeof(uint64_t)) {
+		if (size > WritableBytes() || size > sizeof(uint64_t) || !EnsureWritable(size)) {
 			return;
 		}
 
 		for (int i = size - 1; i >= 0; i--) {
-			*(buffer_ + *buffer_write_index_) = (char)((value >> i*8)&0xff);
-			*buffer_write_index_ += 1;
+			*(block_->buffer + block_->write_index) = (char)((value >> i*8)&0xff);
+			block_->write_index += 1;
 		}
 	}
 	
@@ -191,22 +360,23 @@ namespace lim {
 		WriteValue(value, sizeof(uint64_t));
 	}
 	
-	//skipָɶֽ
+	//skip指定可读字节数
 	int ByteBuffer::SkipBytes(int size) {
 		if (size <= 0) {
 			return 0;
 		}
 
 		int length = size <= ReadableBytes() ? size : ReadableBytes();
-		*buffer_read_index_ += length;
+		block_->read_index += length;
+		ReclaimMemory();
 		return length;
 	}
 	
   /**
-  *ȡָСֽ
-  * @param bytes 
-  * @param size С
-  * @return ʵʶֽ
+  *读取指定大小字节数
+  * @param bytes 读缓冲区
+  * @param size 读缓冲区大小
+  * @return 返回实际读出的字节数
   */
 	int ByteBuffer::ReadBytes(char *bytes, int size) {
 		if (size <= 0) {
@@ -214,50 +384,67 @@ namespace lim {
 		}
 
 		int length = (size <= ReadableBytes() ? size : ReadableBytes());
-		memcpy(bytes, buffer_ + *buffer_read_index_, length);
-		*buffer_read_index_ += length;
+		memcpy(bytes, block_->buffer + block_->read_index, length);
+		block_->read_index += length;
+		ReclaimMemory();
 
 		return length;
 	}
+
+  /**
+  *读取指定大小字节数(不移动读偏移)
+  * @param bytes 读缓冲区
+  * @param size 读缓冲区大小
+  * @return 返回实际读出的字节数
+  */
+	int ByteBuffer::PeekBytes(char *bytes, int size) {
+		if (size <= 0) {
+			return 0;
+		}
+
+		int length = (size <= ReadableBytes() ? size : ReadableBytes());
+		memcpy(bytes, block_->buffer + block_->read_index, length);
+		return length;
+	}
 	
   /**
-  *ȡָСֽ
-  * @param other 
-  * @param size С,-1ʾ
-  * @return ʵʶֽ
+  *读取指定大小字节数
+  * @param other 读缓冲区
+  * @param size 读缓冲区大小,-1表示读所有数据
+  * @return 返回实际读出的字节数
   */
 	int ByteBuffer::ReadBytes(ByteBuffer &other, int size) {
 		int length = other.WritableBytes() <= ReadableBytes() ? other.WritableBytes() : ReadableBytes();
 		if (size != -1 && size > 0) {
 			length = (length < size ? length : size);
 		}
-		other.WriteBytes(buffer_ + *buffer_read_index_, length);
+		other.WriteBytes(block_->buffer + block_->read_index, length);
 		return length;
 	}
 
   /**
-  *дָСֽ
-  * @param bytes д
-  * @param size дС
-  * @return ʵдֽ
+  *写指定大小字节数
+  * @param bytes 写缓冲区
+  * @param size 写缓冲区大小
+  * @return 返回实际写入的字节数
   */
 	int ByteBuffer::WriteBytes(const char *bytes, int size) {
 		int length = (WritableBytes() < size ? WritableBytes() : size);
-		if (*buffer_write_index_ + length > *buffer_size_) {
-			AllocateMemory(*buffer_write_index_ + length);
+		if (!EnsureWritable(length)) {
+			return 0;
 		}
 		
-		memcpy(buffer_ + *buffer_write_index_, bytes, length);
-		*buffer_write_index_ += length;
+		memcpy(block_->buffer + block_->write_index, bytes, length);
+		block_->write_index += length;
 
 		return length;
 	}
 
   /**
-  *дָСֽ
-  * @param other д
-  * @param size дС,-1ʾд
-  * @return ʵдֽ
+  *写指定大小字节数
+  * @param other 写缓冲区
+  * @param size 写缓冲区大小,-1表示写所有数据
+  * @return 返回实际写入的字节数
   */
 	int ByteBuffer::WriteBytes(ByteBuffer &other, int size) {
 		int length = (WritableBytes() < other.ReadableBytes() ? WritableBytes() : other.ReadableBytes());
@@ -265,53 +452,53 @@ namespace lim {
 			length = (length < size ? length : size);
 		}
 		
-		if (*buffer_write_index_ + length > *buffer_size_) {
-			AllocateMemory(*buffer_write_index_ + length);
+		if (!EnsureWritable(length)) {
+			return 0;
 		}
 
-		other.ReadBytes(buffer_ + *buffer_write_index_, length);
-		*buffer_write_index_ += length;
+		other.ReadBytes(block_->buffer + block_->write_index, length);
+		block_->write_index += length;
 
 		return length;
 	}
 
   /**
-  *ָλдָСֽ
-  * @param bytes д
-  * @param bytes д
-  * @param size дС
-  * @return ɹtrue,ʧfalse
+  *从指定位置写入指定大小字节数
+  * @param bytes 写缓冲区
+  * @param bytes 写缓冲区
+  * @param size 写缓冲区大小
+  * @return 成功true,失败false
   */
 	bool ByteBuffer::InsertWriteBytes(int position, const char *bytes, int size) {
 		if (position < 0 || position > ReadableBytes() || size <= 0 || WritableBytes() < size) {
 			return false;
 		}
 
-		if (*buffer_write_index_ + size > *buffer_size_) {
-			AllocateMemory(*buffer_write_index_ + size);
+		if (!EnsureWritable(size)) {
+			return false;
 		}
 		
-		memmove(buffer_ + *buffer_read_index_ + position + size, buffer_ + *buffer_read_index_ + position, ReadableBytes() - position);
-		memcpy(buffer_ + *buffer_read_index_ + position, bytes, size);
-		*buffer_write_index_ += size;
+		memmove(block_->buffer + block_->read_index + position + size, block_->buffer + block_->read_index + position, ReadableBytes() - position);
+		memcpy(block_->buffer + block_->read_index + position, bytes, size);
+		block_->write_index += size;
 
 		return true;
 	}
 
   /**
-  *ȡһ
-  * @param line ص
-  * @param delim ַָ
-  * @return ɹtrue,ʧfalse
+  *获取一行数据
+  * @param line 返回的行数据
+  * @param delim 分割字符串
+  * @return 成功true,失败false
   */
 	bool ByteBuffer::GetLine(std::string &line, const std::string &delim) {
-		char* delim_position = (char*)memmem(buffer_ + *buffer_read_index_, ReadableBytes(), delim.c_str(), delim.length());
+		char* delim_position = (char*)memmem(block_->buffer + block_->read_index, ReadableBytes(), delim.c_str(), delim.length());
 		if (delim_position == NULL) {
 			return false;
 		}
 
-		int line_length = delim_position - (buffer_ + *buffer_read_index_);
-		line = std::string(buffer_ + *buffer_read_index_, line_length);
+		int line_length = delim_position - (block_->buffer + block_->read_index);
+		line = std::string(block_->buffer + block_->read_index, line_length);
 		SkipBytes(line_length + delim.length());
 		return true;
 	}
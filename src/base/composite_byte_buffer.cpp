@@ -0,0 +1,164 @@
+#include <lim/base/composite_byte_buffer.h>
+#include <algorithm>
+
+namespace lim {
+	#define COMPOSITE_BUFFER_MERGE_SIZE 256 /***不超过该大小的组件拷贝合并到末尾组件***/
+
+	CompositeByteBuffer::CompositeByteBuffer(): first_component_(0), readable_bytes_(0), is_tail_writable_(false) {
+	}
+
+	//清空缓冲区
+	void CompositeByteBuffer::Clear() {
+		components_.clear();
+		first_component_ = 0;
+		readable_bytes_ = 0;
+		is_tail_writable_ = false;
+	}
+
+	//字符序列化缓冲区内容
+	std::string CompositeByteBuffer::ToString() {
+		std::string value;
+		for (int i = 0; i < ComponentNum(); i++) {
+			value.append(Component(i).ReadableData(), Component(i).ReadableBytes());
+		}
+		return value;
+	}
+
+	//交换两个缓冲区的内容(转移数据所有权, 不复制组件)
+	void CompositeByteBuffer::Swap(CompositeByteBuffer &other) {
+		components_.swap(other.components_);
+		std::swap(first_component_, other.first_component_);
+		std::swap(readable_bytes_, other.readable_bytes_);
+		std::swap(is_tail_writable_, other.is_tail_writable_);
+	}
+
+	//获取缓冲区可读字节数
+	int CompositeByteBuffer::ReadableBytes() {
+		return readable_bytes_;
+	}
+
+	/**
+	*追加缓冲区的全部可读数据(以切片共享数据区, 小数据拷贝合并到末尾组件)
+	* @param buffer 追加的缓冲区(数据被消费)
+	* @return 返回追加的字节数
+	*/
+	int CompositeByteBuffer::AddComponent(ByteBuffer &buffer) {
+		int length = buffer.ReadableBytes();
+		if (length <= 0) {
+			return 0;
+		}
+
+		if (length <= COMPOSITE_BUFFER_MERGE_SIZE && is_tail_writable_) {
+			length = WriteBytes(buffer.ReadableData(), length);
+			buffer.SkipBytes(length);
+			return length;
+		}
+
+		//小数据的切片是独立拷贝, 后续小数据可直接追加到该组件
+		components_.push_back(buffer.ReadSlice());
+		readable_bytes_ += length;
+		is_tail_writable_ = (length <= COMPOSITE_BUFFER_MERGE_SIZE);
+		return length;
+	}
+
+	/**
+	*追加组合缓冲区的全部组件
+	* @param other 追加的组合缓冲区(数据被消费)
+	* @return 返回追加的字节数
+	*/
+	int CompositeByteBuffer::AddComponents(CompositeByteBuffer &other) {
+		int length = 0;
+		for (int i = 0; i < other.ComponentNum(); i++) {
+			length += AddComponent(other.Component(i));
+		}
+		other.Clear();
+		return length;
+	}
+
+	/**
+	*写指定大小字节数(写入末尾由组合缓冲区自己创建的组件)
+	* @param bytes 写缓冲区
+	* @param size 写缓冲区大小
+	* @return 返回实际写入的字节数
+	*/
+	int CompositeByteBuffer::WriteBytes(const char *bytes, int size) {
+		if (size <= 0) {
+			return 0;
+		}
+
+		//末尾组件是切片时追加写入会拷贝整个切片, 因此另建组件
+		if (!is_tail_writable_) {
+			components_.push_back(ByteBuffer());
+			is_tail_writable_ = true;
+		}
+
+		int length = components_.back().WriteBytes(bytes, size);
+		readable_bytes_ += length;
+		return length;
+	}
+
+	//skip指定可读字节数(读完的组件被移除)
+	int CompositeByteBuffer::SkipBytes(int size) {
+		int length = 0;
+		while (length < size && ComponentNum() > 0) {
+			length += Component(0).SkipBytes(size - length);
+			if (Component(0).ReadableBytes() == 0) {
+				PopComponent();
+			}
+		}
+		readable_bytes_ -= length;
+		return length;
+	}
+
+	/**
+	*读取指定大小字节数
+	* @param bytes 读缓冲区
+	* @param size 读缓冲区大小
+	* @return 返回实际读出的字节数
+	*/
+	int CompositeByteBuffer::ReadBytes(char *bytes, int size) {
+		int length = 0;
+		while (length < size && ComponentNum() > 0) {
+			length += Component(0).ReadBytes(bytes + length, size - length);
+			if (Component(0).ReadableBytes() == 0) {
+				PopComponent();
+			}
+		}
+		readable_bytes_ -= length;
+		return length;
+	}
+
+	/**
+	*读取指定大小字节数为共享切片追加到other(不拷贝也不合并, 切片释放前数据区不会被覆盖, 用于零拷贝发送)
+	* @param other 目标组合缓冲区
+	* @param size 读取的字节数
+	* @return 返回实际读出的字节数
+	*/
+	int CompositeByteBuffer::ReadSharedSlices(CompositeByteBuffer &other, int size) {
+		int length = 0;
+		while (length < size && ComponentNum() > 0) {
+			ByteBuffer slice = Component(0).ReadSharedSlice(size - length);
+			length += slice.ReadableBytes();
+			other.readable_bytes_ += slice.ReadableBytes();
+			other.components_.push_back(slice);
+			if (Component(0).ReadableBytes() == 0) {
+				PopComponent();
+			}
+		}
+		//共享切片不能被追加写入
+		other.is_tail_writable_ = false;
+		readable_bytes_ -= length;
+		return length;
+	}
+
+	//移除已读完的首个组件
+	void CompositeByteBuffer::PopComponent() {
+		//组件读完时已释放共享的数据区(见ByteBuffer::ReclaimMemory), 全部读完时重置组件列表
+		first_component_++;
+		if (first_component_ == (int)components_.size()) {
+			components_.clear();
+			first_component_ = 0;
+			is_tail_writable_ = false;
+		}
+	}
+}
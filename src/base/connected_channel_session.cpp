@@ -1,22 +1,44 @@
 #include <lim/base/connected_channel_session.h>
 #include <lim/base/time_utils.h>
 #include <assert.h>
+#include <string.h>
+#include <limits.h>
+#include <vector>
 
 namespace lim {
+	//一次聚集写的最大发送单元数(与SocketChannel单次聚集写的组件数上限一致)
+#ifdef IOV_MAX
+	#define CONNECTED_SESSION_GATHER_UNIT_NUM IOV_MAX
+#else
+	#define CONNECTED_SESSION_GATHER_UNIT_NUM 1024
+#endif
+
   ConnectedChannelSession::ConnectedChannelSession(SocketChannel &channel, BootstrapConfig &config):
-		channel_(channel), event_loop_(config.NextEventLoop()), config_(config), message_decoder_(NULL), 
-		ExecuteTask(config.NextExecuteThread()), recv_buffer_(config.GetMaxBufferSize()), timeout_timer_(NULL) {
+		ConnectedChannelSession(channel, config, config.NextEventLoopIndex()) {
+	}
+
+	ConnectedChannelSession::ConnectedChannelSession(SocketChannel &channel, BootstrapConfig &config, int event_loop_index):
+		channel_(channel), config_(config), message_decoder_(NULL), 
+		//run-to-completion模式下事件监听器同时作为执行线程
+		ExecuteTask(config.IsRunToCompletion() ? config.GetEventLoop(event_loop_index) : config.PairedExecuteThread(event_loop_index)),
+		event_loop_(config.GetEventLoop(event_loop_index)),
+		recv_buffer_(config.GetMaxBufferSize()), timeout_timer_(NULL), connect_timer_(NULL), is_connect_timeout_(false),
+		write_queue_bytes_(0), is_writable_(true), is_connecting_(channel.IsConnecting()), is_read_paused_(false),
+		is_zero_copy_(false), zero_copy_seq_(0), zero_copy_complete_seq_(0) {
 
 		last_read_timestamp_ = CurrentMilliTime();
 		last_write_timestamp_ = CurrentMilliTime();
 		
 #ifdef ENABLE_OPENSSL
 		read_waiton_flag_ = write_waiton_flag_ = 0;
+		is_ssl_write_ = channel_.IsSSLChannel();
 #endif
 
 		if (config_.GetTimeout() > 0) {
 			timeout_timer_ = new ExecuteTimer(GetExecuteThread(), [&]()->void {
-				int64_t timestamp = (last_read_timestamp_ < last_write_timestamp_ ? last_read_timestamp_ : last_write_timestamp_);
+				int64_t last_read_timestamp = last_read_timestamp_.load(std::memory_order_relaxed);
+				int64_t last_write_timestamp = last_write_timestamp_.load(std::memory_order_relaxed);
+				int64_t timestamp = (last_read_timestamp < last_write_timestamp ? last_read_timestamp : last_write_timestamp);
 				if (CurrentMilliTime() - timestamp >= config_.GetTimeout()) {
 					LoggerCallback logger_callback = config_.GetLoggerCallback();
 					if (logger_callback != NULL) {
@@ -33,57 +55,310 @@ namespace lim {
 
 	ConnectedChannelSession::~ConnectedChannelSession() {
 		delete timeout_timer_;
+		delete connect_timer_;
 		event_loop_.RemoveChannel(channel_);
 		delete message_decoder_;
+		config_.ReleaseWriteMemory(write_queue_bytes_);
+		for (size_t i = 0; i < write_unit_que_.size(); i++) {
+			delete std::get<2>(write_unit_que_[i]);
+		}
 	}
 
 	/**
-	*첽
-	* @param buffer ͻ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*异步发送数据
+	* @param buffer 发送缓冲区
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool ConnectedChannelSession::WriteData(ByteBuffer &buffer, WriteCompleteCallback callback) {
-		std::lock_guard<std::mutex> guard(mutex_);
-		write_unit_que_.push_back(std::make_tuple(buffer, callback));
-		event_loop_.AddChannel(channel_, this, true);
-		return true;
+		CompositeByteBuffer composite_buffer;
+		composite_buffer.AddComponent(buffer);
+		return PushWriteUnit(composite_buffer, NULL, callback);
 	}
 
 	/**
-	*첽Ϣ
-	* @param message Ϣ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*异步发送组合缓冲区数据(各组件不拼接, 按组件聚集写)
+	* @param buffer 发送缓冲区
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
+	*/
+	bool ConnectedChannelSession::WriteData(CompositeByteBuffer &buffer, WriteCompleteCallback callback) {
+		return PushWriteUnit(buffer, NULL, callback);
+	}
+
+	/**
+	*异步发送消息报文
+	* @param message 消息报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool ConnectedChannelSession::WriteMessage(Message &message, WriteCompleteCallback callback) {
-		ByteBuffer buffer;
+		CompositeByteBuffer buffer;
 		message.ToBytes(buffer);
+		return PushWriteUnit(buffer, NULL, callback);
+	}
 
-		std::lock_guard<std::mutex> guard(mutex_);
-		write_unit_que_.push_back(std::make_tuple(buffer, callback));
-		event_loop_.AddChannel(channel_, this, true);
+	/**
+	*异步发送文件区域(普通连接由sendfile在内核中直接发送, SSL连接分块读取后加密发送)
+	* @param region 文件区域(由会话接管, 发送结束后释放)
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
+	*/
+	bool ConnectedChannelSession::WriteFile(FileRegion *region, WriteCompleteCallback callback) {
+		CompositeByteBuffer buffer;
+		return PushWriteUnit(buffer, region, callback);
+	}
+
+	/**
+	*异步发送消息报文及其后的文件区域(如http响应头及文件内容)
+	* @param message 消息报文
+	* @param region 文件区域(由会话接管, 发送结束后释放)
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
+	*/
+	bool ConnectedChannelSession::WriteFile(Message &message, FileRegion *region, WriteCompleteCallback callback) {
+		CompositeByteBuffer buffer;
+		message.ToBytes(buffer);
+		return PushWriteUnit(buffer, region, callback);
+	}
+
+	/**
+	*加入发送队列(队列为空时先在调用线程直接发送, 内核发送缓冲区满时才监听写事件)
+	* @param buffer 发送缓冲区
+	* @param region 缓冲区之后发送的文件区域(可为NULL, 由会话接管)
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
+	*/
+	bool ConnectedChannelSession::PushWriteUnit(CompositeByteBuffer &buffer, FileRegion *region, WriteCompleteCallback callback) {
+		if (region != NULL && !region->IsOpen()) {
+			delete region;
+			return false;
+		}
+
+
+		bool is_writable_changed = false;
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			//队列非空时由写事件处理函数(已监听写事件或正在发送)按顺序发送
+			bool is_queued = (!write_unit_que_.empty() || is_connecting_);
+#ifdef ENABLE_OPENSSL
+			is_queued = (is_queued || is_ssl_write_);
+#endif
+			int send_length = 0;
+			if (!is_queued) {
+				//与写事件处理函数一致, 缓冲区与文件分段发送时先塞住连接, 避免响应头单独成为一个报文段
+				bool is_corked = (region != NULL && config_.GetSocketOptions().tcp_cork &&
+					event_loop_.GetBackend() == EventLoopBackend::EPOLL && channel_.SetCork(true));
+				CompositeByteBuffer *buffers[1] = { &buffer };
+				CompositeByteBuffer zero_copy_buffer;
+				int zero_copy_num = 0;
+				send_length = WriteBuffers(buffers, 1, zero_copy_buffer, zero_copy_num);
+				PushZeroCopyUnit(zero_copy_buffer, zero_copy_num);
+				if (send_length > 0) {
+					last_write_timestamp_ = CurrentMilliTime();
+				}
+				//缓冲区发送完毕后接着发送文件
+				if (send_length != -1 && buffer.ReadableBytes() == 0 && region != NULL) {
+					int64_t file_send_length = event_loop_.WriteFile(channel_, *region);
+					if (file_send_length == -1) {
+						send_length = -1;
+					} else if (file_send_length > 0) {
+						last_write_timestamp_ = CurrentMilliTime();
+					}
+				}
+				if (is_corked) {
+					channel_.SetCork(false);
+				}
+			}
+
+			//文件数据不占用内存, 只计算缓冲区中未发送的字节数
+			int remain_length = buffer.ReadableBytes();
+			bool is_file_remain = (region != NULL && region->ReadableBytes() > 0);
+			if (remain_length > 0 && !config_.AcquireWriteMemory(remain_length)) {
+				//超过所有连接发送队列的内存上限, 丢弃数据并关闭连接(减载)
+				LoggerCallback logger_callback = config_.GetLoggerCallback();
+				if (logger_callback != NULL) {
+					logger_callback(LoggerLevel::LOG_ERROR, "[" + channel_.ToString() + "] " + "write memory is overflow");
+				}
+				Signal(ExecuteEvent::KILL_EVENT);
+				delete region;
+				return false;
+			}
+
+			if (is_queued || send_length == -1 || remain_length > 0 || is_file_remain || callback != NULL) {
+				//发送队列接管未发送的数据
+				write_unit_que_.push_back(std::make_tuple(CompositeByteBuffer(), callback, region));
+				std::get<0>(write_unit_que_.back()).Swap(buffer);
+				write_queue_bytes_ += remain_length;
+			} else {
+				delete region;
+			}
+
+			//超过高水位时不可写
+			if (is_writable_ && config_.GetWriteHighWatermark() > 0 && write_queue_bytes_ > config_.GetWriteHighWatermark()) {
+				is_writable_ = false;
+				is_writable_changed = true;
+			}
+
+			if (is_queued) {
+#ifdef ENABLE_OPENSSL
+				if (is_ssl_write_ && write_unit_que_.size() == 1) {
+					event_loop_.AddChannel(channel_, this, true);
+				}
+#endif
+			} else if (send_length == -1) { //连接已关闭, 由写事件处理函数报告错误
+				Signal(ExecuteEvent::WRITE_EVENT);
+			} else if (remain_length > 0 || is_file_remain) { //发送缓冲区已满
+				event_loop_.UpdateChannel(channel_, true);
+			} else if (callback != NULL) { //发送完毕, 回调在工作线程中执行
+				Signal(ExecuteEvent::WRITE_EVENT);
+			}
+		}
+
+		if (is_writable_changed) {
+			HandleWritabilityChanged(false);
+		}
 		return true;
 	}
 
-	//ʼ¼
+	/**
+	*发送缓冲区(启用零拷贝且数据量达到阈值时以MSG_ZEROCOPY发送)
+	* @param buffers 发送缓冲区数组
+	* @param buffer_num 缓冲区个数
+	* @param zero_copy_buffer 追加零拷贝发送的数据(收到完成通知前保持有效)
+	* @param zero_copy_num 返回零拷贝发送次数
+	* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+	*/
+	int ConnectedChannelSession::WriteBuffers(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer &zero_copy_buffer, int &zero_copy_num) {
+		zero_copy_num = 0;
+		if (is_zero_copy_) {
+			int write_buffer_size = 0;
+			for (int i = 0; i < buffer_num; i++) {
+				write_buffer_size += buffers[i]->ReadableBytes();
+			}
+			//小数据拷贝发送的开销低于零拷贝的页面锁定及完成通知
+			if (write_buffer_size >= config_.GetZeroCopyThreshold()) {
+				return channel_.WriteBytes(buffers, buffer_num, zero_copy_buffer, zero_copy_num);
+			}
+		}
+		return event_loop_.WriteBytes(channel_, buffers, buffer_num);
+	}
+
+	//记录等待完成通知的零拷贝发送(调用方持有mutex_)
+	void ConnectedChannelSession::PushZeroCopyUnit(CompositeByteBuffer &zero_copy_buffer, int zero_copy_num) {
+		if (zero_copy_num <= 0) {
+			return;
+		}
+
+		zero_copy_seq_ += zero_copy_num;
+		zero_copy_que_.push_back(std::make_tuple(zero_copy_seq_, CompositeByteBuffer(), std::vector<WriteCompleteCallback>()));
+		std::get<1>(zero_copy_que_.back()).Swap(zero_copy_buffer);
+	}
+
+	//发送队列是否可写(未发送数据超过高水位后不可写, 降到低水位以下恢复)
+	bool ConnectedChannelSession::IsWritable() {
+		std::lock_guard<std::mutex> guard(mutex_);
+		return is_writable_;
+	}
+
+	/**
+	*检查非阻塞连接的结果(失败或超时时报告错误)
+	* @return 连接失败返回-1, 连接中返回0, 连接成功返回1
+	*/
+	int ConnectedChannelSession::CheckConnected() {
+		int error_code = 0;
+		int ret = channel_.FinishConnect(error_code);
+		if (ret < 0) {
+			ConnectError error_mssage("connect failed: " + std::string(strerror(error_code)));
+			HandleMessageError(error_mssage);
+			return -1;
+		}
+
+		if (ret == 0) {
+			if (is_connect_timeout_) {
+				ConnectError error_mssage("connect timeout");
+				HandleMessageError(error_mssage);
+				return -1;
+			}
+			return 0;
+		}
+
+		if (connect_timer_ != NULL) {
+			connect_timer_->Cancel();
+		}
+		std::lock_guard<std::mutex> guard(mutex_);
+		is_connecting_ = false;
+		//没有待发送的数据时不再监听写事件(SSL连接由握手流程维护)
+		bool is_ssl_channel = false;
+#ifdef ENABLE_OPENSSL
+		is_ssl_channel = channel_.IsSSLChannel();
+#endif
+		if (write_unit_que_.empty() && !is_ssl_channel) {
+			event_loop_.UpdateChannel(channel_, false);
+		}
+		return 1;
+	}
+
+	//初始化事件处理函数
 	bool ConnectedChannelSession::HandleInitEvent() {
 		message_decoder_ = CreateDecoder();
+		//非阻塞连接: 监听写事件等待连接完成, 超时未完成时由写事件处理函数报告错误
+		if (is_connecting_ && config_.GetConnectTimeout() > 0) {
+			connect_timer_ = new ExecuteTimer(GetExecuteThread(), [this]()->void {
+				is_connect_timeout_ = true;
+				this->Signal(ExecuteEvent::WRITE_EVENT);
+			});
+			connect_timer_->Start(config_.GetConnectTimeout());
+		}
 #ifdef ENABLE_OPENSSL
-    //SSL
+    //SSL握手
     if (channel_.IsSSLChannel() && channel_.GetSSLContext()->IsClientContext()) {
-      event_loop_.AddChannel(channel_, this, true);
-      return true;
+      return AddToEventLoop(true);
     }
 #endif
-		event_loop_.AddChannel(channel_, this);
+		//注册前已有未发送完的数据时同时监听写事件
+		std::lock_guard<std::mutex> guard(mutex_);
+		//零拷贝只用于epoll后端的非SSL连接(io_uring后端发送前已拷贝到连接的发送区)
+		if (config_.GetZeroCopyThreshold() > 0 && event_loop_.GetBackend() == EventLoopBackend::EPOLL) {
+#ifdef ENABLE_OPENSSL
+			is_zero_copy_ = (!channel_.IsSSLChannel() && channel_.EnableZeroCopy());
+#else
+			is_zero_copy_ = channel_.EnableZeroCopy();
+#endif
+		}
+		return AddToEventLoop(is_connecting_ || !write_unit_que_.empty());
+	}
+
+	/**
+	*首次注册到事件监听器(fd超出可注册范围等失败时记录日志, 返回false使会话退出)
+	* @param has_write_op 是否监听写事件
+	* @return 失败返回false, 成功返回true
+	*/
+	bool ConnectedChannelSession::AddToEventLoop(bool has_write_op) {
+		if (!event_loop_.AddChannel(channel_, this, has_write_op)) {
+			LoggerCallback logger_callback = config_.GetLoggerCallback();
+			if (logger_callback != NULL) {
+				logger_callback(LoggerLevel::LOG_ERROR, "[" + channel_.ToString() + "] " + "add channel to event loop failed");
+			}
+			return false;
+		}
 		return true;
 	}
 
-	//¼
+	//读事件处理函数
 	bool ConnectedChannelSession::HandleReadEvent() {		
+		//连接完成前的读事件(如连接被拒绝)
+		if (is_connecting_) {
+			int ret = CheckConnected();
+			if (ret <= 0) {
+				return (ret == 0);
+			}
+			//连接已完成, 由写事件处理函数发送队列中的数据(或开始SSL握手)
+			Signal(ExecuteEvent::WRITE_EVENT);
+		}
+
 #ifdef ENABLE_OPENSSL
-		//SSL
+		//SSL握手
 		if (channel_.IsSSLChannel()) {
 			 if (!channel_.IsSSLHandshaked()) {
         int waiton_flag;
@@ -93,20 +368,23 @@ namespace lim {
 					return false;
 				}
 
-				if (!channel_.IsSSLHandshaked()) { //SSLδ
+				if (!channel_.IsSSLHandshaked()) { //SSL握手未完成
           if (waiton_flag == SSL_ERROR_WANT_WRITE) {
             event_loop_.AddChannel(channel_, this, true);
           }
 					return true;
-				} else { //SSL
-					if (channel_.SSLCheckHostName()) {
-						return HandleSSLHandshaked();
+				} else { //SSL握手完成
+					UpdateSSLWriteMode();
+					if (!channel_.SSLCheckHostName()) {
+						SSLHandshakeError error_mssage("ssl verify host name[" + channel_.GetRemoteHostName() + "] failed");
+						HandleMessageError(error_mssage);
+						return false;
 					}
 
-					SSLHandshakeError error_mssage("ssl verify host name[" + channel_.GetRemoteHostName() + "] failed");
-					HandleMessageError(error_mssage);
-					return false;
-					
+					if (!HandleSSLHandshaked()) {
+						return false;
+					}
+					//对端数据可能与握手消息同时到达(如会话复用时紧随Finished的请求), 边沿触发不会再次通知, 继续读取
 				}
 			}
 
@@ -117,6 +395,12 @@ namespace lim {
 			}
 		}
 #endif
+		//发送队列超过高水位时暂停读取(数据留在内核接收缓冲区, 由TCP流控反压对端), 恢复可写后重新触发读事件
+		if (!IsWritable()) {
+			is_read_paused_ = true;
+			return true;
+		}
+
 		bool is_done = false;
 		HandleMessageCallback message_callback = std::bind(&ConnectedChannelSession::HandleMessage, this, std::placeholders::_1);
 		HandleErrorCallback error_callback = std::bind(&ConnectedChannelSession::HandleMessageError, this, std::placeholders::_1);
@@ -126,32 +410,32 @@ namespace lim {
 			if (channel_.IsSSLChannel()) {
         recv_length = channel_.SSLReadBytes(recv_buffer_, read_waiton_flag_);
 			} else {
-				recv_length = channel_.ReadBytes(recv_buffer_);
+				recv_length = event_loop_.ReadBytes(channel_, recv_buffer_);
 			}
 #else
-			int recv_length = channel_.ReadBytes(recv_buffer_);
+			int recv_length = event_loop_.ReadBytes(channel_, recv_buffer_);
 #endif
 			if (recv_length > 0) {
 				last_read_timestamp_ = CurrentMilliTime();
 			}
 			
-			if (recv_length == -1) { //ѹر
+			if (recv_length == -1) { //连接已关闭
 				message_decoder_->Decode(recv_buffer_, message_callback, error_callback, true);
 				ChannelClosedError error_mssage("socket has been closed by peer");
 				HandleMessageError(error_mssage);
 				return false;
-			} else if (recv_buffer_.WritableBytes() > 0) { //ݶ
+			} else if (recv_buffer_.WritableBytes() > 0) { //数据读完
 #ifdef ENABLE_OPENSSL
 				if (read_waiton_flag_ == SSL_ERROR_WANT_WRITE) {
 					event_loop_.AddChannel(channel_, this, true);
 				}
 #endif
 				is_done = true;
-			} else if (recv_buffer_.WritableBytes() == 0) { //
+			} else if (recv_buffer_.WritableBytes() == 0) { //读缓冲区满
 				//atfter consume, if buffer full, then overflow
 				if (!message_decoder_->Decode(recv_buffer_, message_callback, error_callback, false)) {
 					return false;
-				} else if (recv_buffer_.WritableBytes() == 0) { //ûб(ûյݰ)
+				} else if (recv_buffer_.WritableBytes() == 0) { //缓冲区数据没有被消费(没有收到完整的数据包)
 					ReadBufferOverflowError error_mssage("receive buffer is overflow");
 					HandleMessageError(error_mssage);
 					return false;
@@ -159,7 +443,7 @@ namespace lim {
 			}
 		}
 
-		//봦յ
+		//解码处理接收到的数据
 		while (recv_buffer_.ReadableBytes() > 0) {
 			if (!message_decoder_->Decode(recv_buffer_, message_callback, error_callback, false)) {
 				return false;
@@ -168,10 +452,17 @@ namespace lim {
 		return true;
 	}
 
-	//д¼
+	//写事件处理函数
 	bool ConnectedChannelSession::HandleWriteEvent() {
+		if (is_connecting_) {
+			int ret = CheckConnected();
+			if (ret <= 0) {
+				return (ret == 0);
+			}
+		}
+
 #ifdef ENABLE_OPENSSL
-		//SSL
+		//SSL握手
     if (channel_.IsSSLChannel()) {
       if (!channel_.IsSSLHandshaked()) {
         int waiton_flag;
@@ -181,10 +472,13 @@ namespace lim {
           return false;
         }
 
-        if (!channel_.IsSSLHandshaked()) { //SSLδ
+        if (!channel_.IsSSLHandshaked()) { //SSL握手未完成
           return true;
-        } else { //SSL
+        } else { //SSL握手完成
+          UpdateSSLWriteMode();
           if (channel_.SSLCheckHostName()) {
+            //握手期间已到达的对端数据不会再次通知读事件
+            Signal(ExecuteEvent::READ_EVENT);
             return HandleSSLHandshaked();
           }
 
@@ -203,61 +497,173 @@ namespace lim {
 		}
 #endif
 
+		//零拷贝发送完成后释放内核引用的数据, 并按顺序执行等待完成的回调
+		if (is_zero_copy_) {
+			std::vector<WriteCompleteCallback> callbacks;
+			{
+				std::lock_guard<std::mutex> guard(mutex_);
+				if (!zero_copy_que_.empty() && channel_.ReadZeroCopyCompletions(zero_copy_complete_seq_) > 0) {
+					while (!zero_copy_que_.empty() && (int32_t)(zero_copy_complete_seq_ - std::get<0>(zero_copy_que_.front())) >= 0) {
+						std::vector<WriteCompleteCallback> &unit_callbacks = std::get<2>(zero_copy_que_.front());
+						callbacks.insert(callbacks.end(), unit_callbacks.begin(), unit_callbacks.end());
+						zero_copy_que_.pop_front();
+					}
+				}
+			}
+
+			for (size_t i = 0; i < callbacks.size(); i++) {
+				callbacks[i]();
+			}
+		}
+
 		bool is_done = false;
 		while (!is_done) {
+			//一次取出队列前部的多个发送单元聚集写(队列只在尾部追加, 取出的引用在发送期间保持有效)
+			//带文件区域的单元作为本次的最后一个单元, 缓冲区发送完毕后接着发送文件
+			int max_buffer_num = CONNECTED_SESSION_GATHER_UNIT_NUM;
+#ifdef ENABLE_OPENSSL
+			if (is_ssl_write_) { //SSL记录逐个写入, 每次只发送一个单元
+				max_buffer_num = 1;
+			}
+#endif
+			CompositeByteBuffer *buffers[CONNECTED_SESSION_GATHER_UNIT_NUM];
+			FileRegion *region = NULL;
+			int buffer_num = 0;
 			{
 				std::lock_guard<std::mutex> guard(mutex_);
-				if (write_unit_que_.size() == 0) {
-					is_done = true;
-					continue;
+				for (auto it = write_unit_que_.begin(); it != write_unit_que_.end() && buffer_num < max_buffer_num && region == NULL; ++it) {
+					buffers[buffer_num++] = &std::get<0>(*it);
+					region = std::get<2>(*it);
 				}
 			}
+			if (buffer_num == 0) {
+				break;
+			}
 
-			mutex_.lock();
-			WriteUnit &unit = write_unit_que_.front();
-			mutex_.unlock();
-			
-			ByteBuffer &buffer = std::get<0>(unit);
-			WriteCompleteCallback callback = std::get<1>(unit);
+			//缓冲区与文件分段发送时先塞住连接, 避免响应头单独成为一个报文段(io_uring后端异步发送, 不使用)
+			bool is_corked = (region != NULL && config_.GetSocketOptions().tcp_cork &&
+				event_loop_.GetBackend() == EventLoopBackend::EPOLL && channel_.SetCork(true));
+
+			CompositeByteBuffer zero_copy_buffer;
+			int zero_copy_num = 0;
 #ifdef ENABLE_OPENSSL
       int send_length = 0;
-      if (channel_.IsSSLChannel()) {
-        send_length = channel_.SSLWriteBytes(buffer, write_waiton_flag_);
+      if (is_ssl_write_) {
+        send_length = channel_.SSLWriteBytes(*buffers[0], write_waiton_flag_);
       } else {
-        send_length = channel_.WriteBytes(buffer);
+        send_length = WriteBuffers(buffers, buffer_num, zero_copy_buffer, zero_copy_num);
       }
 #else
-      int send_length = channel_.WriteBytes(buffer);
+      int send_length = WriteBuffers(buffers, buffer_num, zero_copy_buffer, zero_copy_num);
 #endif
-			if (send_length > 0) {
+			int64_t file_send_length = 0;
+			if (send_length != -1 && region != NULL && buffers[buffer_num - 1]->ReadableBytes() == 0) {
+#ifdef ENABLE_OPENSSL
+				if (is_ssl_write_) {
+					file_send_length = (write_waiton_flag_ == 0 ? channel_.SSLWriteFile(*region, write_waiton_flag_) : 0);
+				} else {
+					file_send_length = event_loop_.WriteFile(channel_, *region);
+				}
+#else
+				file_send_length = event_loop_.WriteFile(channel_, *region);
+#endif
+			}
+			if (is_corked) {
+				channel_.SetCork(false);
+			}
+			if (send_length > 0 || file_send_length > 0) {
 				last_write_timestamp_ = CurrentMilliTime();
 			}
 			
-			if (send_length == -1) { //ѹر
+			if (send_length == -1 || file_send_length == -1) { //连接已关闭
 				ChannelClosedError error_mssage("socket has been closed by peer");
 				HandleMessageError(error_mssage);
 				return false;
-			} else if (buffer.ReadableBytes() > 0) { //δ
-				is_done = true;
-			} else { //		
-				{
-					std::lock_guard<std::mutex> guard(mutex_);
-					write_unit_que_.pop_front();
-					//ͶΪգƳ"д"¼
-					if (write_unit_que_.size() == 0) {
-						event_loop_.AddChannel(channel_, this);
+			}
+
+			//发送完毕的单元数(文件区域也需发送完毕)
+			int complete_num = 0;
+			while (complete_num < buffer_num && buffers[complete_num]->ReadableBytes() == 0) {
+				complete_num++;
+			}
+			if (complete_num == buffer_num && region != NULL && region->ReadableBytes() > 0) {
+				complete_num--;
+			}
+
+			std::vector<WriteCompleteCallback> callbacks;
+			bool is_writable_changed = false;
+			{
+				std::lock_guard<std::mutex> guard(mutex_);
+				PushZeroCopyUnit(zero_copy_buffer, zero_copy_num);
+				if (send_length > 0) {
+					write_queue_bytes_ -= send_length;
+					config_.ReleaseWriteMemory(send_length);
+				}
+				//降到低水位以下时恢复可写
+				if (!is_writable_ && write_queue_bytes_ <= config_.GetWriteLowWatermark()) {
+					is_writable_ = true;
+					is_writable_changed = true;
+				}
+
+				for (int i = 0; i < complete_num; i++) {
+					WriteCompleteCallback &callback = std::get<1>(write_unit_que_.front());
+					if (callback != NULL) {
+						callbacks.push_back(callback);
 					}
+					delete std::get<2>(write_unit_que_.front());
+					write_unit_que_.pop_front();
 				}
-			
-				if (callback != NULL) {
-					callback();
+
+				//有未完成的零拷贝发送时, 回调在完成通知到达后执行
+				if (!zero_copy_que_.empty() && !callbacks.empty()) {
+					std::vector<WriteCompleteCallback> &unit_callbacks = std::get<2>(zero_copy_que_.back());
+					unit_callbacks.insert(unit_callbacks.end(), callbacks.begin(), callbacks.end());
+					callbacks.clear();
 				}
+
+				if (complete_num < buffer_num) { //数据未发送完毕(发送缓冲区已满)
+					event_loop_.UpdateChannel(channel_, true);
+					is_done = true;
+				} else if (write_unit_que_.size() == 0) { //如果发送队列为空，移除"写"事件监听(未监听时不修改注册)
+					event_loop_.UpdateChannel(channel_, false);
+					is_done = true;
+				}
+			}
+
+			if (is_writable_changed) {
+				HandleWritabilityChanged(true);
+				if (is_read_paused_) {
+					is_read_paused_ = false;
+					Signal(ExecuteEvent::READ_EVENT);
+				}
+			}
+
+			//按发送顺序回调
+			for (size_t i = 0; i < callbacks.size(); i++) {
+				callbacks[i]();
 			}
 		}
 		return true;
 	}
 
-	//Ϣ
+	/**
+	*设置建立连接前的错误(域名解析或发起连接失败时由Bootstrap设置, 随后的KILL_EVENT中以ConnectError报告)
+	* @param error_message 错误信息
+	*/
+	void ConnectedChannelSession::SetConnectError(const std::string &error_message) {
+		connect_error_ = error_message;
+	}
+
+	//Kill事件处理函数(存在建立连接前的错误时先通过HandleMessageError报告)
+	bool ConnectedChannelSession::HandleKillEvent() {
+		if (!connect_error_.empty()) {
+			ConnectError error_mssage(connect_error_);
+			HandleMessageError(error_mssage);
+		}
+		return false;
+	}
+
+	//错误信息处理函数
 	void ConnectedChannelSession::HandleMessageError(MessageError &error) {
 		LoggerCallback logger_callback = config_.GetLoggerCallback();
 		if (logger_callback != NULL) {
@@ -265,8 +671,23 @@ namespace lim {
 		}
 	}
 
+	/**
+	*可写状态变化处理函数(不可写时可在调用WriteData的线程中执行, 恢复可写时在工作线程中执行)
+	* @param is_writable 发送队列是否可写
+	*/
+	void ConnectedChannelSession::HandleWritabilityChanged(bool is_writable) {
+	}
+
 #ifdef ENABLE_OPENSSL
-	//SSLֳɹ
+	//SSL握手完成后, 发送方向已由内核TLS加密时改用普通发送路径(多个单元聚集写, 文件由sendfile发送)
+	void ConnectedChannelSession::UpdateSSLWriteMode() {
+		if (channel_.IsKernelTLSSend()) {
+			std::lock_guard<std::mutex> guard(mutex_);
+			is_ssl_write_ = false;
+		}
+	}
+
+	//SSL握手成功处理函数
 	bool ConnectedChannelSession::HandleSSLHandshaked() {
 		return true;
 	}
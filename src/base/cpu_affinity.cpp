@@ -0,0 +1,149 @@
+#include <lim/base/cpu_affinity.h>
+#include <lim/base/string_utils.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+namespace lim {
+  #define NUMA_NODE_PATH "/sys/devices/system/node"
+
+  //获取CPU核数
+  int GetCpuNum() {
+    int cpu_num = (int)std::thread::hardware_concurrency();
+    return (cpu_num > 0 ? cpu_num : 1);
+  }
+
+#ifndef _WIN32
+  //读取sysfs中的编号列表(cpulist或节点列表, 格式如"0-3,8-11")
+  static std::vector<int> ReadCpuList(const std::string &path) {
+    std::vector<int> cpus;
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == NULL) {
+      return cpus;
+    }
+
+    char line[4096] = { 0 };
+    if (fgets(line, sizeof(line), file) != NULL) {
+      std::string cpu_list(line);
+      std::vector<std::string> ranges = split(trim(cpu_list), ",");
+      for (size_t i = 0; i < ranges.size(); i++) {
+        if (ranges[i].empty()) {
+          continue;
+        }
+
+        int first_cpu = 0, last_cpu = 0;
+        int num = sscanf(ranges[i].c_str(), "%d-%d", &first_cpu, &last_cpu);
+        if (num == 1) {
+          last_cpu = first_cpu;
+        } else if (num != 2) {
+          continue;
+        }
+
+        for (int cpu = first_cpu; cpu <= last_cpu; cpu++) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+    fclose(file);
+    return cpus;
+  }
+#endif
+
+  //获取在线的NUMA节点编号列表(编号可能不连续, 如"0,2"; 不支持NUMA时返回[0])
+  std::vector<int> GetNumaNodes() {
+    std::vector<int> nodes;
+#ifndef _WIN32
+    nodes = ReadCpuList(NUMA_NODE_PATH "/online");
+#endif
+    if (nodes.size() == 0) {
+      nodes.push_back(0);
+    }
+    return nodes;
+  }
+
+  //获取NUMA节点数(不支持NUMA时返回1)
+  int GetNumaNodeNum() {
+    return (int)GetNumaNodes().size();
+  }
+
+  //获取NUMA节点上的CPU列表
+  std::vector<int> GetNumaNodeCpus(int numa_node) {
+    std::vector<int> cpus;
+#ifndef _WIN32
+    cpus = ReadCpuList(std::string(NUMA_NODE_PATH "/node") + std::to_string(numa_node) + "/cpulist");
+#endif
+    //不支持NUMA时所有CPU都属于节点0
+    if (cpus.size() == 0 && numa_node == 0) {
+      for (int cpu = 0; cpu < GetCpuNum(); cpu++) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  /**
+  *按分配方式生成CPU列表(作为线程组的cpu_list参数,第i个线程绑定到第i%size个CPU)
+  * @param placement 分配方式
+  * @return CPU列表
+  */
+  std::vector<int> GetPlacementCpus(CpuPlacement placement) {
+    std::vector<std::vector<int>> node_cpus;
+    size_t max_cpu_num = 0;
+    std::vector<int> nodes = GetNumaNodes();
+    for (size_t i = 0; i < nodes.size(); i++) {
+      node_cpus.push_back(GetNumaNodeCpus(nodes[i]));
+      if (node_cpus.back().size() > max_cpu_num) {
+        max_cpu_num = node_cpus.back().size();
+      }
+    }
+
+    std::vector<int> cpus;
+    if (placement == CpuPlacement::COMPACT) {
+      for (size_t node = 0; node < node_cpus.size(); node++) {
+        cpus.insert(cpus.end(), node_cpus[node].begin(), node_cpus[node].end());
+      }
+    } else {
+      for (size_t i = 0; i < max_cpu_num; i++) {
+        for (size_t node = 0; node < node_cpus.size(); node++) {
+          if (i < node_cpus[node].size()) {
+            cpus.push_back(node_cpus[node][i]);
+          }
+        }
+      }
+    }
+    return cpus;
+  }
+
+  /**
+  *将当前线程绑定到指定CPU
+  * @param cpu CPU编号
+  * @return 失败返回false, 成功返回true
+  */
+  bool BindCurrentThreadToCpu(int cpu) {
+    if (cpu < 0) {
+      return false;
+    }
+#ifdef _WIN32
+    if (cpu >= (int)(sizeof(DWORD_PTR) * 8)) {
+      return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+    if (cpu >= CPU_SETSIZE) {
+      return false;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#endif
+  }
+}
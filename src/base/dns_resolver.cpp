@@ -0,0 +1,541 @@
+#include <lim/base/dns_resolver.h>
+#include <lim/base/time_utils.h>
+#include <string.h>
+#include <ctype.h>
+#include <random>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#endif
+
+namespace lim {
+	#define DNS_RESOLVER_PACKET_SIZE 512 /***UDP报文的最大长度***/
+	#define DNS_RESOLVER_SHARD_MAX_SIZE 4096 /***每个缓存分片的最大项数***/
+	#define DNS_TYPE_A 1
+	#define DNS_TYPE_CNAME 5
+	#define DNS_CLASS_IN 1
+	#define DNS_FLAG_TC 0x02 /***应答被截断***/
+	#define DNS_RCODE_NXDOMAIN 3
+	#define DNS_RESOLVER_MAX_POINTER_NUM 16 /***一个域名中最多跟随的压缩指针数(防止指针循环)***/
+	#define DNS_RESOLVER_MAX_CNAME_NUM 8 /***最多跟随的CNAME层数***/
+
+	/**
+	*读取报文中的域名(支持压缩指针, 转为小写)
+	* @param packet 报文
+	* @param length 报文长度
+	* @param offset 域名起始位置, 返回域名之后的位置
+	* @param name 返回以'.'分隔的域名
+	* @return 越界或指针循环返回false
+	*/
+	static bool ReadName(const uint8_t *packet, int length, int &offset, std::string &name) {
+		name.clear();
+		int position = offset;
+		int pointer_num = 0;
+		while (position < length) {
+			uint8_t label_length = packet[position];
+			if (label_length == 0) {
+				if (pointer_num == 0) {
+					offset = position + 1;
+				}
+				return true;
+			}
+
+			if ((label_length & 0xC0) == 0xC0) { //压缩指针
+				if (position + 1 >= length || ++pointer_num > DNS_RESOLVER_MAX_POINTER_NUM) {
+					return false;
+				}
+				if (pointer_num == 1) {
+					offset = position + 2;
+				}
+				position = ((label_length & 0x3F) << 8) | packet[position + 1];
+				continue;
+			}
+
+			if ((label_length & 0xC0) != 0 || position + 1 + label_length > length) {
+				return false;
+			}
+			if (!name.empty()) {
+				name += '.';
+			}
+			for (int i = 0; i < label_length; i++) {
+				name += (char)tolower(packet[position + 1 + i]);
+			}
+			position += label_length + 1;
+		}
+		return false;
+	}
+
+	//域名转为小写并去掉结尾的'.', 用于与应答中的域名比较
+	static std::string NormalizeName(const std::string &host_name) {
+		std::string name;
+		for (size_t i = 0; i < host_name.size(); i++) {
+			name += (char)tolower((unsigned char)host_name[i]);
+		}
+		if (!name.empty() && name[name.size() - 1] == '.') {
+			name.erase(name.size() - 1);
+		}
+		return name;
+	}
+
+	static inline uint16_t ReadUint16(const uint8_t *data) {
+		return (uint16_t)((data[0] << 8) | data[1]);
+	}
+
+	static inline uint32_t ReadUint32(const uint8_t *data) {
+		return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+	}
+
+	/**
+	*构造A记录查询报文
+	* @param host_name 域名
+	* @param id 报文ID
+	* @param packet 报文缓冲区(DNS_RESOLVER_PACKET_SIZE)
+	* @return 域名不合法返回-1, 否则返回报文长度
+	*/
+	static int BuildQuery(const std::string &host_name, uint16_t id, uint8_t *packet) {
+		memset(packet, 0, 12);
+		packet[0] = (uint8_t)(id >> 8);
+		packet[1] = (uint8_t)(id & 0xFF);
+		packet[2] = 0x01; //RD: 期望递归查询
+		packet[5] = 1; //QDCOUNT
+
+		int offset = 12;
+		size_t start = 0;
+		while (start < host_name.size()) {
+			size_t end = host_name.find('.', start);
+			if (end == std::string::npos) {
+				end = host_name.size();
+			}
+			size_t label_length = end - start;
+			if (label_length == 0 || label_length > 63 || offset + (int)label_length + 6 > DNS_RESOLVER_PACKET_SIZE) {
+				return -1;
+			}
+			packet[offset++] = (uint8_t)label_length;
+			memcpy(packet + offset, host_name.data() + start, label_length);
+			offset += (int)label_length;
+			start = end + 1;
+		}
+		packet[offset++] = 0;
+		packet[offset++] = 0;
+		packet[offset++] = DNS_TYPE_A;
+		packet[offset++] = 0;
+		packet[offset++] = DNS_CLASS_IN;
+		return offset;
+	}
+
+	//应答中的资源记录
+	struct DnsRecord {
+		std::string owner; /***记录所属域名***/
+		int type;
+		int64_t ttl;
+		int data_offset; /***记录数据在报文中的位置***/
+		int data_length;
+	};
+
+	/**
+	*解析应答报文: 校验问题部分与查询一致, 从查询的域名开始沿CNAME链查找A记录(链上记录的最小TTL作为缓存时间)
+	* @param packet 应答报文
+	* @param length 报文长度
+	* @param id 查询报文ID
+	* @param host_name 查询的域名(NormalizeName后)
+	* @param ip 返回IPv4地址
+	* @param ttl_sec 返回TTL(秒)
+	* @return 报文不合法(ID或问题部分不匹配)返回-1, 域名不存在或没有A记录返回0, 成功返回1, 应答被截断或服务器出错返回2
+	*/
+	static int ParseResponse(const uint8_t *packet, int length, uint16_t id, const std::string &host_name, std::string &ip, int &ttl_sec) {
+		if (length < 12 || ReadUint16(packet) != id || (packet[2] & 0x80) == 0 || ReadUint16(packet + 4) != 1) {
+			return -1;
+		}
+
+		//问题部分必须与BuildQuery发送的一致
+		std::string name;
+		int offset = 12;
+		if (!ReadName(packet, length, offset, name) || offset + 4 > length) {
+			return -1;
+		}
+		if (name != host_name || ReadUint16(packet + offset) != DNS_TYPE_A || ReadUint16(packet + offset + 2) != DNS_CLASS_IN) {
+			return -1;
+		}
+		offset += 4;
+
+		//截断的应答不能说明域名不存在, 由调用方改用其它方式解析
+		if (packet[2] & DNS_FLAG_TC) {
+			return 2;
+		}
+		int rcode = packet[3] & 0x0F;
+		if (rcode == DNS_RCODE_NXDOMAIN) {
+			return 0;
+		} else if (rcode != 0) { //SERVFAIL/REFUSED等
+			return 2;
+		}
+
+		std::vector<DnsRecord> records;
+		int answer_num = ReadUint16(packet + 6);
+		for (int i = 0; i < answer_num; i++) {
+			DnsRecord record;
+			if (!ReadName(packet, length, offset, record.owner) || offset + 10 > length) {
+				return -1;
+			}
+			record.type = ReadUint16(packet + offset);
+			int clazz = ReadUint16(packet + offset + 2);
+			record.ttl = ReadUint32(packet + offset + 4);
+			record.data_length = ReadUint16(packet + offset + 8);
+			record.data_offset = offset + 10;
+			offset = record.data_offset + record.data_length;
+			if (offset > length) {
+				return -1;
+			}
+			if (clazz == DNS_CLASS_IN && (record.type == DNS_TYPE_A || record.type == DNS_TYPE_CNAME)) {
+				records.push_back(record);
+			}
+		}
+
+		//只接受所属域名在CNAME链上的记录
+		std::string target = host_name;
+		int64_t min_ttl = -1;
+		for (int depth = 0; depth <= DNS_RESOLVER_MAX_CNAME_NUM; depth++) {
+			const DnsRecord *cname_record = NULL;
+			for (size_t i = 0; i < records.size(); i++) {
+				const DnsRecord &record = records[i];
+				if (record.owner != target) {
+					continue;
+				}
+				if (record.type == DNS_TYPE_A && record.data_length == 4) {
+					char ip_addr[INET_ADDRSTRLEN] = {0};
+					inet_ntop(AF_INET, (void *)(packet + record.data_offset), ip_addr, sizeof(ip_addr));
+					ip = ip_addr;
+					ttl_sec = (int)(min_ttl < 0 || record.ttl < min_ttl ? record.ttl : min_ttl);
+					return 1;
+				} else if (record.type == DNS_TYPE_CNAME && cname_record == NULL) {
+					cname_record = &record;
+				}
+			}
+
+			if (cname_record == NULL) {
+				break;
+			}
+			int data_offset = cname_record->data_offset;
+			if (!ReadName(packet, length, data_offset, target)) {
+				return -1;
+			}
+			if (min_ttl < 0 || cname_record->ttl < min_ttl) {
+				min_ttl = cname_record->ttl;
+			}
+		}
+		return 0;
+	}
+
+	/**
+	*域名解析服务构造函数
+	* @param thread_num 解析线程数
+	*/
+	DnsResolver::DnsResolver(int thread_num): server_port_(53), max_ttl_sec_(300), negative_ttl_sec_(5),
+		timeout_millisec_(1000), retry_num_(2), is_running_(true) {
+		if (thread_num <= 0) {
+			thread_num = 1;
+		}
+		for (int i = 0; i < thread_num; i++) {
+			threads_.push_back(std::thread(&DnsResolver::Run, this));
+		}
+	}
+
+	DnsResolver::~DnsResolver() {
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			is_running_ = false;
+		}
+		cond_.notify_all();
+		for (size_t i = 0; i < threads_.size(); i++) {
+			threads_[i].join();
+		}
+
+		//未解析的请求按失败回调
+		for (auto iter = pending_callbacks_.begin(); iter != pending_callbacks_.end(); iter++) {
+			for (size_t i = 0; i < iter->second.size(); i++) {
+				iter->second[i]("");
+			}
+		}
+	}
+
+	/**
+	*设置DNS服务器(设置后通过UDP直接查询A记录并使用应答中的TTL, 否则在解析线程中调用getaddrinfo)
+	* @param server_ip DNS服务器地址
+	* @param server_port DNS服务器端口
+	*/
+	void DnsResolver::SetNameServer(const std::string &server_ip, int server_port) {
+		server_ip_ = server_ip;
+		server_port_ = server_port;
+	}
+
+	/**
+	*设置缓存时间(秒)
+	* @param max_ttl_sec 解析成功的最长缓存时间(应答TTL超过时截断, getaddrinfo解析时直接使用)
+	* @param negative_ttl_sec 解析失败的缓存时间(0为不缓存)
+	*/
+	void DnsResolver::SetCacheTtl(int max_ttl_sec, int negative_ttl_sec) {
+		max_ttl_sec_ = max_ttl_sec;
+		negative_ttl_sec_ = negative_ttl_sec;
+	}
+
+	/**
+	*设置UDP查询的超时时间及重试次数
+	* @param timeout_millisec 每次查询的超时时间(毫秒)
+	* @param retry_num 超时后的重试次数
+	*/
+	void DnsResolver::SetQueryTimeout(int timeout_millisec, int retry_num) {
+		timeout_millisec_ = timeout_millisec;
+		retry_num_ = retry_num;
+	}
+
+	/**
+	*异步解析域名(IP地址或缓存命中时直接在调用线程中回调)
+	* @param host_name 域名
+	* @param callback 解析完成回调函数
+	*/
+	void DnsResolver::Resolve(const std::string &host_name, ResolveCallback callback) {
+		struct in_addr addr;
+		if (inet_pton(AF_INET, host_name.c_str(), &addr) == 1) {
+			callback(host_name);
+			return;
+		}
+
+		std::string ip;
+		if (Lookup(host_name, ip)) {
+			callback(ip);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			std::vector<ResolveCallback> &callbacks = pending_callbacks_[host_name];
+			callbacks.push_back(callback);
+			if (callbacks.size() > 1) { //已在解析中, 等待同一结果
+				return;
+			}
+			query_que_.push_back(host_name);
+		}
+		cond_.notify_one();
+	}
+
+	/**
+	*查询缓存
+	* @param host_name 域名
+	* @param ip 返回缓存的IPv4地址(缓存的失败结果为空)
+	* @return 缓存未命中或已过期返回false
+	*/
+	bool DnsResolver::Lookup(const std::string &host_name, std::string &ip) {
+		CacheShard &shard = GetShard(host_name);
+		std::lock_guard<std::mutex> guard(shard.mutex);
+		auto iter = shard.entries.find(host_name);
+		if (iter == shard.entries.end()) {
+			return false;
+		}
+
+		if (iter->second.expire_time <= SteadyMicroTime()) {
+			shard.entries.erase(iter);
+			return false;
+		}
+		ip = iter->second.ip;
+		return true;
+	}
+
+	//解析线程主函数
+	void DnsResolver::Run() {
+		while (true) {
+			std::string host_name;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				cond_.wait(lock, [this] { return !is_running_ || !query_que_.empty(); });
+				if (!is_running_) {
+					return;
+				}
+				host_name = query_que_.front();
+				query_que_.pop_front();
+			}
+
+			int ttl_sec = 0;
+			std::string ip = Query(host_name, ttl_sec);
+			Store(host_name, ip, ttl_sec);
+
+			std::vector<ResolveCallback> callbacks;
+			{
+				std::lock_guard<std::mutex> guard(mutex_);
+				auto iter = pending_callbacks_.find(host_name);
+				if (iter != pending_callbacks_.end()) {
+					callbacks.swap(iter->second);
+					pending_callbacks_.erase(iter);
+				}
+			}
+
+			for (size_t i = 0; i < callbacks.size(); i++) {
+				callbacks[i](ip);
+			}
+		}
+	}
+
+	/**
+	*解析域名(阻塞)
+	* @param host_name 域名
+	* @param ttl_sec 返回缓存时间(秒, 0为不缓存)
+	* @return 失败返回空
+	*/
+	std::string DnsResolver::Query(const std::string &host_name, int &ttl_sec) {
+		ttl_sec = 0;
+		if (!server_ip_.empty()) {
+			return QueryNameServer(host_name, ttl_sec);
+		}
+		return QuerySystem(host_name, ttl_sec);
+	}
+
+	//通过UDP向DNS服务器查询A记录
+	std::string DnsResolver::QueryNameServer(const std::string &host_name, int &ttl_sec) {
+		static thread_local std::mt19937 generator(std::random_device{}());
+		uint8_t packet[DNS_RESOLVER_PACKET_SIZE];
+		uint16_t id = (uint16_t)(generator() & 0xFFFF);
+		int packet_length = BuildQuery(host_name, id, packet);
+		if (packet_length < 0) {
+			return "";
+		}
+
+		int fd = (int)socket(AF_INET, SOCK_DGRAM, 0);
+		if (fd < 0) {
+			return "";
+		}
+
+		//connect后只接收DNS服务器的应答
+		struct sockaddr_in server = { 0 };
+		server.sin_family = AF_INET;
+		server.sin_port = htons(server_port_);
+		inet_pton(AF_INET, server_ip_.c_str(), &server.sin_addr);
+		std::string ip;
+		std::string query_name = NormalizeName(host_name);
+		int ret = -1;
+		if (connect(fd, (struct sockaddr *)&server, sizeof(server)) == 0) {
+			for (int i = 0; i <= retry_num_ && ip.empty(); i++) {
+				if (send(fd, (const char *)packet, packet_length, 0) != packet_length) {
+					break;
+				}
+
+				int64_t deadline = SteadyMicroTime() + (int64_t)timeout_millisec_ * 1000;
+				ret = -1;
+				while (true) {
+					int64_t wait_millisec = (deadline - SteadyMicroTime()) / 1000;
+					if (wait_millisec <= 0) {
+						break;
+					}
+
+					struct pollfd poll_fd;
+					poll_fd.fd = fd;
+					poll_fd.events = POLLIN;
+					poll_fd.revents = 0;
+#ifdef _WIN32
+					if (WSAPoll(&poll_fd, 1, (int)wait_millisec) <= 0) {
+#else
+					if (poll(&poll_fd, 1, (int)wait_millisec) <= 0) {
+#endif
+						break;
+					}
+
+					uint8_t response[DNS_RESOLVER_PACKET_SIZE];
+					int length = (int)recv(fd, (char *)response, sizeof(response), 0);
+					if (length < 0) {
+						break;
+					}
+					//ID或问题不匹配的报文(如上一次超时查询的应答)继续等待
+					ret = ParseResponse(response, length, id, query_name, ip, ttl_sec);
+					if (ret >= 0) {
+						break;
+					}
+				}
+				if (ret == 0 || ret == 2) { //域名不存在或需改用其它方式解析, 不再重试
+					break;
+				}
+			}
+		}
+#ifdef _WIN32
+		closesocket(fd);
+#else
+		close(fd);
+#endif
+
+		//应答被截断(UDP放不下)或服务器出错时改用系统解析, 避免把存在的域名作为失败结果缓存
+		if (ret == 2) {
+			return QuerySystem(host_name, ttl_sec);
+		}
+		//只缓存确定的失败结果(域名不存在或没有A记录), 超时或发送失败不缓存, 避免服务器短暂不可用导致解析长时间失败
+		if (ret == 0) {
+			ttl_sec = negative_ttl_sec_;
+		} else if (ret != 1) {
+			ttl_sec = 0;
+		} else if (ttl_sec > max_ttl_sec_) {
+			ttl_sec = max_ttl_sec_;
+		}
+		return ip;
+	}
+
+	//通过getaddrinfo解析
+	std::string DnsResolver::QuerySystem(const std::string &host_name, int &ttl_sec) {
+		addrinfo hints, *res;
+		memset(&hints, 0, sizeof(addrinfo));
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_family = AF_INET;
+		int ret = getaddrinfo(host_name.c_str(), NULL, &hints, &res);
+		if (ret != 0) {
+			//只缓存域名不存在或没有地址的结果, 临时失败(如EAI_AGAIN)不缓存
+			bool is_negative = (ret == EAI_NONAME);
+#ifdef EAI_NODATA
+			is_negative = (is_negative || ret == EAI_NODATA);
+#endif
+			ttl_sec = (is_negative ? negative_ttl_sec_ : 0);
+			return "";
+		}
+
+		char ip_addr[INET_ADDRSTRLEN] = {0};
+		inet_ntop(AF_INET, (void *)&((sockaddr_in*)(res->ai_addr))->sin_addr, ip_addr, sizeof(ip_addr));
+		freeaddrinfo(res);
+
+		//getaddrinfo不返回TTL, 按最长缓存时间缓存
+		ttl_sec = max_ttl_sec_;
+		return std::string(ip_addr);
+	}
+
+	//写入缓存(缓存时间<=0时不缓存)
+	void DnsResolver::Store(const std::string &host_name, const std::string &ip, int ttl_sec) {
+		if (ttl_sec <= 0) {
+			return;
+		}
+
+		CacheShard &shard = GetShard(host_name);
+		std::lock_guard<std::mutex> guard(shard.mutex);
+		int64_t current_time = SteadyMicroTime();
+		//分片已满时先清理过期项, 仍然满时淘汰任意一项
+		if (shard.entries.size() >= DNS_RESOLVER_SHARD_MAX_SIZE && shard.entries.find(host_name) == shard.entries.end()) {
+			for (auto iter = shard.entries.begin(); iter != shard.entries.end();) {
+				if (iter->second.expire_time <= current_time) {
+					iter = shard.entries.erase(iter);
+				} else {
+					iter++;
+				}
+			}
+			if (shard.entries.size() >= DNS_RESOLVER_SHARD_MAX_SIZE) {
+				shard.entries.erase(shard.entries.begin());
+			}
+		}
+
+		CacheEntry &entry = shard.entries[host_name];
+		entry.ip = ip;
+		entry.expire_time = current_time + (int64_t)ttl_sec * 1000000;
+	}
+
+	DnsResolver::CacheShard &DnsResolver::GetShard(const std::string &host_name) {
+		return shards_[std::hash<std::string>()(host_name) % DNS_RESOLVER_SHARD_NUM];
+	}
+}
@@ -3,36 +3,220 @@
 #include <windows.h>
 #else
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <poll.h>
 #include <unistd.h>
+#include <errno.h>
+#include <string.h>
 #endif
+#include <lim/base/cpu_affinity.h>
+#include <lim/base/time_utils.h>
 #include <assert.h>
+#include <limits.h>
+#include <algorithm>
+#include <vector>
 
 namespace lim {
 	#define MAX_SOCKET_CHANNEL_NUM 1024
 	#define EVENT_TIMEOUT_MILLSEC 10
-	EventLoop::EventLoop(): is_running_(true) {
+#ifndef _WIN32
+	#define CHANNEL_SLOT_CHUNK_SIZE 4096
+	#define CHANNEL_SLOT_CHUNK_NUM 1024
+	#define WAKEUP_CHANNEL_HANDLE ((uint64_t)-1)
+#endif
+#ifdef ENABLE_IO_URING
+	#define URING_QUEUE_ENTRIES 1024
+	#define URING_BUFFER_GROUP_ID 0
+	#define URING_BUFFER_NUM 256
+	#define URING_BUFFER_SIZE 4096
+	#define URING_SEND_BUFFER_SIZE (64 * 1024)
+	#define URING_MAX_PENDING_SIZE (1024 * 1024)
+
+	//连接的完成方式
+	#define URING_MODE_RECV 0 /***普通连接: multishot recv接收到缓冲区环***/
+	#define URING_MODE_POLL 1 /***SSL连接: 只做可读/可写通知, 由SSL自行读写socket***/
+	#define URING_MODE_ACCEPT 2 /***监听连接: multishot accept***/
+
+	//提交项类型(user_data低3位, 高位为UringChannel指针)
+	#define URING_OP_RECV 1
+	#define URING_OP_SEND 2
+	#define URING_OP_POLL_IN 3
+	#define URING_OP_POLL_OUT 4
+	#define URING_OP_ACCEPT 5
+	#define URING_OP_WAKEUP 6
+	#define URING_OP_CANCEL 7
+	#define URING_OP_MASK 7
+	#define URING_RETRY_CANCEL 8 /***待重试项为取消操作***/
+
+	//投递给事件循环线程的命令
+	#define URING_COMMAND_ADD 0
+	#define URING_COMMAND_REMOVE 1
+	#define URING_COMMAND_SEND 2
+	#define URING_COMMAND_RECV 3
+	#define URING_COMMAND_READ_READY 4
+	#define URING_COMMAND_WRITE_READY 5
+	#define URING_COMMAND_RELEASE 6
+
+	//io_uring后端的连接状态
+	struct alignas(8) UringChannel {
+		int fd;
+		uint32_t generation; /***注册代数***/
+		int mode; /***完成方式***/
+		int inflight_ops; /***未完成的提交项(按op位标记,仅事件循环线程访问)***/
+		bool is_removed; /***是否已注销(仅事件循环线程访问)***/
+
+		std::mutex mutex; /***保护以下成员***/
+		std::string recv_data; /***已接收未读取的数据***/
+		size_t recv_offset;
+		const char *recv_block; /***正在分发的接收缓冲区(分发期间直接从缓冲区环读取, 未读完的部分分发后转存到recv_data)***/
+		int recv_block_size;
+		int recv_block_offset;
+		bool is_recv_closed; /***对端关闭或接收出错***/
+		bool is_recv_paused; /***未读取数据过多, 暂停接收***/
+		char *send_data; /***正在发送的数据***/
+		int send_size;
+		int send_offset;
+		bool is_sending;
+		bool is_send_error;
+		bool want_write; /***是否需要写事件通知***/
+		std::vector<int> accept_fds; /***已完成accept的句柄***/
+	};
+#endif
+	/**
+	*事件监听器构造函数
+	* @param cpu IO线程绑定的CPU(-1表示不绑定)
+	* @param backend 事件循环后端
+	*/
+	EventLoop::EventLoop(int cpu, EventLoopBackend backend): ExecuteThread(NULL, cpu, false), is_running_(true), channel_num_(0),
+		backend_(EventLoopBackend::EPOLL) {
 #ifdef _WIN32
 		FD_ZERO(&read_channel_set_);
 		FD_ZERO(&write_channel_set_);
 		max_socket_channel_ = 0;
 #else
-		fd_epoll_ = epoll_create(MAX_SOCKET_CHANNEL_NUM);
-		assert(fd_epoll_ != 0);
+#ifdef ENABLE_IO_URING
+		//内核不支持io_uring(或缓冲区环)时退回epoll
+		io_uring_ = NULL;
+		uring_post_seq_ = uring_done_seq_ = 0;
+		if (backend == EventLoopBackend::IO_URING) {
+			io_uring_ = new IoUringQueue();
+			if (io_uring_->Initialize(URING_QUEUE_ENTRIES) && 
+				io_uring_->RegisterBufferRing(URING_BUFFER_GROUP_ID, URING_BUFFER_NUM, URING_BUFFER_SIZE)) {
+				backend_ = EventLoopBackend::IO_URING;
+			} else {
+				delete io_uring_;
+				io_uring_ = NULL;
+			}
+		}
 #endif
-		io_thread_ = std::thread(&EventLoop::Run, this);
+
+		//io_uring后端通过IORING_OP_READ读取eventfd, 使用阻塞模式使内核以poll方式等待
+		fd_wakeup_ = eventfd(0, EFD_CLOEXEC | (backend_ == EventLoopBackend::EPOLL ? EFD_NONBLOCK : 0));
+		assert(fd_wakeup_ >= 0);
+
+		fd_epoll_ = -1;
+		if (backend_ == EventLoopBackend::EPOLL) {
+			fd_epoll_ = epoll_create(MAX_SOCKET_CHANNEL_NUM);
+			assert(fd_epoll_ >= 0);
+
+			struct epoll_event ev;
+			ev.data.u64 = WAKEUP_CHANNEL_HANDLE;
+			ev.events = EPOLLIN;
+			epoll_ctl(fd_epoll_, EPOLL_CTL_ADD, fd_wakeup_, &ev);
+		}
+
+		channel_slot_chunks_ = new std::atomic<ChannelSlot*>[CHANNEL_SLOT_CHUNK_NUM];
+		for (int i = 0; i < CHANNEL_SLOT_CHUNK_NUM; i++) {
+			channel_slot_chunks_[i].store(NULL);
+		}
+#endif
+		//基类不创建任务线程, 绑定在本事件循环上的任务(run-to-completion模式)及其定时器都在IO线程执行
+		io_thread_ = std::thread([this] {
+			if (cpu_ >= 0) {
+				BindCurrentThreadToCpu(cpu_);
+			}
+			Run();
+		});
 	}
 
 	EventLoop::~EventLoop() {
 		is_running_ = false;
+		Wakeup();
 		io_thread_.join();
 #ifndef _WIN32
-		close(fd_epoll_);
+		close(fd_wakeup_);
+		if (fd_epoll_ >= 0) {
+			close(fd_epoll_);
+		}
+
+#ifdef ENABLE_IO_URING
+		//先关闭io_uring(取消未完成的操作), 再释放连接状态
+		delete io_uring_;
+		for (size_t i = 0; i < uring_commands_.size(); i++) {
+			if (uring_commands_[i].first == URING_COMMAND_REMOVE || uring_commands_[i].first == URING_COMMAND_RELEASE) {
+				uring_commands_[i].second->is_removed = true;
+				uring_commands_[i].second->inflight_ops = 0;
+				ReleaseUringChannel(uring_commands_[i].second);
+			}
+		}
+#endif
+
+		for (int i = 0; i < CHANNEL_SLOT_CHUNK_NUM; i++) {
+			delete[] channel_slot_chunks_[i].load();
+		}
+		delete[] channel_slot_chunks_;
 #endif
 	}
 
-	void EventLoop::AddChannel(const SocketChannel &channel, ExecuteTask *execute_task, bool has_write_op) {
-		std::lock_guard<std::mutex> guard(mutex_);
+	//唤醒阻塞在epoll_wait上的事件循环线程(跨线程通知)
+	void EventLoop::Wakeup() {
+#ifndef _WIN32
+		uint64_t value = 1;
+		write(fd_wakeup_, &value, sizeof(value));
+#endif
+	}
+
+	//唤醒IO线程(绑定在本事件循环上的任务及定时器由IO线程执行)
+	void EventLoop::Notify() {
+		Wakeup();
+	}
+
+	//计算IO线程的等待时间(微秒): 有排队任务或定时器已到期时返回0, 没有定时器时返回-1
+	int64_t EventLoop::GetWaitTime() {
+		std::lock_guard<std::mutex> guard(ExecuteThread::mutex_);
+		if (task_que_.next != &task_que_) {
+			return 0;
+		}
+
+		int64_t next_expire_time = timer_wheel_.NextExpireTime();
+		if (next_expire_time < 0) {
+			wakeup_time_ = INT64_MAX;
+			return -1;
+		}
+
+		int64_t wait_time = next_expire_time - SteadyMicroTime();
+		if (wait_time <= 0) {
+			return 0;
+		}
+		//设置等待截止时间后, 新任务及更早到期的定时器通过eventfd唤醒
+		wakeup_time_ = next_expire_time;
+		return wait_time;
+	}
+
+	//执行排队的任务及到期的定时器(IO线程每轮事件分发后调用)
+	void EventLoop::RunPendingTasks() {
+		{
+			std::lock_guard<std::mutex> guard(ExecuteThread::mutex_);
+			SpliceTasks();
+		}
+		RunTasks();
+		RunExpiredTimers();
+	}
+
 #ifdef _WIN32
+	bool EventLoop::AddChannel(const SocketChannel &channel, ExecuteTask *execute_task, bool has_write_op) {
+		std::lock_guard<std::mutex> guard(mutex_);
 		if (channel.socket_channel_ > max_socket_channel_) {
 			max_socket_channel_ = channel.socket_channel_;
 		}
@@ -45,23 +229,12 @@ namespace lim {
 			FD_SET(channel.socket_channel_, &write_channel_set_);
 		else if (!has_write_op && FD_ISSET(channel.socket_channel_, &write_channel_set_)) 
 			FD_CLR(channel.socket_channel_, &write_channel_set_);
-#else
-		struct epoll_event ev;
-		ev.data.fd = channel.socket_channel_;
-		ev.events = EPOLLET|EPOLLIN;
-		if (has_write_op) {
-			ev.events |= EPOLLOUT;
-		}
-
-		if (channel_task_map_.find(channel.socket_channel_) == channel_task_map_.end())
-			epoll_ctl(fd_epoll_, EPOLL_CTL_ADD, channel.socket_channel_, &ev);
-		else
-			epoll_ctl(fd_epoll_, EPOLL_CTL_MOD, channel.socket_channel_, &ev);
-#endif
 
 		if (channel_task_map_.find(channel.socket_channel_) == channel_task_map_.end()) {
 			channel_task_map_.insert(std::make_pair(channel.socket_channel_, execute_task));
+			channel_num_++;
 		}
+		return true;
 	}
 
 	void EventLoop::RemoveChannel(const SocketChannel &channel) {
@@ -71,7 +244,6 @@ namespace lim {
 			return;
 		}
 		
-#ifdef _WIN32
 		if (channel.socket_channel_ == max_socket_channel_) {
 			max_socket_channel_ --;
 		}
@@ -83,13 +255,21 @@ namespace lim {
 		if (FD_ISSET(channel.socket_channel_, &write_channel_set_)) {
 			FD_CLR(channel.socket_channel_, &write_channel_set_);
 		}
-#else
-		struct epoll_event ev;
-		ev.data.fd = channel.socket_channel_;
-		ev.events = EPOLLET|EPOLLIN|EPOLLOUT;
-		epoll_ctl(fd_epoll_, EPOLL_CTL_DEL, channel.socket_channel_, &ev);
-#endif
 		channel_task_map_.erase(iter);
+		channel_num_--;
+	}
+
+	void EventLoop::UpdateChannel(const SocketChannel &channel, bool has_write_op) {
+		ExecuteTask *execute_task = NULL;
+		{
+			std::lock_guard<std::mutex> guard(mutex_);
+			auto iter = channel_task_map_.find(channel.socket_channel_);
+			if (iter == channel_task_map_.end()) {
+				return;
+			}
+			execute_task = iter->second;
+		}
+		AddChannel(channel, execute_task, has_write_op);
 	}
 
 	void EventLoop::ClearChannels() {
@@ -104,12 +284,834 @@ namespace lim {
 			iter = channel_task_map_.begin();
 		}
 	}
+#else
+	/**
+	*获取fd对应的注册槽
+	* @param fd socket句柄
+	* @param is_create 槽不存在时是否创建
+	* @return 槽不存在且不创建时返回NULL
+	*/
+	ChannelSlot *EventLoop::GetChannelSlot(int fd, bool is_create) {
+		if (fd < 0 || fd >= CHANNEL_SLOT_CHUNK_SIZE * CHANNEL_SLOT_CHUNK_NUM) {
+			return NULL;
+		}
+
+		std::atomic<ChannelSlot*> &chunk = channel_slot_chunks_[fd / CHANNEL_SLOT_CHUNK_SIZE];
+		ChannelSlot *slots = chunk.load(std::memory_order_acquire);
+		if (slots == NULL) {
+			if (!is_create) {
+				return NULL;
+			}
+
+			//块只增不减,并发创建时以CAS胜出者为准
+			ChannelSlot *new_slots = new ChannelSlot[CHANNEL_SLOT_CHUNK_SIZE];
+			for (int i = 0; i < CHANNEL_SLOT_CHUNK_SIZE; i++) {
+				new_slots[i].execute_task.store(NULL);
+				new_slots[i].generation.store(0);
+				new_slots[i].is_dispatching.store(false);
+				new_slots[i].uring_channel.store(NULL);
+				new_slots[i].has_write_op.store(false);
+			}
+
+			if (chunk.compare_exchange_strong(slots, new_slots, std::memory_order_acq_rel)) {
+				slots = new_slots;
+			} else {
+				delete[] new_slots;
+			}
+		}
+		return &slots[fd % CHANNEL_SLOT_CHUNK_SIZE];
+	}
+
+	bool EventLoop::AddChannel(const SocketChannel &channel, ExecuteTask *execute_task, bool has_write_op) {
+		//fd超出槽位范围(CHANNEL_SLOT_CHUNK_SIZE * CHANNEL_SLOT_CHUNK_NUM)时无法注册, 由调用方报告错误
+		ChannelSlot *slot = GetChannelSlot(channel.socket_channel_, true);
+		if (slot == NULL) {
+			return false;
+		}
+
+		//以CAS绑定任务, 并发注册同一fd时只有一个调用方执行首次注册, 其余按已注册处理
+		ExecuteTask *bound_task = NULL;
+		bool is_new = (execute_task != NULL && slot->execute_task.compare_exchange_strong(bound_task, execute_task));
+
+#ifdef ENABLE_IO_URING
+		if (backend_ == EventLoopBackend::IO_URING) {
+			if (is_new) {
+				UringChannel *uring_channel = new UringChannel();
+				uring_channel->fd = channel.socket_channel_;
+				uring_channel->generation = slot->generation.fetch_add(1) + 1;
+				uring_channel->mode = URING_MODE_RECV;
+#ifdef ENABLE_OPENSSL
+				if (channel.ssl_context_ != NULL) {
+					uring_channel->mode = URING_MODE_POLL;
+				}
+#endif
+				int is_listen = 0;
+				socklen_t length = sizeof(is_listen);
+				if (getsockopt(channel.socket_channel_, SOL_SOCKET, SO_ACCEPTCONN, &is_listen, &length) == 0 && is_listen) {
+					uring_channel->mode = URING_MODE_ACCEPT;
+				}
+				uring_channel->inflight_ops = 0;
+				uring_channel->is_removed = false;
+				uring_channel->recv_offset = 0;
+				uring_channel->recv_block = NULL;
+				uring_channel->recv_block_size = uring_channel->recv_block_offset = 0;
+				uring_channel->is_recv_closed = false;
+				uring_channel->is_recv_paused = false;
+				uring_channel->send_data = NULL;
+				uring_channel->send_size = uring_channel->send_offset = 0;
+				uring_channel->is_sending = false;
+				uring_channel->is_send_error = false;
+				uring_channel->want_write = has_write_op;
+
+				slot->uring_channel.store(uring_channel);
+				channel_num_++;
+				PostUringCommand(URING_COMMAND_ADD, uring_channel);
+			} else {
+				UringChannel *uring_channel = slot->uring_channel.load();
+				if (uring_channel == NULL) {
+					return false;
+				}
+
+				bool is_write_ready = false;
+				{
+					std::lock_guard<std::mutex> guard(uring_channel->mutex);
+					uring_channel->want_write = has_write_op;
+					is_write_ready = has_write_op && (uring_channel->mode == URING_MODE_POLL || !uring_channel->is_sending);
+				}
+				if (is_write_ready) {
+					PostUringCommand(URING_COMMAND_WRITE_READY, uring_channel);
+				}
+			}
+			return true;
+		}
+#endif
+
+		struct epoll_event ev;
+		ev.events = EPOLLET|EPOLLIN;
+		if (has_write_op) {
+			ev.events |= EPOLLOUT;
+		}
+
+		slot->has_write_op.store(has_write_op);
+		if (is_new) {
+			uint64_t generation = slot->generation.fetch_add(1) + 1;
+			ev.data.u64 = (generation << 32) | (uint32_t)channel.socket_channel_;
+			if (epoll_ctl(fd_epoll_, EPOLL_CTL_ADD, channel.socket_channel_, &ev) != 0) {
+				slot->execute_task.store(NULL);
+				return false;
+			}
+			channel_num_++;
+		} else {
+			uint64_t generation = slot->generation.load();
+			ev.data.u64 = (generation << 32) | (uint32_t)channel.socket_channel_;
+			epoll_ctl(fd_epoll_, EPOLL_CTL_MOD, channel.socket_channel_, &ev);
+		}
+		return true;
+	}
+
+	void EventLoop::UpdateChannel(const SocketChannel &channel, bool has_write_op) {
+		ChannelSlot *slot = GetChannelSlot(channel.socket_channel_, false);
+		if (slot == NULL || slot->execute_task.load() == NULL) {
+			return;
+		}
+
+#ifdef ENABLE_IO_URING
+		if (backend_ == EventLoopBackend::IO_URING) {
+			AddChannel(channel, NULL, has_write_op);
+			return;
+		}
+#endif
+		//写事件监听状态不变时不需要epoll_ctl
+		if (slot->has_write_op.exchange(has_write_op) == has_write_op) {
+			return;
+		}
+
+		struct epoll_event ev;
+		ev.events = EPOLLET|EPOLLIN;
+		if (has_write_op) {
+			ev.events |= EPOLLOUT;
+		}
+		uint64_t generation = slot->generation.load();
+		ev.data.u64 = (generation << 32) | (uint32_t)channel.socket_channel_;
+		epoll_ctl(fd_epoll_, EPOLL_CTL_MOD, channel.socket_channel_, &ev);
+	}
+
+	void EventLoop::RemoveChannel(const SocketChannel &channel) {
+		ChannelSlot *slot = GetChannelSlot(channel.socket_channel_, false);
+		if (slot == NULL || slot->execute_task.load() == NULL) {
+			return;
+		}
+		
+#ifdef ENABLE_IO_URING
+		if (backend_ == EventLoopBackend::IO_URING) {
+			//调用方随后会关闭fd, 需等待事件循环线程把已排队的提交项及取消请求交给内核
+			//连接状态在所有操作完成后由事件循环线程释放
+			UringChannel *uring_channel = slot->uring_channel.exchange(NULL);
+			if (uring_channel != NULL) {
+				if (std::this_thread::get_id() == io_thread_.get_id()) {
+					RemoveUringChannel(uring_channel);
+					PostUringCommand(URING_COMMAND_RELEASE, uring_channel);
+				} else {
+					uint64_t seq = PostUringCommand(URING_COMMAND_REMOVE, uring_channel);
+					std::unique_lock<std::mutex> lock(uring_mutex_);
+					uring_cond_.wait(lock, [this, seq] { return uring_done_seq_ >= seq; });
+				}
+			}
+		} else
+#endif
+		{
+			struct epoll_event ev;
+			ev.data.u64 = 0;
+			ev.events = EPOLLET|EPOLLIN|EPOLLOUT;
+			epoll_ctl(fd_epoll_, EPOLL_CTL_DEL, channel.socket_channel_, &ev);
+		}
+
+		slot->generation.fetch_add(1);
+		if (slot->execute_task.exchange(NULL) != NULL) {
+			channel_num_--;
+		}
+
+		//等待事件循环线程结束对该槽的分发,之后任务对象才可以安全释放
+		if (std::this_thread::get_id() != io_thread_.get_id()) {
+			while (slot->is_dispatching.load()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void EventLoop::ClearChannels() {
+		for (int i = 0; i < CHANNEL_SLOT_CHUNK_NUM; i++) {
+			ChannelSlot *slots = channel_slot_chunks_[i].load();
+			if (slots == NULL) {
+				continue;
+			}
+
+			for (int j = 0; j < CHANNEL_SLOT_CHUNK_SIZE; j++) {
+#ifdef ENABLE_IO_URING
+				//io_uring关闭后在析构函数中释放
+				UringChannel *uring_channel = slots[j].uring_channel.exchange(NULL);
+				if (uring_channel != NULL) {
+					std::lock_guard<std::mutex> guard(uring_mutex_);
+					uring_commands_.push_back(std::make_pair(URING_COMMAND_REMOVE, uring_channel));
+				}
+#endif
+				ExecuteTask *execute_task = slots[j].execute_task.exchange(NULL);
+				if (execute_task == NULL) {
+					continue;
+				}
+
+				SocketChannel channel(i * CHANNEL_SLOT_CHUNK_SIZE + j);
+				delete execute_task;
+				channel.Close();
+			}
+		}
+	}
+
+	//分发事件(channel_handle为generation<<32|fd)
+	void EventLoop::DispatchEvent(uint64_t channel_handle, int execute_events) {
+		ChannelSlot *slot = GetChannelSlot((int)(channel_handle & 0xFFFFFFFF), false);
+		if (slot == NULL) {
+			return;
+		}
+
+		slot->is_dispatching.store(true);
+		ExecuteTask *execute_task = slot->execute_task.load();
+		//代数不一致说明fd已被注销或复用,丢弃旧事件
+		if (execute_task != NULL && slot->generation.load() == (uint32_t)(channel_handle >> 32)) {
+			//任务绑定在本事件循环上(run-to-completion模式)时直接在IO线程执行, 否则转交工作线程
+			if (&execute_task->GetExecuteThread() == this) {
+				RunInline(execute_task, execute_events);
+			} else {
+				execute_task->Signal(execute_events);
+			}
+		}
+		slot->is_dispatching.store(false);
+	}
+#endif
 	
+#ifdef ENABLE_IO_URING
+	//将已接收的数据直接拷贝到接收缓冲区的预留空间(受缓冲区剩余容量限制), 返回拷贝的字节数
+	static int CopyRecvData(ByteBuffer &buffer, const char *data, int length) {
+		length = (length < buffer.WritableBytes() ? length : buffer.WritableBytes());
+		int writable_size = 0;
+		char *writable_data = (length > 0 ? buffer.ReserveWritable(length, writable_size) : NULL);
+		if (writable_data == NULL) {
+			return 0;
+		}
+		memcpy(writable_data, data, length);
+		buffer.CommitWrite(length);
+		return length;
+	}
+
+#endif
+	/**
+	*读取连接数据(io_uring后端从已完成的接收数据中读取, epoll后端直接读socket)
+	* @param channel 已注册的连接
+	* @param buffer 接收缓冲区
+	* @return 连接关闭或出错返回-1, 否则返回读取的字节数
+	*/
+	int EventLoop::ReadBytes(SocketChannel &channel, ByteBuffer &buffer) {
+#ifdef ENABLE_IO_URING
+		ChannelSlot *slot = (backend_ == EventLoopBackend::IO_URING ? GetChannelSlot(channel.socket_channel_, false) : NULL);
+		UringChannel *uring_channel = (slot != NULL ? slot->uring_channel.load() : NULL);
+		if (uring_channel != NULL && uring_channel->mode == URING_MODE_RECV) {
+			int read_length = 0;
+			bool is_resume = false, is_closed = false;
+			{
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				//先读正在分发的接收缓冲区(此时recv_data为空), 再读转存的数据
+				int block_length = uring_channel->recv_block_size - uring_channel->recv_block_offset;
+				if (block_length > 0) {
+					int length = CopyRecvData(buffer, uring_channel->recv_block + uring_channel->recv_block_offset, block_length);
+					uring_channel->recv_block_offset += length;
+					block_length -= length;
+					read_length += length;
+				}
+
+				int pending_length = (int)(uring_channel->recv_data.size() - uring_channel->recv_offset);
+				int length = CopyRecvData(buffer, uring_channel->recv_data.data() + uring_channel->recv_offset, pending_length);
+				uring_channel->recv_offset += length;
+				pending_length -= length;
+				read_length += length;
+
+				if (pending_length == 0) {
+					uring_channel->recv_data.clear();
+					uring_channel->recv_offset = 0;
+				} else if (uring_channel->recv_offset > uring_channel->recv_data.size() / 2) {
+					uring_channel->recv_data.erase(0, uring_channel->recv_offset);
+					uring_channel->recv_offset = 0;
+				}
+				pending_length += block_length;
+
+				if (pending_length == 0 && uring_channel->is_recv_closed) {
+					if (read_length == 0) {
+						return -1;
+					}
+					//数据读完后再次通知读事件以报告连接关闭
+					is_closed = true;
+				}
+
+				if (uring_channel->is_recv_paused && pending_length < URING_MAX_PENDING_SIZE / 2) {
+					uring_channel->is_recv_paused = false;
+					is_resume = true;
+				}
+			}
+
+			if (is_resume) {
+				PostUringCommand(URING_COMMAND_RECV, uring_channel);
+			}
+			if (is_closed) {
+				PostUringCommand(URING_COMMAND_READ_READY, uring_channel);
+			}
+			return read_length;
+		}
+#endif
+		return channel.ReadBytes(buffer);
+	}
+
+	/**
+	*发送连接数据(io_uring后端提交异步发送, 上一次发送完成前返回0, 完成后触发写事件)
+	* @param channel 已注册的连接
+	* @param buffer 发送缓冲区(epoll后端按组件聚集写)
+	* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+	*/
+	int EventLoop::WriteBytes(SocketChannel &channel, CompositeByteBuffer &buffer) {
+		CompositeByteBuffer *buffers[1] = { &buffer };
+		return WriteBytes(channel, buffers, 1);
+	}
+
+	/**
+	*按顺序发送多个缓冲区的数据(epoll后端一次系统调用聚集写, io_uring后端合并提交)
+	* @param channel 已注册的连接
+	* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+	* @param buffer_num 缓冲区个数
+	* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+	*/
+	int EventLoop::WriteBytes(SocketChannel &channel, CompositeByteBuffer **buffers, int buffer_num) {
+#ifdef ENABLE_IO_URING
+		ChannelSlot *slot = (backend_ == EventLoopBackend::IO_URING ? GetChannelSlot(channel.socket_channel_, false) : NULL);
+		UringChannel *uring_channel = (slot != NULL ? slot->uring_channel.load() : NULL);
+		if (uring_channel != NULL && uring_channel->mode == URING_MODE_RECV) {
+			return SubmitUringSend(uring_channel, buffers, buffer_num, NULL);
+		}
+#endif
+		return channel.WriteBytes(buffers, buffer_num);
+	}
+
+	/**
+	*发送文件区域(epoll后端由sendfile直接发送, io_uring后端读取到连接的发送区后提交)
+	* @param channel 已注册的连接
+	* @param region 文件区域, 按发送的字节数消费
+	* @return 连接关闭或出错返回-1, 否则返回发送(提交)的字节数
+	*/
+	int64_t EventLoop::WriteFile(SocketChannel &channel, FileRegion &region) {
+#ifdef ENABLE_IO_URING
+		ChannelSlot *slot = (backend_ == EventLoopBackend::IO_URING ? GetChannelSlot(channel.socket_channel_, false) : NULL);
+		UringChannel *uring_channel = (slot != NULL ? slot->uring_channel.load() : NULL);
+		if (uring_channel != NULL && uring_channel->mode == URING_MODE_RECV) {
+			return SubmitUringSend(uring_channel, NULL, 0, &region);
+		}
+#endif
+		return channel.WriteFile(region);
+	}
+
+	//接收新连接(io_uring后端从已完成的accept中获取)
+	void EventLoop::Accept(SocketChannel &channel, std::vector<SocketChannel> &socket_channels) {
+#ifdef ENABLE_IO_URING
+		ChannelSlot *slot = (backend_ == EventLoopBackend::IO_URING ? GetChannelSlot(channel.socket_channel_, false) : NULL);
+		UringChannel *uring_channel = (slot != NULL ? slot->uring_channel.load() : NULL);
+		if (uring_channel != NULL && uring_channel->mode == URING_MODE_ACCEPT) {
+			std::vector<int> accept_fds;
+			{
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				accept_fds.swap(uring_channel->accept_fds);
+			}
+
+			for (size_t i = 0; i < accept_fds.size(); i++) {
+				socket_channels.push_back(channel.AcceptedChannel(accept_fds[i]));
+			}
+			return;
+		}
+#endif
+		channel.Accept(socket_channels);
+	}
+
+#ifdef ENABLE_IO_URING
+	//投递命令到事件循环线程(提交队列只由事件循环线程访问)
+	uint64_t EventLoop::PostUringCommand(int command, UringChannel *uring_channel) {
+		bool is_wakeup = false;
+		uint64_t seq = 0;
+		{
+			std::lock_guard<std::mutex> guard(uring_mutex_);
+			//队列非空时事件循环线程已被唤醒或将在阻塞前处理
+			is_wakeup = uring_commands_.empty() && std::this_thread::get_id() != io_thread_.get_id();
+			uring_commands_.push_back(std::make_pair(command, uring_channel));
+			seq = ++uring_post_seq_;
+		}
+
+		if (is_wakeup) {
+			Wakeup();
+		}
+		return seq;
+	}
+
+	void EventLoop::ProcessUringCommands() {
+		std::vector<std::pair<int, UringChannel*>> commands;
+		uint64_t seq = 0;
+		{
+			std::lock_guard<std::mutex> guard(uring_mutex_);
+			commands.swap(uring_commands_);
+			seq = uring_post_seq_;
+		}
+
+		for (size_t i = 0; i < commands.size(); i++) {
+			int command = commands[i].first;
+			UringChannel *uring_channel = commands[i].second;
+			uint64_t channel_handle = ((uint64_t)uring_channel->generation << 32) | (uint32_t)uring_channel->fd;
+			if (command == URING_COMMAND_REMOVE) {
+				RemoveUringChannel(uring_channel);
+				ReleaseUringChannel(uring_channel);
+				continue;
+			} else if (command == URING_COMMAND_RELEASE) {
+				ReleaseUringChannel(uring_channel);
+				continue;
+			}
+
+			if (uring_channel->is_removed) {
+				continue;
+			}
+
+			if (command == URING_COMMAND_ADD) {
+				if (uring_channel->mode == URING_MODE_RECV) {
+					SubmitUringOp(uring_channel, URING_OP_RECV);
+				} else if (uring_channel->mode == URING_MODE_POLL) {
+					SubmitUringOp(uring_channel, URING_OP_POLL_IN);
+				} else {
+					SubmitUringOp(uring_channel, URING_OP_ACCEPT);
+				}
+
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				if (!uring_channel->want_write) {
+					continue;
+				}
+				command = URING_COMMAND_WRITE_READY;
+			}
+
+			if (command == URING_COMMAND_SEND) {
+				SubmitUringOp(uring_channel, URING_OP_SEND);
+			} else if (command == URING_COMMAND_RECV) {
+				bool is_recv = false;
+				{
+					std::lock_guard<std::mutex> guard(uring_channel->mutex);
+					is_recv = !uring_channel->is_recv_paused && !uring_channel->is_recv_closed;
+				}
+				if (is_recv && !(uring_channel->inflight_ops & (1 << URING_OP_RECV))) {
+					SubmitUringOp(uring_channel, URING_OP_RECV);
+				}
+			} else if (command == URING_COMMAND_READ_READY) {
+				DispatchEvent(channel_handle, ExecuteEvent::READ_EVENT);
+			} else if (command == URING_COMMAND_WRITE_READY) {
+				if (uring_channel->mode == URING_MODE_POLL) {
+					if (!(uring_channel->inflight_ops & (1 << URING_OP_POLL_OUT))) {
+						SubmitUringOp(uring_channel, URING_OP_POLL_OUT);
+					}
+				} else if (uring_channel->mode == URING_MODE_RECV) {
+					bool is_write_ready = false;
+					{
+						std::lock_guard<std::mutex> guard(uring_channel->mutex);
+						is_write_ready = uring_channel->want_write && !uring_channel->is_sending;
+					}
+					if (is_write_ready) {
+						DispatchEvent(channel_handle, ExecuteEvent::WRITE_EVENT);
+					}
+				}
+			}
+		}
+
+		if (!commands.empty()) {
+			std::lock_guard<std::mutex> guard(uring_mutex_);
+			uring_done_seq_ = seq;
+			uring_cond_.notify_all();
+		}
+	}
+
+	//标记注销并取消未完成的操作, 返回前已提交给内核(之后可以安全关闭fd)
+	void EventLoop::RemoveUringChannel(UringChannel *uring_channel) {
+		uring_channel->is_removed = true;
+		//已提交的发送继续完成(内核持有文件引用), 其余操作取消
+		for (int op = URING_OP_RECV; op <= URING_OP_ACCEPT; op++) {
+			if (op != URING_OP_SEND && (uring_channel->inflight_ops & (1 << op))) {
+				SubmitUringCancel(uring_channel, op);
+			}
+		}
+		io_uring_->Submit(0);
+	}
+
+	//提交操作, 提交队列满时加入重试列表(保留op标记, 连接在重试提交前不会被释放)
+	void EventLoop::SubmitUringOp(UringChannel *uring_channel, int op) {
+		uring_channel->inflight_ops |= (1 << op);
+		struct io_uring_sqe *sqe = io_uring_->GetSqe();
+		if (sqe == NULL) {
+			uring_retry_ops_.push_back(std::make_pair(uring_channel, op));
+			return;
+		}
+
+		sqe->fd = uring_channel->fd;
+		sqe->user_data = (uint64_t)(uintptr_t)uring_channel | op;
+		if (op == URING_OP_RECV) {
+			//multishot接收, 由内核从缓冲区环中选择缓冲区
+			sqe->opcode = IORING_OP_RECV;
+			sqe->ioprio = IORING_RECV_MULTISHOT;
+			sqe->flags = IOSQE_BUFFER_SELECT;
+			sqe->buf_group = URING_BUFFER_GROUP_ID;
+		} else if (op == URING_OP_SEND) {
+			std::lock_guard<std::mutex> guard(uring_channel->mutex);
+			sqe->opcode = IORING_OP_SEND;
+			sqe->addr = (uint64_t)(uintptr_t)(uring_channel->send_data + uring_channel->send_offset);
+			sqe->len = uring_channel->send_size - uring_channel->send_offset;
+			sqe->msg_flags = MSG_NOSIGNAL;
+		} else if (op == URING_OP_POLL_IN) {
+			sqe->opcode = IORING_OP_POLL_ADD;
+			sqe->poll32_events = POLLIN|POLLRDHUP;
+			sqe->len = IORING_POLL_ADD_MULTI;
+		} else if (op == URING_OP_POLL_OUT) {
+			sqe->opcode = IORING_OP_POLL_ADD;
+			sqe->poll32_events = POLLOUT;
+		} else if (op == URING_OP_ACCEPT) {
+			sqe->opcode = IORING_OP_ACCEPT;
+			sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+			sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+		}
+	}
+
+	void EventLoop::SubmitUringCancel(UringChannel *uring_channel, int op) {
+		struct io_uring_sqe *sqe = io_uring_->GetSqe();
+		if (sqe == NULL) {
+			uring_retry_ops_.push_back(std::make_pair(uring_channel, op | URING_RETRY_CANCEL));
+			return;
+		}
+
+		sqe->opcode = IORING_OP_ASYNC_CANCEL;
+		sqe->fd = -1;
+		sqe->addr = (uint64_t)(uintptr_t)uring_channel | op;
+		sqe->user_data = URING_OP_CANCEL;
+	}
+
+	void EventLoop::SubmitUringWakeup() {
+		struct io_uring_sqe *sqe = io_uring_->GetSqe();
+		if (sqe == NULL) {
+			uring_retry_ops_.push_back(std::make_pair((UringChannel*)NULL, URING_OP_WAKEUP));
+			return;
+		}
+
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = fd_wakeup_;
+		sqe->addr = (uint64_t)(uintptr_t)&wakeup_value_;
+		sqe->len = sizeof(wakeup_value_);
+		sqe->user_data = URING_OP_WAKEUP;
+	}
+
+	//重新提交因提交队列满而未能提交的操作(完成队列处理后调用)
+	void EventLoop::RetryUringOps() {
+		std::vector<std::pair<UringChannel*, int>> retry_ops;
+		retry_ops.swap(uring_retry_ops_);
+		for (size_t i = 0; i < retry_ops.size(); i++) {
+			UringChannel *uring_channel = retry_ops[i].first;
+			int op = retry_ops[i].second;
+			if (op == URING_OP_WAKEUP) {
+				SubmitUringWakeup();
+			} else if (op & URING_RETRY_CANCEL) {
+				SubmitUringCancel(uring_channel, op & URING_OP_MASK);
+			} else if (uring_channel->is_removed) {
+				//连接已注销, 操作不再提交
+				uring_channel->inflight_ops &= ~(1 << op);
+				ReleaseUringChannel(uring_channel);
+			} else {
+				SubmitUringOp(uring_channel, op);
+			}
+		}
+	}
+
+	/**
+	*拷贝待发送数据到连接的发送区并提交发送(上一次发送完成前返回0)
+	* @param buffers 发送缓冲区数组(按顺序拷贝)
+	* @param buffer_num 缓冲区个数
+	* @param region 缓冲区之后发送的文件区域(可为NULL)
+	* @return 出错返回-1, 否则返回提交的字节数
+	*/
+	int EventLoop::SubmitUringSend(UringChannel *uring_channel, CompositeByteBuffer **buffers, int buffer_num, FileRegion *region) {
+		int write_length = 0;
+		{
+			std::lock_guard<std::mutex> guard(uring_channel->mutex);
+			if (uring_channel->is_send_error) {
+				return -1;
+			}
+
+			if (uring_channel->is_sending) {
+				return 0;
+			}
+
+			if (uring_channel->send_data == NULL) {
+				uring_channel->send_data = new char[URING_SEND_BUFFER_SIZE];
+			}
+			//提交的发送数据在完成前必须保持有效, 各缓冲区及文件按顺序拷贝到连接的发送区
+			for (int i = 0; i < buffer_num && write_length < URING_SEND_BUFFER_SIZE; i++) {
+				write_length += buffers[i]->ReadBytes(uring_channel->send_data + write_length, URING_SEND_BUFFER_SIZE - write_length);
+			}
+			if (region != NULL && write_length < URING_SEND_BUFFER_SIZE) {
+				int read_length = region->ReadBytes(uring_channel->send_data + write_length, URING_SEND_BUFFER_SIZE - write_length);
+				if (read_length == -1 && write_length == 0) { //文件被截断或读取出错
+					return -1;
+				}
+				write_length += (read_length > 0 ? read_length : 0);
+			}
+			if (write_length <= 0) {
+				return 0;
+			}
+			uring_channel->send_size = write_length;
+			uring_channel->send_offset = 0;
+			uring_channel->is_sending = true;
+		}
+		//run-to-completion模式下在事件循环线程内直接提交, 保证随后注销连接时发送已交给内核
+		if (std::this_thread::get_id() == io_thread_.get_id()) {
+			SubmitUringOp(uring_channel, URING_OP_SEND);
+		} else {
+			PostUringCommand(URING_COMMAND_SEND, uring_channel);
+		}
+		return write_length;
+	}
+
+	//连接已注销且没有未完成的操作时释放
+	void EventLoop::ReleaseUringChannel(UringChannel *uring_channel) {
+		if (!uring_channel->is_removed || uring_channel->inflight_ops != 0) {
+			return;
+		}
+
+		for (size_t i = 0; i < uring_channel->accept_fds.size(); i++) {
+			close(uring_channel->accept_fds[i]);
+		}
+		delete[] uring_channel->send_data;
+		delete uring_channel;
+	}
+
+	void EventLoop::HandleUringCompletion(struct io_uring_cqe *cqe) {
+		int op = (int)(cqe->user_data & URING_OP_MASK);
+		if (op == URING_OP_CANCEL) {
+			return;
+		} else if (op == URING_OP_WAKEUP) {
+			//命令在下一轮循环开始时处理
+			SubmitUringWakeup();
+			return;
+		}
+
+		UringChannel *uring_channel = (UringChannel*)(uintptr_t)(cqe->user_data & ~(uint64_t)URING_OP_MASK);
+		bool has_more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+		int buffer_id = ((cqe->flags & IORING_CQE_F_BUFFER) ? (int)(cqe->flags >> IORING_CQE_BUFFER_SHIFT) : -1);
+		if (!has_more) {
+			uring_channel->inflight_ops &= ~(1 << op);
+		}
+
+		if (uring_channel->is_removed) {
+			if (buffer_id >= 0) {
+				io_uring_->RecycleBuffer(buffer_id);
+			}
+			if (op == URING_OP_ACCEPT && cqe->res >= 0) {
+				close(cqe->res);
+			}
+			ReleaseUringChannel(uring_channel);
+			return;
+		}
+
+		uint64_t channel_handle = ((uint64_t)uring_channel->generation << 32) | (uint32_t)uring_channel->fd;
+		if (op == URING_OP_RECV) {
+			bool is_closed = false, is_block = false;
+			{
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				if (cqe->res > 0 && buffer_id >= 0) {
+					//没有转存数据时分发期间直接从缓冲区环读取, 数据只拷贝一次到会话的接收缓存
+					if (uring_channel->recv_data.size() == uring_channel->recv_offset) {
+						uring_channel->recv_data.clear();
+						uring_channel->recv_offset = 0;
+						uring_channel->recv_block = io_uring_->GetBuffer(buffer_id);
+						uring_channel->recv_block_size = cqe->res;
+						uring_channel->recv_block_offset = 0;
+						is_block = true;
+					} else {
+						uring_channel->recv_data.append(io_uring_->GetBuffer(buffer_id), cqe->res);
+					}
+				} else if (cqe->res == 0 || (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -ECANCELED)) {
+					uring_channel->is_recv_closed = is_closed = true;
+				}
+			}
+
+			//run-to-completion模式下会话在本线程内执行并读取
+			if (cqe->res > 0 || is_closed) {
+				DispatchEvent(channel_handle, ExecuteEvent::READ_EVENT);
+			}
+
+			bool is_paused = false, is_recv = false;
+			{
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				//未读完的部分转存后才能归还缓冲区
+				if (is_block) {
+					uring_channel->recv_data.append(uring_channel->recv_block + uring_channel->recv_block_offset,
+						uring_channel->recv_block_size - uring_channel->recv_block_offset);
+					uring_channel->recv_block = NULL;
+					uring_channel->recv_block_size = uring_channel->recv_block_offset = 0;
+				}
+				//未读取数据过多时暂停接收, 读取后恢复
+				if (!uring_channel->is_recv_paused && uring_channel->recv_data.size() - uring_channel->recv_offset > URING_MAX_PENDING_SIZE) {
+					uring_channel->is_recv_paused = is_paused = true;
+				}
+				is_recv = !has_more && !uring_channel->is_recv_paused && !uring_channel->is_recv_closed;
+			}
+
+			if (buffer_id >= 0) {
+				io_uring_->RecycleBuffer(buffer_id);
+			}
+			//分发期间连接可能已在本线程注销
+			if (!uring_channel->is_removed) {
+				if (is_paused && has_more) {
+					SubmitUringCancel(uring_channel, URING_OP_RECV);
+				}
+				//multishot接收结束(缓冲区耗尽等)时重新提交
+				if (is_recv) {
+					SubmitUringOp(uring_channel, URING_OP_RECV);
+				}
+			}
+		} else if (op == URING_OP_SEND) {
+			bool is_resend = false, is_write_ready = false;
+			{
+				std::lock_guard<std::mutex> guard(uring_channel->mutex);
+				if (cqe->res > 0) {
+					uring_channel->send_offset += cqe->res;
+					if (uring_channel->send_offset < uring_channel->send_size) {
+						is_resend = true;
+					} else {
+						uring_channel->is_sending = false;
+						is_write_ready = uring_channel->want_write;
+					}
+				} else {
+					uring_channel->is_send_error = true;
+					uring_channel->is_sending = false;
+					is_write_ready = true;
+				}
+			}
+
+			if (is_resend) {
+				SubmitUringOp(uring_channel, URING_OP_SEND);
+			}
+			if (is_write_ready) {
+				DispatchEvent(channel_handle, ExecuteEvent::WRITE_EVENT);
+			}
+		} else if (op == URING_OP_POLL_IN) {
+			if (!has_more && cqe->res >= 0) {
+				SubmitUringOp(uring_channel, URING_OP_POLL_IN);
+			}
+			DispatchEvent(channel_handle, ExecuteEvent::READ_EVENT);
+		} else if (op == URING_OP_POLL_OUT) {
+			DispatchEvent(channel_handle, ExecuteEvent::WRITE_EVENT);
+		} else if (op == URING_OP_ACCEPT) {
+			if (cqe->res >= 0) {
+				{
+					std::lock_guard<std::mutex> guard(uring_channel->mutex);
+					uring_channel->accept_fds.push_back(cqe->res);
+				}
+				DispatchEvent(channel_handle, ExecuteEvent::READ_EVENT);
+			}
+			//句柄耗尽时停止accept, 避免空转
+			if (!has_more && cqe->res != -EMFILE && cqe->res != -ENFILE) {
+				SubmitUringOp(uring_channel, URING_OP_ACCEPT);
+			}
+		}
+	}
+
+	//io_uring事件循环: 每轮一次系统调用完成批量提交及等待
+	void EventLoop::RunUring() {
+		SubmitUringWakeup();
+		while (is_running_) {
+			ProcessUringCommands();
+
+			bool has_command = !uring_retry_ops_.empty();
+			{
+				std::lock_guard<std::mutex> guard(uring_mutex_);
+				has_command = has_command || !uring_commands_.empty();
+			}
+
+			//有待处理的命令或任务时不等待, 否则等待到有完成事件或最近的定时器到期
+			int64_t wait_time = (has_command ? 0 : GetWaitTime());
+			int ret = io_uring_->Submit((wait_time == 0 ? 0 : 1), wait_time);
+			wakeup_time_ = -1;
+			if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY && ret != -ETIME) {
+				break;
+			}
+
+			struct io_uring_cqe *cqe = NULL;
+			while ((cqe = io_uring_->PeekCqe()) != NULL) {
+				//先复制再标记完成, 处理过程中可以继续提交
+				struct io_uring_cqe completion = *cqe;
+				io_uring_->SeenCqe();
+				HandleUringCompletion(&completion);
+			}
+			//完成队列处理后提交队列已有空间
+			RetryUringOps();
+			RunPendingTasks();
+		}
+
+		//事件循环已退出, 不再等待命令处理
+		std::lock_guard<std::mutex> guard(uring_mutex_);
+		uring_done_seq_ = UINT64_MAX;
+		uring_cond_.notify_all();
+	}
+#endif
+
 	void EventLoop::Run() {
 #ifdef _WIN32
 		int max_socket_channel;
 		fd_set read_channel_set, write_channel_set;
 		while (is_running_) {
+			//select轮询期间不能被唤醒, 排队的任务及到期的定时器在每轮开始时执行
+			RunPendingTasks();
 			{
 				std::lock_guard<std::mutex> guard(mutex_);
 				max_socket_channel = max_socket_channel_;
@@ -139,43 +1141,59 @@ namespace lim {
 			}
 		}
 #else
-		struct epoll_event events[MAX_SOCKET_CHANNEL_NUM];
+#ifdef ENABLE_IO_URING
+		if (backend_ == EventLoopBackend::IO_URING) {
+			RunUring();
+			ClearChannels();
+			DestroyTasks();
+			return;
+		}
+#endif
+
+		//在IO线程(已绑定CPU)中分配并首次访问, 保证事件数组位于本地NUMA节点
+		std::vector<struct epoll_event> events(MAX_SOCKET_CHANNEL_NUM);
 		while (is_running_) {
-			int num = epoll_wait(fd_epoll_, events, MAX_SOCKET_CHANNEL_NUM, EVENT_TIMEOUT_MILLSEC);
+			//阻塞到有事件或最近的定时器到期(向上取整到毫秒),退出、新任务及跨线程通知由eventfd唤醒
+			int64_t wait_time = GetWaitTime();
+			int timeout = (wait_time < 0 ? -1 : (int)std::min<int64_t>((wait_time + 999) / 1000, INT_MAX));
+			int num = epoll_wait(fd_epoll_, events.data(), MAX_SOCKET_CHANNEL_NUM, timeout);
+			wakeup_time_ = -1;
 			for (int i = 0; i < num; i++) {
-				if (!(events[i].events & EPOLLIN) && !(events[i].events & EPOLLOUT)) {
-					continue;
-				}
-	
-				std::lock_guard<std::mutex> guard(mutex_);
-				auto iter = channel_task_map_.find(events[i].data.fd);
-				if (iter == channel_task_map_.end()) {
-					struct epoll_event ev;
-					ev.data.fd = events[i].data.fd;
-					ev.events = EPOLLIN | EPOLLOUT;
-					epoll_ctl(fd_epoll_, EPOLL_CTL_DEL, events[i].data.fd, &ev);
+				if (events[i].data.u64 == WAKEUP_CHANNEL_HANDLE) {
+					uint64_t value;
+					read(fd_wakeup_, &value, sizeof(value));
 					continue;
 				}
 
 				int execute_events = ExecuteEvent::NONE_EVENT;
-				ExecuteTask *execute_task = iter->second;
 				if (events[i].events & EPOLLIN)
 					execute_events |= ExecuteEvent::READ_EVENT;
-				if (events[i].events & EPOLLOUT)
+				//错误队列中的零拷贝完成通知由写事件处理
+				if (events[i].events & (EPOLLOUT|EPOLLERR))
 					execute_events |= ExecuteEvent::WRITE_EVENT;
-				
+
 				if (execute_events != ExecuteEvent::NONE_EVENT) {
-					//printf("event: %d\n", execute_events);
-					execute_task->Signal(execute_events);
+					DispatchEvent(events[i].data.u64, execute_events);
 				}
 			}
+			RunPendingTasks();
 		}
 #endif		
 		ClearChannels();
+		DestroyTasks();
 	}
 
-	EventLoopGroup::EventLoopGroup(int event_loop_num): 
-		event_loop_num_(event_loop_num), event_loop_index_(0) {
+	/**
+	*事件监听器组构造函数
+	* @param event_loop_num 事件监听器数(小于等于0时为CPU核数)
+	* @param policy_type 事件监听器选择策略
+	* @param cpu_list 绑定的CPU列表(第i个事件监听器绑定到第i%size个CPU,为空时不绑定)
+	* @param backend 事件循环后端
+	*/
+	EventLoopGroup::EventLoopGroup(int event_loop_num, SelectPolicyType policy_type, const std::vector<int> &cpu_list,
+		EventLoopBackend backend): 
+		event_loop_num_(event_loop_num) {
+		select_policy_ = SelectPolicy::CreatePolicy(policy_type);
 		if (event_loop_num_ <= 0) {
 			event_loop_num_ = std::thread::hardware_concurrency();
 		}
@@ -184,7 +1202,8 @@ namespace lim {
 		assert(event_loops_);
 
 		for (int i = 0; i < event_loop_num_; i++) {
-			event_loops_[i] = new EventLoop();
+			int cpu = (cpu_list.size() > 0 ? cpu_list[i % cpu_list.size()] : -1);
+			event_loops_[i] = new EventLoop(cpu, backend);
 			assert(event_loops_[i]);
 		}
 	}
@@ -195,13 +1214,14 @@ namespace lim {
 			event_loops_[i] = NULL;
 		}
 		delete[]event_loops_;
+		delete select_policy_;
 	}
 
-	EventLoop &EventLoopGroup::Next() {
-		std::lock_guard<std::mutex> guard(mutex_);
-		int index = event_loop_index_;
-		event_loop_index_ = (event_loop_index_ + 1) % event_loop_num_;
-		return (*event_loops_[index]);
+	//按选择策略获取一个事件监听器下标(负载=注册的连接数+排队任务数)
+	int EventLoopGroup::NextIndex() {
+		return select_policy_->Select(event_loop_num_, [this](int index)->int64_t {
+			return event_loops_[index]->GetChannelNum() + event_loops_[index]->GetQueueDepth();
+		});
 	}
 }
 
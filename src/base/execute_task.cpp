@@ -1,15 +1,25 @@
 #include <lim/base/execute_task.h>
 #include <lim/base/time_utils.h>
+#include <lim/base/cpu_affinity.h>
 #include <assert.h>
-#include <algorithm>
 #include <chrono>
 
 namespace lim {
-	#define EXECUTE_TASK_SLEEP_TIME 10
+	#define TIMER_WHEEL_TICK_MICROSEC 250
+	//任务调度状态
+	#define TASK_STATE_IDLE 0
+	#define TASK_STATE_QUEUED 1
+	#define TASK_STATE_RUNNING 2
+	#define TASK_STATE_RUNNING_PENDING 3
 	ExecuteTimer::ExecuteTimer(ExecuteThread &execute_thread, TimeoutCallback callback):
 		execute_thread_(execute_thread), callback_(callback) {
 
-		timeout_unit_ = std::make_tuple(0, this, false);
+		timeout_node_.prev = timeout_node_.next = &timeout_node_;
+		timeout_node_.expire_tick = 0;
+		timeout_node_.slot_level = -1;
+		timeout_node_.slot_index = -1;
+		timeout_node_.is_linked = false;
+		timeout_node_.execute_timer = this;
 	}
 			
 	ExecuteTimer::~ExecuteTimer() {
@@ -17,32 +27,35 @@ namespace lim {
 	}
 
 	void ExecuteTimer::Start(int milli_sceonds) {
-		std::get<0>(timeout_unit_) = CurrentMilliTime() + milli_sceonds;
-		execute_thread_.AddToMaxHeap(&timeout_unit_);
+		execute_thread_.AddToTimerWheel(&timeout_node_, SteadyMicroTime() + (int64_t)milli_sceonds * 1000);
 	}
 	
 	void ExecuteTimer::Cancel() {
-		execute_thread_.RemoveFromMaxHeap(&timeout_unit_);
+		execute_thread_.RemoveFromTimerWheel(&timeout_node_);
 	}
 	
 	ExecuteTask::ExecuteTask(ExecuteThread &execute_thread): 
 		execute_thread_(execute_thread), execute_events_(ExecuteEvent::NONE_EVENT) {
 			
-		deque_unit_ = std::make_tuple(this, false);
+		queue_node_.prev = queue_node_.next = &queue_node_;
+		queue_node_.execute_task = this;
+		queue_state_ = TASK_STATE_IDLE;
+		execute_thread_.task_num_++;
   }
 
 	ExecuteTask::~ExecuteTask() {
-		execute_thread_.RemoveFromQueue(&deque_unit_);
+		execute_thread_.RemoveFromQueue(this);
+		execute_thread_.task_num_--;
 	}
 
-	//¼
+	//事件触发函数
 	void ExecuteTask::Signal(int execute_events) {
 		std::lock_guard<std::mutex> guard(mutex_);
 		execute_events_ |= execute_events;
-		execute_thread_.AddToQueue(&deque_unit_);
+		execute_thread_.AddToQueue(this);
 	}
 
-	//ȡ¼Ϣ
+	//获取事件信息
 	int ExecuteTask::GetEvents() {
 		std::lock_guard<std::mutex> guard(mutex_);
 		int execute_events = execute_events_;
@@ -50,32 +63,32 @@ namespace lim {
 		return execute_events;
   }
 
-	//ʼ
+	//初始化
 	bool ExecuteTask::Initialize() {
 		return true;
 	}
 
-	//Kill¼
+	//Kill事件处理函数
 	bool ExecuteTask::HandleKillEvent() {
 		return false;
 	}
 
-	//ʼ¼
+	//初始化事件处理函数
 	bool ExecuteTask::HandleInitEvent() {
 		return true;
 	}
 
-	//¼
+	//读事件处理函数
 	bool ExecuteTask::HandleReadEvent() {
 		return true;
 	}
 
-	//д¼
+	//写事件处理函数
 	bool ExecuteTask::HandleWriteEvent() {
 		return true;
 	}
 
-	//Զ¼
+	//自定义事件处理函数
 	bool ExecuteTask::HandleUserEvent(int user_events) {
 		return true;
 	}
@@ -104,142 +117,328 @@ namespace lim {
 		return true;
 	}
 
-	bool MaxHeapUnitCompare(const MaxHeapUnit *a, const MaxHeapUnit *b) {
-		return std::get<0>(*a) > std::get<0>(*b);
-	}
-	
-	ExecuteThread::ExecuteThread() : is_running_(true) {
-		thread_ = std::thread(&ExecuteThread::Run, this);
-		std::make_heap(timeout_heap_.begin(), timeout_heap_.end(), MaxHeapUnitCompare);
+	/**
+	*执行线程构造函数
+	* @param thread_group 所属线程池(仅工作窃取模式下设置,空闲时从池中其它线程窃取任务)
+	* @param cpu 绑定的CPU(-1表示不绑定)
+	* @param is_start_thread 是否创建线程执行任务(为false时由派生类的线程驱动任务队列及定时器,如EventLoop的IO线程)
+	*/
+	ExecuteThread::ExecuteThread(ExecuteThreadGroup *thread_group, int cpu, bool is_start_thread) : is_running_(true), cpu_(cpu), thread_group_(thread_group),
+		timer_wheel_(SteadyMicroTime(), TIMER_WHEEL_TICK_MICROSEC), wakeup_time_(-1), task_num_(0), queue_depth_(0), firing_timer_(NULL) {
+		task_que_.prev = task_que_.next = &task_que_;
+		task_que_.execute_task = NULL;
+		run_que_.prev = run_que_.next = &run_que_;
+		run_que_.execute_task = NULL;
+		if (!is_start_thread) {
+			return;
+		}
+
+		//构造期间虚函数尚未就绪,显式运行ExecuteThread::Run
+		thread_ = std::thread([this] {
+			//先绑定CPU再运行, 线程内首次访问的内存分配在本地NUMA节点
+			if (cpu_ >= 0) {
+				BindCurrentThreadToCpu(cpu_);
+			}
+			ExecuteThread::Run(); 
+		});
 	}
 	
 	ExecuteThread::~ExecuteThread() {
-		is_running_ = false;
-		condvar_.notify_one();
-		thread_.join();
+		Stop();
+	}
+
+	//停止并等待线程退出
+	void ExecuteThread::Stop() {
+		{
+			std::unique_lock<std::mutex> guard(mutex_);
+			is_running_ = false;
+			condvar_.notify_one();
+		}
+		if (thread_.joinable()) {
+			thread_.join();
+		}
 	}
 
 	void ExecuteThread::Run() {
 		while (is_running_) {
+			//1.阻塞直到有任务到达或最近的定时器到期
+			//工作窃取模式下每次只执行一个任务(窃取到的或从本线程队列取出的), 该任务不链入任何队列,
+			//保证任务节点只会出现在宿主线程的队列中, 取消排队时只需持有宿主线程的锁
+			TaskQueueNode *task_node = NULL;
 			{
 				std::unique_lock<std::mutex> lock(mutex_);
-				condvar_.wait(lock, [this] {
-					return (this->timeout_heap_.size() > 0 || this->task_que_.size() > 0 || this->is_running_ == false);
-				});
-			}
+				while (is_running_ && task_que_.next == &task_que_) {
+					int64_t next_expire_time = timer_wheel_.NextExpireTime();
+					if (next_expire_time >= 0 && next_expire_time <= SteadyMicroTime()) {
+						break;
+					}
+					wakeup_time_ = (next_expire_time < 0 ? INT64_MAX : next_expire_time);
 
-			//1.ȴ¼Ϣ
-			ExecuteTask *execute_task = NULL;
-			{
-				//1.1.Ӷлȡ¼Ԫ
-				std::unique_lock<std::mutex> guard(mutex_);
-				if (task_que_.size() > 0) {
-					execute_task = std::get<0>(*task_que_.front());
+					//工作窃取模式下, 阻塞前先尝试从繁忙线程窃取任务(先设置等待时间, 保证窃取失败后不会错过唤醒)
+					if (thread_group_ != NULL && (task_node = thread_group_->StealTask(this)) != NULL) {
+						break;
+					}
+
+					if (next_expire_time < 0) {
+						condvar_.wait(lock);
+					} else {
+						condvar_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::microseconds(next_expire_time)));
+					}
+				}
+				wakeup_time_ = -1;
+
+				//一次加锁取走全部待执行任务
+				//工作窃取模式下每次只取一个, 其余任务留在队列中供空闲线程窃取
+				if (task_que_.next != &task_que_ && thread_group_ != NULL) {
+					if (task_node == NULL) {
+						task_node = task_que_.next;
+						task_que_.next = task_node->next;
+						task_node->next->prev = &task_que_;
+						task_node->prev = task_node->next = task_node;
+						queue_depth_--;
+					}
+				} else {
+					SpliceTasks();
 				}
 			}
 		
-			if (execute_task != NULL) {
-				//1.2.Ƴ¼Ԫִ,Runfalseʱٶ
-				RemoveFromQueue(&execute_task->deque_unit_);
-				if (!execute_task->Run()) {
-					delete execute_task;
-				}
+			//2.逐个移除事件单元并执行
+			if (task_node != NULL) {
+				RunTask(task_node->execute_task);
 			}
 
-			//2.ִжʱ
-			ExecuteTimer *execute_timer = NULL;
+			RunTasks();
+
+			//3.执行超时回调函数
+			RunExpiredTimers();
+		}
+
+		//4.线程退出时销毁队列中的任务, 线程不负责定时器的销毁
+		DestroyTasks();
+	}
+
+	//唤醒阻塞等待的线程(调用方持有mutex_)
+	void ExecuteThread::Notify() {
+		condvar_.notify_one();
+	}
+
+	//取走全部待执行任务放入执行列表(调用方持有mutex_)
+	void ExecuteThread::SpliceTasks() {
+		if (task_que_.next == &task_que_) {
+			return;
+		}
+
+		task_que_.next->prev = run_que_.prev;
+		run_que_.prev->next = task_que_.next;
+		task_que_.prev->next = &run_que_;
+		run_que_.prev = task_que_.prev;
+		task_que_.prev = task_que_.next = &task_que_;
+	}
+
+	//逐个执行执行列表中的任务
+	void ExecuteThread::RunTasks() {
+		while (true) {
+			//执行列表中的任务可能在其它线程被销毁(RemoveFromQueue持锁移除), 每次持锁取出一个
+			ExecuteTask *execute_task = NULL;
 			{
-				//2.1.лȡʱĶʱ
-				std::unique_lock<std::mutex> guard(mutex_);
-				if (timeout_heap_.size() > 0 && std::get<0>(*(timeout_heap_[0])) <= CurrentMilliTime()) {
-					execute_timer = std::get<1>(*timeout_heap_[0]);
+				std::lock_guard<std::mutex> guard(mutex_);
+				if (run_que_.next == &run_que_) {
+					break;
 				}
+
+				TaskQueueNode *task_node = run_que_.next;
+				run_que_.next = task_node->next;
+				task_node->next->prev = &run_que_;
+				task_node->prev = task_node->next = task_node;
+				queue_depth_--;
+				execute_task = task_node->execute_task;
 			}
+			RunTask(execute_task);
+		}
+	}
 
-			//2.2.Ƴʱִгʱص
-			if (execute_timer != NULL) {
-				RemoveFromMaxHeap(&execute_timer->timeout_unit_);
-				if (execute_timer->callback_ != NULL) {
-					execute_timer->callback_();
+	//销毁队列中未执行的任务(线程退出时调用)
+	void ExecuteThread::DestroyTasks() {
+		while (true) {
+			ExecuteTask *execute_task = NULL;
+			{
+				std::unique_lock<std::mutex> guard(mutex_);
+				if (task_que_.next != &task_que_) {
+					execute_task = task_que_.next->execute_task;
 				}
 			}
 
-			//3.߳û¼Ҫ,sleepͷCPUռ
 			if (execute_task == NULL) {
-				std::this_thread::sleep_for(std::chrono::milliseconds(EXECUTE_TASK_SLEEP_TIME));
+				break;
 			}
-		}
-
-		//4.߳˳ʱٶе, ̲߳ʱ
-		auto iter = task_que_.begin();
-		while (iter != task_que_.end()) {
-			ExecuteTask *execute_task = std::get<0>(**iter);
-			task_que_.erase(iter);
-				
+			RemoveFromQueue(execute_task);
 			delete execute_task;
-			iter = task_que_.begin();
 		}
 	}
-	
-	void ExecuteThread::AddToQueue(DeQueueUnit *deque_unit) {
-		std::unique_lock<std::mutex> guard(mutex_);
-		if (std::get<1>(*deque_unit) == false) { //if the unit is not in the queue
-			task_que_.push_back(deque_unit);
-			std::get<1>(*deque_unit) = true;
-			condvar_.notify_one();
+
+	//执行已到期的定时器回调
+	void ExecuteThread::RunExpiredTimers() {
+		//到期时间固定为本轮开始的时间, 回调中重新启动的定时器留到下一轮执行
+		int64_t current_time = SteadyMicroTime();
+		std::unique_lock<std::mutex> lock(mutex_);
+		TimerWheelNode *timer_node = NULL;
+		while ((timer_node = timer_wheel_.PopExpired(current_time)) != NULL) {
+			//到期时已从时间轮中移除, 回调执行期间标记为正在执行, 其它线程取消或销毁该定时器时等待回调结束
+			ExecuteTimer *execute_timer = timer_node->execute_timer;
+			firing_timer_ = execute_timer;
+			firing_thread_id_ = std::this_thread::get_id();
+			lock.unlock();
+			if (execute_timer->callback_ != NULL) {
+				execute_timer->callback_();
+			}
+			lock.lock();
+			firing_timer_ = NULL;
+			timer_condvar_.notify_all();
 		}
 	}
-	
-	void ExecuteThread::RemoveFromQueue(DeQueueUnit *deque_unit) {
-		std::unique_lock<std::mutex> guard(mutex_);
-		if (std::get<1>(*deque_unit) == false) //if the unit is not in the queue
+
+	//执行任务,执行期间有新事件时重新加入宿主线程队列
+	void ExecuteThread::RunTask(ExecuteTask *execute_task) {
+		//执行中状态下触发的事件只做标记, 保证同一任务的Run不会并发执行
+		execute_task->queue_state_ = TASK_STATE_RUNNING;
+		//Run返回false时销毁对象
+		if (!execute_task->Run()) {
+			delete execute_task;
 			return;
+		}
+
+		int queue_state = TASK_STATE_RUNNING;
+		if (!execute_task->queue_state_.compare_exchange_strong(queue_state, TASK_STATE_IDLE)) {
+			execute_task->queue_state_ = TASK_STATE_QUEUED;
+			execute_task->execute_thread_.PushTask(execute_task);
+		}
+	}
 	
-		for (auto iter = task_que_.begin(); iter != task_que_.end(); iter++) {
-			if (*iter == deque_unit) {
-				task_que_.erase(iter);
-				std::get<1>(*deque_unit) = false;
-				break;
+	/**
+	*在调用线程中直接执行任务(run-to-completion),任务已排队或正在执行时只合并事件
+	* @param execute_task 可执行任务
+	* @param execute_events 触发的事件
+	*/
+	void ExecuteThread::RunInline(ExecuteTask *execute_task, int execute_events) {
+		{
+			std::lock_guard<std::mutex> guard(execute_task->mutex_);
+			execute_task->execute_events_ |= execute_events;
+			int queue_state = TASK_STATE_IDLE;
+			if (!execute_task->queue_state_.compare_exchange_strong(queue_state, TASK_STATE_RUNNING)) {
+				execute_task->execute_thread_.AddToQueue(execute_task);
+				return;
 			}
 		}
+		RunTask(execute_task);
 	}
-	
-	void ExecuteThread::AddToMaxHeap(MaxHeapUnit *heap_unit) {
-		std::unique_lock<std::mutex> guard(mutex_);
-		if (std::get<2>(*heap_unit) == true) { //if the unit is in the heap
-			for (auto iter = timeout_heap_.begin(); iter != timeout_heap_.end(); iter++) {
-				if (*iter == heap_unit) {
-					timeout_heap_.erase(iter);
-					std::get<2>(*heap_unit) = false;
-					//std::make_heap(timeout_heap_.begin(), timeout_heap_.end(), MaxHeapUnitCompare);
+
+	void ExecuteThread::AddToQueue(ExecuteTask *execute_task) {
+		int queue_state = execute_task->queue_state_;
+		while (true) {
+			if (queue_state == TASK_STATE_QUEUED || queue_state == TASK_STATE_RUNNING_PENDING) {
+				return;
+			}
+
+			//任务正在执行, 执行结束后重新入队
+			int next_state = (queue_state == TASK_STATE_RUNNING ? TASK_STATE_RUNNING_PENDING : TASK_STATE_QUEUED);
+			if (execute_task->queue_state_.compare_exchange_weak(queue_state, next_state)) {
+				if (next_state == TASK_STATE_QUEUED) {
 					break;
 				}
+				return;
 			}
 		}
-	
-		timeout_heap_.push_back(heap_unit);
-		std::get<2>(*heap_unit) = true;
-		push_heap(timeout_heap_.begin(), timeout_heap_.end(), MaxHeapUnitCompare);
-		condvar_.notify_one();
+		PushTask(execute_task);
+	}
+
+	//任务加入队尾(调用前任务已标记为排队状态)
+	void ExecuteThread::PushTask(ExecuteTask *execute_task) {
+		bool is_busy = false;
+		{
+			std::unique_lock<std::mutex> guard(mutex_);
+			TaskQueueNode *task_node = &execute_task->queue_node_;
+			task_node->prev = task_que_.prev;
+			task_node->next = &task_que_;
+			task_que_.prev->next = task_node;
+			task_que_.prev = task_node;
+			queue_depth_++;
+
+			if (wakeup_time_ != -1) {
+				Notify();
+			} else {
+				is_busy = true;
+			}
+		}
+
+		//宿主线程繁忙时唤醒空闲线程来窃取
+		if (is_busy && thread_group_ != NULL) {
+			thread_group_->WakeupIdleThread(this);
+		}
 	}
 	
-	void ExecuteThread::RemoveFromMaxHeap(MaxHeapUnit *heap_unit) {
+	void ExecuteThread::RemoveFromQueue(ExecuteTask *execute_task) {
 		std::unique_lock<std::mutex> guard(mutex_);
-		if (std::get<2>(*heap_unit) == false) //if the unit is not in the heap
+		TaskQueueNode *task_node = &execute_task->queue_node_;
+		if (task_node->next == task_node) //if the task is not in the queue
 			return;
 	
-		for (auto iter = timeout_heap_.begin(); iter != timeout_heap_.end(); iter++) {
-			if (*iter == heap_unit) {
-				timeout_heap_.erase(iter);
-				std::get<2>(*heap_unit) = false;
-				std::make_heap(timeout_heap_.begin(), timeout_heap_.end(), MaxHeapUnitCompare);
-				break;
-			}
+		task_node->prev->next = task_node->next;
+		task_node->next->prev = task_node->prev;
+		task_node->prev = task_node->next = task_node;
+		execute_task->queue_state_ = TASK_STATE_IDLE;
+		queue_depth_--;
+	}
+
+	//从本线程队尾窃取一个任务(由窃取线程调用,失败返回NULL)
+	TaskQueueNode *ExecuteThread::TrySteal() {
+		//仅使用try_lock, 避免两个线程互相窃取时死锁
+		std::unique_lock<std::mutex> guard(mutex_, std::try_to_lock);
+		if (!guard.owns_lock()) {
+			return NULL;
+		}
+
+		//线程阻塞中说明即将处理自己的队列, 不需要窃取
+		if (wakeup_time_ != -1 || task_que_.next == &task_que_) {
+			return NULL;
+		}
+
+		TaskQueueNode *task_node = task_que_.prev;
+		task_node->prev->next = &task_que_;
+		task_que_.prev = task_node->prev;
+		task_node->prev = task_node->next = task_node;
+		queue_depth_--;
+		return task_node;
+	}
+		
+	void ExecuteThread::AddToTimerWheel(TimerWheelNode *timer_node, int64_t expire_time) {
+		std::unique_lock<std::mutex> guard(mutex_);
+		timer_wheel_.Add(timer_node, expire_time);
+		//仅当新定时器早于线程当前等待的截止时间时才唤醒
+		if (wakeup_time_ != -1 && expire_time < wakeup_time_) {
+			Notify();
 		}
 	}
+	
+	void ExecuteThread::RemoveFromTimerWheel(TimerWheelNode *timer_node) {
+		std::unique_lock<std::mutex> guard(mutex_);
+		//回调正在其它线程执行时等待结束(回调中可能重新启动定时器), 返回后可以安全销毁定时器; 回调中取消自身时不等待
+		while (firing_timer_ == timer_node->execute_timer && firing_thread_id_ != std::this_thread::get_id()) {
+			timer_condvar_.wait(guard);
+		}
+		timer_wheel_.Remove(timer_node);
+	}
 		
-	ExecuteThreadGroup::ExecuteThreadGroup(int execute_thread_num): 
-		execute_thread_num_(execute_thread_num), execute_thread_index_(0) {
+	/**
+	*执行线程池构造函数
+	* @param execute_thread_num 线程数(小于等于0时为CPU核数的2倍)
+	* @param is_work_stealing 是否启用工作窃取
+	* @param policy_type 线程选择策略
+	* @param cpu_list 绑定的CPU列表(第i个线程绑定到第i%size个CPU,为空时不绑定)
+	*/
+	ExecuteThreadGroup::ExecuteThreadGroup(int execute_thread_num, bool is_work_stealing, SelectPolicyType policy_type,
+		const std::vector<int> &cpu_list): 
+		execute_thread_num_(execute_thread_num), is_work_stealing_(false), steal_index_(0) {
+		select_policy_ = SelectPolicy::CreatePolicy(policy_type);
 		if (execute_thread_num_ <= 0) {
       execute_thread_num_ = 2*std::thread::hardware_concurrency();
     }
@@ -248,24 +447,76 @@ namespace lim {
     assert(execute_threads_);
 
     for (int i = 0; i < execute_thread_num_; i++) {
-      execute_threads_[i] = new ExecuteThread();
+      int cpu = (cpu_list.size() > 0 ? cpu_list[i % cpu_list.size()] : -1);
+      execute_threads_[i] = new ExecuteThread(is_work_stealing ? this : NULL, cpu);
       assert(execute_threads_[i]);
     }
+		//所有线程创建完成后才允许窃取
+		is_work_stealing_ = is_work_stealing;
 	}
 
 	ExecuteThreadGroup::~ExecuteThreadGroup() {
+		//先停止所有线程再销毁, 避免窃取已销毁的线程
+		is_work_stealing_ = false;
+		for (int i = 0; i < execute_thread_num_; i++) {
+			execute_threads_[i]->Stop();
+		}
+
 		for (int i = 0; i < execute_thread_num_; i++) {
 			delete execute_threads_[i];
 			execute_threads_[i] = NULL;
     }
     delete[]execute_threads_;
+		delete select_policy_;
 	}
 
-	ExecuteThread &ExecuteThreadGroup::Next() {
-		std::lock_guard<std::mutex> guard(mutex_);
-		int index = execute_thread_index_;
-		execute_thread_index_ = (execute_thread_index_ + 1) % execute_thread_num_;
-		return (*execute_threads_[index]);
+	//按选择策略获取一个工作线程下标(负载=绑定的任务数+排队任务数)
+	int ExecuteThreadGroup::NextIndex() {
+		return select_policy_->Select(execute_thread_num_, [this](int index)->int64_t {
+			return execute_threads_[index]->GetTaskNum() + execute_threads_[index]->GetQueueDepth();
+		});
 	}
-}
 
+	//为空闲线程窃取一个任务(不链入任何队列,由窃取线程直接执行),失败返回NULL
+	TaskQueueNode *ExecuteThreadGroup::StealTask(ExecuteThread *execute_thread) {
+		if (!is_work_stealing_) {
+			return NULL;
+		}
+
+		//从不同的起始线程开始, 避免所有空闲线程集中窃取同一个线程
+		int start_index = steal_index_.fetch_add(1) % execute_thread_num_;
+		for (int i = 0; i < execute_thread_num_; i++) {
+			ExecuteThread *victim = execute_threads_[(start_index + i) % execute_thread_num_];
+			if (victim == execute_thread) {
+				continue;
+			}
+
+			TaskQueueNode *task_node = victim->TrySteal();
+			if (task_node != NULL) {
+				return task_node;
+			}
+		}
+		return NULL;
+	}
+
+	//任务宿主线程繁忙时唤醒一个空闲线程
+	void ExecuteThreadGroup::WakeupIdleThread(ExecuteThread *execute_thread) {
+		if (!is_work_stealing_) {
+			return;
+		}
+
+		int start_index = steal_index_.fetch_add(1) % execute_thread_num_;
+		for (int i = 0; i < execute_thread_num_; i++) {
+			ExecuteThread *idle_thread = execute_threads_[(start_index + i) % execute_thread_num_];
+			if (idle_thread == execute_thread || idle_thread->wakeup_time_ == -1) {
+				continue;
+			}
+
+			std::unique_lock<std::mutex> guard(idle_thread->mutex_);
+			if (idle_thread->wakeup_time_ != -1) {
+				idle_thread->Notify();
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include <lim/base/file_region.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace lim {
+	#define FILE_REGION_CHUNK_SIZE (16 * 1024) /***分块发送时每块的大小(一条SSL记录的最大长度)***/
+
+	/**
+	*文件区域构造函数
+	* @param file_path 文件路径
+	* @param offset 起始偏移
+	* @param length 长度(-1为到文件末尾, 超出文件大小时截断)
+	*/
+	FileRegion::FileRegion(const std::string &file_path, int64_t offset, int64_t length):
+		fd_(-1), file_size_(0), position_(offset), remain_length_(0),
+		chunk_(NULL), chunk_offset_(0), chunk_size_(0) {
+#ifdef _WIN32
+		fd_ = _open(file_path.c_str(), _O_RDONLY | _O_BINARY);
+		struct _stat64 file_stat;
+		if (fd_ == -1 || _fstat64(fd_, &file_stat) != 0) {
+#else
+		fd_ = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+		struct stat file_stat;
+		if (fd_ == -1 || fstat(fd_, &file_stat) != 0) {
+#endif
+			return;
+		}
+
+		file_size_ = file_stat.st_size;
+		if (position_ < 0 || position_ > file_size_) {
+			position_ = file_size_;
+		}
+		remain_length_ = file_size_ - position_;
+		if (length >= 0 && length < remain_length_) {
+			remain_length_ = length;
+		}
+	}
+
+	FileRegion::~FileRegion() {
+		if (fd_ != -1) {
+#ifdef _WIN32
+			_close(fd_);
+#else
+			close(fd_);
+#endif
+		}
+		delete[] chunk_;
+	}
+
+	/**
+	*跳过已发送的字节
+	* @param size 字节数
+	* @return 返回跳过的字节数
+	*/
+	int64_t FileRegion::SkipBytes(int64_t size) {
+		size = (size < remain_length_ ? size : remain_length_);
+		if (size <= 0) {
+			return 0;
+		}
+
+		position_ += size;
+		remain_length_ -= size;
+		if (chunk_size_ - chunk_offset_ > size) {
+			chunk_offset_ += (int)size;
+		} else {
+			chunk_offset_ = chunk_size_ = 0;
+		}
+		return size;
+	}
+
+	/**
+	*读取数据(拷贝到data并消费)
+	* @param data 数据区
+	* @param size 数据区大小
+	* @return 出错返回-1, 否则返回读取的字节数
+	*/
+	int FileRegion::ReadBytes(char *data, int size) {
+		size = (size < remain_length_ ? size : (int)remain_length_);
+		if (fd_ == -1 || size <= 0) {
+			return 0;
+		}
+
+#ifdef _WIN32
+		int read_length = (_lseeki64(fd_, position_, SEEK_SET) == -1 ? -1 : _read(fd_, data, size));
+#else
+		int read_length = (int)pread(fd_, data, size, position_);
+#endif
+		if (read_length <= 0) { //文件被截断或读取出错
+			return -1;
+		}
+		//数据块中的数据已拷贝, 丢弃已读取部分
+		SkipBytes(read_length);
+		return read_length;
+	}
+
+	/**
+	*获取当前待发送的数据块(块为空时从文件读取, 未消费时重复调用返回同一数据区, 满足SSL重试的要求)
+	* @param size 返回数据块大小
+	* @return 出错返回NULL
+	*/
+	char *FileRegion::ReadableChunk(int &size) {
+		if (chunk_offset_ == chunk_size_) {
+			if (chunk_ == NULL) {
+				chunk_ = new char[FILE_REGION_CHUNK_SIZE];
+			}
+
+			int read_size = (remain_length_ < FILE_REGION_CHUNK_SIZE ? (int)remain_length_ : FILE_REGION_CHUNK_SIZE);
+			if (fd_ == -1 || read_size <= 0) {
+				return NULL;
+			}
+#ifdef _WIN32
+			int read_length = (_lseeki64(fd_, position_, SEEK_SET) == -1 ? -1 : _read(fd_, chunk_, read_size));
+#else
+			int read_length = (int)pread(fd_, chunk_, read_size, position_);
+#endif
+			if (read_length <= 0) { //文件被截断或读取出错
+				return NULL;
+			}
+			chunk_offset_ = 0;
+			chunk_size_ = read_length;
+		}
+
+		size = chunk_size_ - chunk_offset_;
+		return chunk_ + chunk_offset_;
+	}
+}
@@ -0,0 +1,228 @@
+#include <lim/base/io_uring_queue.h>
+#ifdef ENABLE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+namespace lim {
+	static inline int IoUringSetup(unsigned int entries, struct io_uring_params *params) {
+		return (int)syscall(__NR_io_uring_setup, entries, params);
+	}
+
+	static inline int IoUringEnter(int fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags,
+		void *arg = NULL, size_t arg_size = 0) {
+		return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+	}
+
+	static inline int IoUringRegister(int fd, unsigned int opcode, void *arg, unsigned int arg_num) {
+		return (int)syscall(__NR_io_uring_register, fd, opcode, arg, arg_num);
+	}
+
+	IoUringQueue::IoUringQueue(): fd_ring_(-1), sq_pending_(0),
+		sq_ring_(MAP_FAILED), sq_ring_size_(0), cq_ring_(MAP_FAILED), cq_ring_size_(0), sqes_((struct io_uring_sqe*)MAP_FAILED), sqes_size_(0),
+		buffer_ring_((struct io_uring_buf_ring*)MAP_FAILED), buffer_ring_size_(0), buffer_memory_((char*)MAP_FAILED), buffer_num_(0), buffer_size_(0) {
+	}
+
+	IoUringQueue::~IoUringQueue() {
+		if (buffer_memory_ != MAP_FAILED) {
+			munmap(buffer_memory_, (size_t)buffer_num_ * buffer_size_);
+		}
+		if (buffer_ring_ != MAP_FAILED) {
+			munmap(buffer_ring_, buffer_ring_size_);
+		}
+		if (sqes_ != MAP_FAILED) {
+			munmap(sqes_, sqes_size_);
+		}
+		if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+			munmap(cq_ring_, cq_ring_size_);
+		}
+		if (sq_ring_ != MAP_FAILED) {
+			munmap(sq_ring_, sq_ring_size_);
+		}
+		if (fd_ring_ >= 0) {
+			close(fd_ring_);
+		}
+	}
+
+	/**
+	*创建io_uring实例
+	* @param entries 提交队列长度
+	* @return 内核不支持时返回false
+	*/
+	bool IoUringQueue::Initialize(unsigned int entries) {
+		struct io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		fd_ring_ = IoUringSetup(entries, &params);
+		if (fd_ring_ < 0) {
+			return false;
+		}
+
+		//带超时的等待依赖EXT_ARG(事件循环按最近的定时器到期时间等待)
+		if (!(params.features & IORING_FEAT_EXT_ARG)) {
+			return false;
+		}
+
+		sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+		cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			sq_ring_size_ = cq_ring_size_ = (sq_ring_size_ > cq_ring_size_ ? sq_ring_size_ : cq_ring_size_);
+		}
+
+		sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd_ring_, IORING_OFF_SQ_RING);
+		if (sq_ring_ == MAP_FAILED) {
+			return false;
+		}
+
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			cq_ring_ = sq_ring_;
+		} else {
+			cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd_ring_, IORING_OFF_CQ_RING);
+			if (cq_ring_ == MAP_FAILED) {
+				return false;
+			}
+		}
+
+		sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+		sqes_ = (struct io_uring_sqe*)mmap(NULL, sqes_size_, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd_ring_, IORING_OFF_SQES);
+		if (sqes_ == MAP_FAILED) {
+			return false;
+		}
+
+		char *sq_ring = (char*)sq_ring_;
+		sq_head_ = (unsigned int*)(sq_ring + params.sq_off.head);
+		sq_tail_ = (unsigned int*)(sq_ring + params.sq_off.tail);
+		sq_mask_ = *(unsigned int*)(sq_ring + params.sq_off.ring_mask);
+		sq_entries_ = *(unsigned int*)(sq_ring + params.sq_off.ring_entries);
+		sq_array_ = (unsigned int*)(sq_ring + params.sq_off.array);
+
+		char *cq_ring = (char*)cq_ring_;
+		cq_head_ = (unsigned int*)(cq_ring + params.cq_off.head);
+		cq_tail_ = (unsigned int*)(cq_ring + params.cq_off.tail);
+		cq_mask_ = *(unsigned int*)(cq_ring + params.cq_off.ring_mask);
+		cqes_ = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+		return true;
+	}
+
+	/**
+	*注册接收缓冲区环(内核在接收完成时从中选择缓冲区)
+	* @param group_id 缓冲区组id
+	* @param buffer_num 缓冲区个数(2的幂)
+	* @param buffer_size 单个缓冲区大小
+	* @return 内核不支持时返回false
+	*/
+	bool IoUringQueue::RegisterBufferRing(int group_id, int buffer_num, int buffer_size) {
+		buffer_ring_size_ = buffer_num * sizeof(struct io_uring_buf);
+		buffer_ring_ = (struct io_uring_buf_ring*)mmap(NULL, buffer_ring_size_, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if (buffer_ring_ == MAP_FAILED) {
+			return false;
+		}
+
+		//缓冲区内存由内核在接收时首次写入(事件循环线程提交, 位于其NUMA节点)
+		buffer_memory_ = (char*)mmap(NULL, (size_t)buffer_num * buffer_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if (buffer_memory_ == MAP_FAILED) {
+			return false;
+		}
+		buffer_num_ = buffer_num;
+		buffer_size_ = buffer_size;
+
+		struct io_uring_buf_reg buffer_reg;
+		memset(&buffer_reg, 0, sizeof(buffer_reg));
+		buffer_reg.ring_addr = (uint64_t)(uintptr_t)buffer_ring_;
+		buffer_reg.ring_entries = buffer_num;
+		buffer_reg.bgid = group_id;
+		if (IoUringRegister(fd_ring_, IORING_REGISTER_PBUF_RING, &buffer_reg, 1) < 0) {
+			return false;
+		}
+
+		buffer_ring_->tail = 0;
+		for (int i = 0; i < buffer_num; i++) {
+			RecycleBuffer(i);
+		}
+		return true;
+	}
+
+	//接收缓冲区使用完毕, 归还给内核
+	void IoUringQueue::RecycleBuffer(int buffer_id) {
+		unsigned short tail = buffer_ring_->tail;
+		//环中的缓冲区描述与头部(tail)重叠, 从环起始地址按下标计算(C++下bufs柔性数组的偏移不为0)
+		struct io_uring_buf *buffer = (struct io_uring_buf*)buffer_ring_ + (tail & (buffer_num_ - 1));
+		buffer->addr = (uint64_t)(uintptr_t)GetBuffer(buffer_id);
+		buffer->len = buffer_size_;
+		buffer->bid = (unsigned short)buffer_id;
+		__atomic_store_n(&buffer_ring_->tail, (unsigned short)(tail + 1), __ATOMIC_RELEASE);
+	}
+
+	//获取一个空闲的提交项(队列满时先提交已有的提交项)
+	struct io_uring_sqe *IoUringQueue::GetSqe() {
+		unsigned int tail = *sq_tail_ + sq_pending_;
+		if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+			if (Submit(0) < 0) {
+				return NULL;
+			}
+			tail = *sq_tail_ + sq_pending_;
+			if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+				return NULL;
+			}
+		}
+
+		unsigned int index = tail & sq_mask_;
+		struct io_uring_sqe *sqe = &sqes_[index];
+		memset(sqe, 0, sizeof(struct io_uring_sqe));
+		sq_array_[index] = index;
+		sq_pending_++;
+		return sqe;
+	}
+
+	/**
+	*批量提交所有待提交项并等待完成事件
+	* @param wait_num 至少等待的完成事件数(0为不等待)
+	* @param timeout_microsec 等待超时(微秒,-1为不超时,超时返回-ETIME)
+	* @return 失败返回-errno
+	*/
+	int IoUringQueue::Submit(int wait_num, int64_t timeout_microsec) {
+		if (sq_pending_ > 0) {
+			__atomic_store_n(sq_tail_, *sq_tail_ + sq_pending_, __ATOMIC_RELEASE);
+			sq_pending_ = 0;
+		}
+		//包含之前因中断等原因未被内核取走的提交项
+		unsigned int to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+
+		if (to_submit == 0 && wait_num == 0) {
+			return 0;
+		}
+
+		int ret = 0;
+		if (wait_num > 0 && timeout_microsec >= 0) {
+			struct __kernel_timespec timeout;
+			timeout.tv_sec = timeout_microsec / 1000000;
+			timeout.tv_nsec = (timeout_microsec % 1000000) * 1000;
+			struct io_uring_getevents_arg arg;
+			memset(&arg, 0, sizeof(arg));
+			arg.ts = (uint64_t)(uintptr_t)&timeout;
+			ret = IoUringEnter(fd_ring_, to_submit, wait_num, IORING_ENTER_GETEVENTS|IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+		} else {
+			ret = IoUringEnter(fd_ring_, to_submit, wait_num, (wait_num > 0 ? IORING_ENTER_GETEVENTS : 0));
+		}
+		if (ret < 0) {
+			return -errno;
+		}
+		return ret;
+	}
+
+	//获取一个完成事件,没有时返回NULL
+	struct io_uring_cqe *IoUringQueue::PeekCqe() {
+		unsigned int head = *cq_head_;
+		if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+			return NULL;
+		}
+		return &cqes_[head & cq_mask_];
+	}
+
+	//标记当前完成事件已处理
+	void IoUringQueue::SeenCqe() {
+		__atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+	}
+}
+#endif
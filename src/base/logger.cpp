@@ -12,6 +12,7 @@
 #include <dirent.h>
 #endif
 #include <stdarg.h>
+#include <math.h>
 #include <sstream>
 #include <algorithm>
 #include <vector>
@@ -19,7 +20,7 @@
 #define PRINTF(...)	printf(__VA_ARGS__)
 namespace lim {
 	static const std::string kLogLevels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
-	//ȡ־
+	//获取日志对象
 	Logger *Logger::GetLogger(const std::string &log_name) {
 		Logger *logger = new Logger();
 		if (!logger->Initialize(log_name))
@@ -35,8 +36,8 @@ namespace lim {
 		log_path_ = "./";
 		log_file_fd_ = NULL;
 
-		log_rotate_max_file_size_ = 10 * 1024 * 1024; //Ĭϵļ10MB
-		log_rotate_max_file_num_ = 10; //Ĭÿౣ10־ļ
+		log_rotate_max_file_size_ = 10 * 1024 * 1024; //默认单个文件最大10MB
+		log_rotate_max_file_num_ = 10; //默认每天最多保存10个日志文件
 		
 		last_day_time_ = GetCurrentTimeString("%04d%02d%02d");
 	}
@@ -47,7 +48,7 @@ namespace lim {
 		}
 	}
 
-	//ʼ
+	//初始化
 	bool Logger::Initialize(const std::string &log_name) {	
 		log_name_ = log_name;
 		std::string file_name = log_path_ + "/" + log_name_ + ".log";
@@ -59,19 +60,19 @@ namespace lim {
 		return true;
 	}
 
-	//־ļʽ־ȼ
+	//设置日志文件输出方式包含的日志等级类别
 	void Logger::SetLogConsoleLevel(int log_console_level) {
 		std::lock_guard<std::mutex> guard(mutex_);
 		log_console_level_ = log_console_level;
 	}
 
-	//ÿ̨ʽ־ȼ
+	//设置控制台输出方式包含的日志等级类别
 	void Logger::SetLogFileLevel(int log_file_level) {
 		std::lock_guard<std::mutex> guard(mutex_);
 		log_file_level_ = log_file_level;
 	}
 
-	//־ļ·
+	//设置日志文件路径
 	bool Logger::SetLogFilePath(const std::string &log_path) {
 		std::lock_guard<std::mutex> guard(mutex_);
 		if (log_file_fd_ != NULL) {
@@ -87,7 +88,7 @@ namespace lim {
 		return true;
   }
 
-	//־ļ
+	//滚动日志文件
 	void Logger::RollFile(const std::string day_time) {
 		fclose(log_file_fd_);
 		//remove expired old files
@@ -117,7 +118,7 @@ namespace lim {
 		log_file_fd_ = fopen(file_name.c_str(), "a+");
 	}
 
-	//ļС־ļ
+	//按天和文件大小滚动日志文件
 	void Logger::LogRollOver() {
 		std::lock_guard<std::mutex> guard(mutex_);
 		std::string now_day_time = GetCurrentTimeString("%04d%02d%02d");
@@ -130,11 +131,11 @@ namespace lim {
 	}
 
 	/**
-	*־
-	* @param file ļ
-	* @param file ļк
-	* @param file ־ȼ
-	* @param file ־ʽ
+	*输出日志
+	* @param file 代码文件名称
+	* @param file 代码文件行号
+	* @param file 日志等级
+	* @param file 日志输出格式
 	*/
 	void Logger::Trace(const std::string &file, int line, int level, const char *format, ...) {
 		int log_console_level, log_file_level;
@@ -156,12 +157,12 @@ namespace lim {
 #ifdef _WIN32
 			HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
 
-			//̨ɫ
+			//保存控制台字体颜色
 			CONSOLE_SCREEN_BUFFER_INFO csbi_info;
 			GetConsoleScreenBufferInfo(handle, &csbi_info);
 			WORD old_color_attrs = csbi_info.wAttributes;
 			
-			//־ȼɫ
+			//按日志等级设置颜色
 			if (level == LOG_LEVEL_INFO) {
 				SetConsoleTextAttribute(handle, FOREGROUND_BLUE);
 			} else if (level == LOG_LEVEL_WARN) {
@@ -171,10 +172,10 @@ namespace lim {
 			}
 			vprintf(ss.str().c_str(), maker);		
 
-			//ָ̨ɫ
+			//恢复控制台字体颜色
 			SetConsoleTextAttribute(handle, old_color_attrs);
 #else
-			//־ȼɫ
+			//按日志等级设置颜色
 			std::string color = "\033[0;m";
 			if (level == LOG_LEVEL_INFO) {
 				color = "\033[0;34m"; //blue
@@ -0,0 +1,61 @@
+#include <lim/base/select_policy.h>
+#include <lim/base/time_utils.h>
+#include <thread>
+
+namespace lim {
+	//线程局部的xorshift随机数(避免rand()的全局锁)
+	static uint32_t NextRandom() {
+		static thread_local uint64_t seed = 0;
+		if (seed == 0) {
+			seed = (uint64_t)SteadyMicroTime() ^ (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id()) ^ 0x9E3779B97F4A7C15ULL;
+		}
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (uint32_t)(seed >> 32);
+	}
+
+	//按类型创建选择策略
+	SelectPolicy *SelectPolicy::CreatePolicy(SelectPolicyType policy_type) {
+		switch (policy_type) {
+		case SelectPolicyType::LEAST_CONNECTIONS:
+			return new LeastConnectionsPolicy();
+		case SelectPolicyType::POWER_OF_TWO_CHOICES:
+			return new PowerOfTwoChoicesPolicy();
+		default:
+			return new RoundRobinPolicy();
+		}
+	}
+
+	int RoundRobinPolicy::Select(int member_num, const LoadFunction &/*load_function*/) {
+		return (int)(index_.fetch_add(1, std::memory_order_relaxed) % (unsigned int)member_num);
+	}
+
+	int LeastConnectionsPolicy::Select(int member_num, const LoadFunction &load_function) {
+		int start_index = (int)(index_.fetch_add(1, std::memory_order_relaxed) % (unsigned int)member_num);
+		int select_index = start_index;
+		int64_t min_load = load_function(start_index);
+		for (int i = 1; i < member_num && min_load > 0; i++) {
+			int index = (start_index + i) % member_num;
+			int64_t load = load_function(index);
+			if (load < min_load) {
+				min_load = load;
+				select_index = index;
+			}
+		}
+		return select_index;
+	}
+
+	int PowerOfTwoChoicesPolicy::Select(int member_num, const LoadFunction &load_function) {
+		if (member_num <= 1) {
+			return 0;
+		}
+
+		int first_index = (int)(NextRandom() % (uint32_t)member_num);
+		int second_index = (int)(NextRandom() % (uint32_t)(member_num - 1));
+		if (second_index >= first_index) {
+			second_index++;
+		}
+		return (load_function(second_index) < load_function(first_index) ? second_index : first_index);
+	}
+}
@@ -1,6 +1,8 @@
 #include <lim/base/socket_channel.h>
 #include <lim/base/string_utils.h>
 #include <sstream>
+#include <string.h>
+#include <limits.h>
 #ifdef _WIN32 
 #include <winsock2.h>
 #include <ws2tcpip.h>
@@ -9,14 +11,22 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+#include <linux/filter.h>
+#endif
 #include <sys/un.h> 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <netdb.h>
 #include <ifaddrs.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <netdb.h>
+#include <poll.h>
 #endif
 #ifdef ENABLE_OPENSSL
 #include <openssl/x509.h>
@@ -25,8 +35,24 @@
 #endif
 
 namespace lim {
+#ifdef IOV_MAX
+	#define SOCKET_CHANNEL_IOV_NUM IOV_MAX /***单次聚集写的最大组件数***/
+#else
+	#define SOCKET_CHANNEL_IOV_NUM 1024 /***单次聚集写的最大组件数***/
+#endif
+	#define SOCKET_CHANNEL_READ_SIZE 1024 /***每次接收至少预留的连续空间***/
+	#define SOCKET_CHANNEL_SSL_READ_SIZE (16 * 1024) /***SSL每次解密至少预留的连续空间(一条SSL记录的最大长度)***/
+	#define SOCKET_CHANNEL_EXTRA_READ_SIZE (64 * 1024) /***接收时栈上扩展缓冲区的大小***/
+	#define SOCKET_CHANNEL_SENDFILE_SIZE (1 << 30) /***单次sendfile的最大字节数***/
+#if defined(__linux__) && defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+	#define SOCKET_CHANNEL_ACCEPT4 /***accept4直接得到非阻塞句柄***/
+#endif
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+	#define SOCKET_CHANNEL_ZERO_COPY /***支持零拷贝发送***/
+#endif
+
 	SocketChannel::SocketChannel(int socket_channel): 
-		socket_channel_(socket_channel), remote_host_port_(-1), local_host_port_(-1) {
+		socket_channel_(socket_channel), remote_host_port_(-1), local_host_port_(-1), is_connecting_(false) {
 		reference_count_ = new std::atomic<int>(1);
 #ifdef ENABLE_OPENSSL		
 		ssl_context_ = NULL;
@@ -37,7 +63,7 @@ namespace lim {
 
 #ifdef ENABLE_OPENSSL	
 	SocketChannel::SocketChannel(int socket_channel, SSLContext *ssl_context, SSL *ssl_handle):
-		socket_channel_(socket_channel), remote_host_port_(-1), local_host_port_(-1), 
+		socket_channel_(socket_channel), remote_host_port_(-1), local_host_port_(-1), is_connecting_(false),
 		ssl_context_(ssl_context), ssl_handle_(ssl_handle), is_handshaked_(false) {
 		reference_count_ = new std::atomic<int>(1);
 	}
@@ -51,6 +77,7 @@ namespace lim {
 		
 		local_host_name_ = other.local_host_name_;
 		local_host_port_ = other.local_host_port_;
+		is_connecting_ = other.is_connecting_;
 
 #ifdef ENABLE_OPENSSL	
 		ssl_context_ = other.ssl_context_;
@@ -77,6 +104,7 @@ namespace lim {
 		
 		local_host_name_ = other.local_host_name_;
 		local_host_port_ = other.local_host_port_;
+		is_connecting_ = other.is_connecting_;
 
 #ifdef ENABLE_OPENSSL
 		ssl_context_ = other.ssl_context_;
@@ -114,7 +142,7 @@ namespace lim {
     return true;
   }
   
-	bool SocketChannel::Bind(const std::string &unix_path) {
+	bool SocketChannel::Bind(const std::string &unix_path, const SocketOptions &options) {
 #ifndef _WIN32
 		socket_channel_ = socket(AF_UNIX, SOCK_STREAM, 0);
 		if (-1 == socket_channel_) {
@@ -128,6 +156,8 @@ namespace lim {
 			Close();
 			return false;
 		}
+		//缓冲区大小需在listen前设置(影响窗口扩大因子, 由accept的连接继承), 选项设置失败不影响监听
+		SetSocketOptions(options, true);
 
 		struct sockaddr_un local = {0};
 		local.sun_family = AF_UNIX;
@@ -157,7 +187,15 @@ namespace lim {
 		return false;
 	}
 
-	bool SocketChannel::Bind(const std::string &local_host, int local_port) {
+	/**
+	*绑定并监听地址
+	* @param local_host 本地地址
+	* @param local_port 本地端口
+	* @param options socket选项
+	* @param is_reuse_port 是否启用SO_REUSEPORT(多个socket监听同一端口, 由内核分配连接)
+	* @return 成功返回true
+	*/
+	bool SocketChannel::Bind(const std::string &local_host, int local_port, const SocketOptions &options, bool is_reuse_port) {
 		socket_channel_ = socket(AF_INET, SOCK_STREAM, 0);
 		if (-1 == socket_channel_){
 			//printf("socket(AF_INET, SOCK_STREAM, 0) error\n");
@@ -171,6 +209,21 @@ namespace lim {
 			return false;
 		}
 
+		if (is_reuse_port) {
+#ifdef SO_REUSEPORT
+			if (setsockopt(socket_channel_, SOL_SOCKET, SO_REUSEPORT, (const char *)&optval, sizeof(int)) < 0) {
+				//printf("setsockopt(SO_REUSEPORT) error.\n");
+				Close();
+				return false;
+			}
+#else
+			Close();
+			return false;
+#endif
+		}
+		//缓冲区大小需在listen前设置(影响窗口扩大因子, 由accept的连接继承), 选项设置失败不影响监听
+		SetSocketOptions(options, true);
+
 		struct sockaddr_in local = {0};
 		local.sin_family = AF_INET;
 		local.sin_port = htons(local_port);
@@ -199,36 +252,38 @@ namespace lim {
 		return true;
 	}
 
-	bool SocketChannel::Connect(const std::string &unix_path) {
+	bool SocketChannel::Connect(const std::string &unix_path, const SocketOptions &options) {
 #ifndef _WIN32
 		socket_channel_ = socket(AF_UNIX, SOCK_STREAM, 0);
 		if (-1 == socket_channel_) {
 			//printf("socket(AF_UNIX, SOCK_STREAM, 0) error.\n");
 			return false;
 		}
+		SetSocketOptions(options);
 		
+		if (!SetNonBlock()) {
+			//printf("no block setting (%s) error.\n", unix_path.c_str());
+			Close();
+			return false;
+		}
+
 		struct sockaddr_un remote = { 0 };
 		remote.sun_family = AF_UNIX;
 		strcpy(remote.sun_path + 1, unix_path.c_str());
 		remote.sun_path[0] = 0;
 
-		if (connect(socket_channel_, (sockaddr*)&remote, sizeof(remote)) < 0) {
+		if (!StartConnect((sockaddr*)&remote, sizeof(remote))) {
  			//printf("connect(%s) error.\n", unix_path);
 			Close();
 			return false;
 		}
 
-		if (!SetNonBlock()) {
-			//printf("no block setting (%s) error.\n", unix_path.c_str());
-			Close();
-			return false;
-		}
-
 #ifdef ENABLE_OPENSSL
     if (ssl_context_ != NULL) {
       ssl_handle_ = SSL_new(ssl_context_->context_);
       SSL_set_fd(ssl_handle_, socket_channel_);
       SSL_set_connect_state(ssl_handle_);
+      ssl_context_->PrepareClientSession(ssl_handle_, unix_path);
     }
 #endif		
 		return true;
@@ -236,39 +291,52 @@ namespace lim {
 		return false;
 	}
 	
-	bool SocketChannel::Connect(const std::string &remote_host, int remote_port) {
+	bool SocketChannel::Connect(const std::string &remote_host, int remote_port, const SocketOptions &options) {
 		std::string remote_ip = HostToIp(remote_host);
 		if (remote_ip.empty()) {
 			return false;
 		}
-		
+		return Connect(remote_host, remote_ip, remote_port, options);
+	}
+
+	/**
+	*连接已解析的地址(不再解析域名)
+	* @param remote_host 对端域名(用于SSL主机名校验)
+	* @param remote_ip 对端IPv4地址
+	* @param remote_port 对端端口
+	* @param options socket选项
+	* @return 成功(或连接中)返回true
+	*/
+	bool SocketChannel::Connect(const std::string &remote_host, const std::string &remote_ip, int remote_port, const SocketOptions &options) {
 		socket_channel_ = socket(AF_INET, SOCK_STREAM, 0);
     if (-1 == socket_channel_) {
       //printf("socket(AF_INET, SOCK_STREAM, 0) error.\n");
       return false;
     }
+		SetSocketOptions(options);
+
+		if (!SetNonBlock()) {
+			//printf("no block setting (%s:%d) error.\n", remote_ip.c_str(), remote_port);
+			Close();
+			return false;
+		}
 
     struct sockaddr_in remote = { 0 };
     remote.sin_family = AF_INET;
     remote.sin_addr.s_addr = inet_addr(remote_ip.c_str());
     remote.sin_port = htons(remote_port);
-    if (connect(socket_channel_, (sockaddr *)&remote, sizeof(remote)) < 0) {
+    if (!StartConnect((sockaddr *)&remote, sizeof(remote))) {
       //printf("connect(%s:%d) error.\n", remote_ip.c_str(), remote_port);
       Close();
       return false;
     }
-
-		if (!SetNonBlock()) {
-			//printf("no block setting (%s:%d) error.\n", remote_ip.c_str(), remote_port);
-			Close();
-			return false;
-		}
 		
 #ifdef ENABLE_OPENSSL
 		if (ssl_context_ != NULL) {
 			ssl_handle_ = SSL_new(ssl_context_->context_);
 			SSL_set_fd(ssl_handle_, socket_channel_);
 			SSL_set_connect_state(ssl_handle_);
+			ssl_context_->PrepareClientSession(ssl_handle_, remote_host + ":" + std::to_string(remote_port));
 		}
 #endif	
 
@@ -278,6 +346,100 @@ namespace lim {
     return true;
 	}
 
+	//发起非阻塞连接(连接未立即完成时标记为连接中, 由FinishConnect获取结果)
+	bool SocketChannel::StartConnect(const struct sockaddr *remote_addr, int addr_length) {
+		is_connecting_ = false;
+		if (connect(socket_channel_, remote_addr, addr_length) == 0) {
+			return true;
+		}
+
+#ifdef _WIN32
+		if (WSAGetLastError() != WSAEWOULDBLOCK) {
+			return false;
+		}
+#else
+		if (errno != EINPROGRESS) {
+			return false;
+		}
+#endif
+		is_connecting_ = true;
+		return true;
+	}
+
+	/**
+	*获取非阻塞连接的结果(socket可写或出错后调用)
+	* @param error_code 连接失败时返回错误码
+	* @return 连接失败返回-1, 连接中返回0, 连接成功返回1
+	*/
+	int SocketChannel::FinishConnect(int &error_code) {
+		error_code = 0;
+		if (!is_connecting_) {
+			return 1;
+		}
+
+		int socket_error = 0;
+#ifdef _WIN32
+		int length = sizeof(socket_error);
+#else
+		socklen_t length = sizeof(socket_error);
+#endif
+		if (getsockopt(socket_channel_, SOL_SOCKET, SO_ERROR, (char *)&socket_error, &length) != 0) {
+			socket_error = errno;
+		}
+		if (socket_error != 0) {
+			error_code = socket_error;
+			is_connecting_ = false;
+			return -1;
+		}
+
+		//错误码可能已被其他操作(如io_uring的recv)取走, 按socket的当前状态判断
+		struct pollfd poll_fd;
+		poll_fd.fd = socket_channel_;
+		poll_fd.events = POLLOUT;
+		poll_fd.revents = 0;
+#ifdef _WIN32
+		int ret = WSAPoll(&poll_fd, 1, 0);
+#else
+		int ret = poll(&poll_fd, 1, 0);
+#endif
+		//连接失败的socket已关闭发送方向, 同时带有POLLOUT, 需先判断POLLHUP
+		if (ret < 0 || (poll_fd.revents & (POLLERR | POLLHUP))) {
+			error_code = ENOTCONN;
+			is_connecting_ = false;
+			return -1;
+		}
+		if (ret > 0 && (poll_fd.revents & POLLOUT)) {
+			is_connecting_ = false;
+			return 1;
+		}
+		return 0;
+	}
+
+	/**
+	*为SO_REUSEPORT监听组附加按CPU分配连接的CBPF程序(处理软中断的CPU号对监听socket数取模, 作为组内socket的下标)
+	* @param socket_num 监听组中的socket数(组内下标按bind顺序)
+	* @return 不支持或失败返回false(仍按四元组哈希分配)
+	*/
+	bool SocketChannel::AttachReusePortCpuFilter(int socket_num) {
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+		if (-1 == socket_channel_ || socket_num <= 0) {
+			return false;
+		}
+
+		struct sock_filter code[] = {
+			{ BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU) }, //A = 当前CPU
+			{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)socket_num }, //A = A % socket_num
+			{ BPF_RET | BPF_A, 0, 0, 0 }, //返回组内下标
+		};
+		struct sock_fprog program;
+		program.len = sizeof(code) / sizeof(code[0]);
+		program.filter = code;
+		return (setsockopt(socket_channel_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0);
+#else
+		return false;
+#endif
+	}
+
 	void SocketChannel::Accept(std::vector<SocketChannel> &socket_channels) {
 		struct sockaddr_in remote_addr;
 #ifdef _WIN32 
@@ -287,27 +449,36 @@ namespace lim {
 #endif
 
 		int accept_socket_channel;
+#ifdef SOCKET_CHANNEL_ACCEPT4
+		while ((accept_socket_channel = accept4(socket_channel_, (struct sockaddr *)&remote_addr, &addr_length, SOCK_NONBLOCK | SOCK_CLOEXEC)) > 0) {
+#else
 		while ((accept_socket_channel = accept(socket_channel_, (struct sockaddr *)&remote_addr, &addr_length)) > 0) {
+#endif
+			socket_channels.push_back(AcceptedChannel(accept_socket_channel));
+			addr_length = sizeof(struct sockaddr_in);
+		}
+	}
+
+	//封装accept得到的socket句柄(设置非阻塞及SSL, accept4得到的句柄已是非阻塞)
+	SocketChannel SocketChannel::AcceptedChannel(int accept_socket_channel) {
 #ifdef ENABLE_OPENSSL
-			if (ssl_context_ != NULL) {
-				SSL *ssl_handle = SSL_new(ssl_context_->context_);
-				SSL_set_fd(ssl_handle, accept_socket_channel);
-				SSL_set_accept_state(ssl_handle);
-			
-				SocketChannel channel(accept_socket_channel, ssl_context_, ssl_handle);
-				channel.SetNonBlock();
-				socket_channels.push_back(channel);
-			} else {
-				SocketChannel channel(accept_socket_channel);
-				channel.SetNonBlock();
-				socket_channels.push_back(channel);
-			}
-#else
-			SocketChannel channel(accept_socket_channel);
+		if (ssl_context_ != NULL) {
+			SSL *ssl_handle = SSL_new(ssl_context_->context_);
+			SSL_set_fd(ssl_handle, accept_socket_channel);
+			SSL_set_accept_state(ssl_handle);
+		
+			SocketChannel channel(accept_socket_channel, ssl_context_, ssl_handle);
+#ifndef SOCKET_CHANNEL_ACCEPT4
 			channel.SetNonBlock();
-			socket_channels.push_back(channel);
 #endif
+			return channel;
 		}
+#endif
+		SocketChannel channel(accept_socket_channel);
+#ifndef SOCKET_CHANNEL_ACCEPT4
+		channel.SetNonBlock();
+#endif
+		return channel;
 	}
 	
 	bool SocketChannel::Close() {
@@ -335,6 +506,12 @@ namespace lim {
 	}
 
 	std::string SocketChannel::HostToIp(const std::string &host_name) {
+		//IP地址不需要解析
+		struct in_addr ip_addr_value;
+		if (inet_pton(AF_INET, host_name.c_str(), &ip_addr_value) == 1) {
+			return host_name;
+		}
+
 		addrinfo hints, *res;
 		memset(&hints, 0, sizeof(addrinfo));
 		hints.ai_socktype = SOCK_STREAM;
@@ -358,6 +535,100 @@ namespace lim {
 		return std::string(ip_addr);
 	}
 	
+	/**
+	*设置socket选项(非TCP连接只设置缓冲区大小, 不支持的选项跳过)
+	* @param options socket选项
+	* @param is_listen 是否为监听socket(额外设置TCP_DEFER_ACCEPT/TCP_FASTOPEN, 需在listen前调用; 否则为发起的连接, 需在connect前调用)
+	* @return 有选项设置失败返回false
+	*/
+	bool SocketChannel::SetSocketOptions(const SocketOptions &options, bool is_listen) {
+		if (-1 == socket_channel_) {
+			return false;
+		}
+
+		bool is_success = true;
+		if (options.recv_buffer_size > 0) {
+			is_success &= (setsockopt(socket_channel_, SOL_SOCKET, SO_RCVBUF, (const char *)&options.recv_buffer_size, sizeof(int)) == 0);
+		}
+		if (options.send_buffer_size > 0) {
+			is_success &= (setsockopt(socket_channel_, SOL_SOCKET, SO_SNDBUF, (const char *)&options.send_buffer_size, sizeof(int)) == 0);
+		}
+
+		//其余均为TCP选项, unix域socket跳过
+		struct sockaddr_storage local;
+#ifdef _WIN32
+		int addr_length = sizeof(local);
+#else
+		socklen_t addr_length = sizeof(local);
+#endif
+		if (getsockname(socket_channel_, (struct sockaddr *)&local, &addr_length) != 0 ||
+			(local.ss_family != AF_INET && local.ss_family != AF_INET6)) {
+			return is_success;
+		}
+
+		int flag = (options.tcp_nodelay ? 1 : 0);
+		is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_NODELAY, (const char *)&flag, sizeof(int)) == 0);
+
+		if (options.keepalive) {
+			flag = 1;
+			is_success &= (setsockopt(socket_channel_, SOL_SOCKET, SO_KEEPALIVE, (const char *)&flag, sizeof(int)) == 0);
+#ifdef TCP_KEEPIDLE
+			if (options.keepalive_idle_sec > 0) {
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_KEEPIDLE, (const char *)&options.keepalive_idle_sec, sizeof(int)) == 0);
+			}
+#endif
+#ifdef TCP_KEEPINTVL
+			if (options.keepalive_interval_sec > 0) {
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_KEEPINTVL, (const char *)&options.keepalive_interval_sec, sizeof(int)) == 0);
+			}
+#endif
+#ifdef TCP_KEEPCNT
+			if (options.keepalive_count > 0) {
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_KEEPCNT, (const char *)&options.keepalive_count, sizeof(int)) == 0);
+			}
+#endif
+		}
+
+#ifdef TCP_USER_TIMEOUT
+		if (options.user_timeout_millisec >= 0) {
+			unsigned int user_timeout = (unsigned int)options.user_timeout_millisec;
+			is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_USER_TIMEOUT, (const char *)&user_timeout, sizeof(user_timeout)) == 0);
+		}
+#endif
+
+		if (is_listen) {
+#ifdef TCP_DEFER_ACCEPT
+			if (options.defer_accept_sec > 0) {
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_DEFER_ACCEPT, (const char *)&options.defer_accept_sec, sizeof(int)) == 0);
+			}
+#endif
+#ifdef TCP_FASTOPEN
+			if (options.fastopen_queue_num > 0) {
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_FASTOPEN, (const char *)&options.fastopen_queue_num, sizeof(int)) == 0);
+			}
+#endif
+		} else {
+#ifdef TCP_FASTOPEN_CONNECT
+			//connect立即返回, SYN推迟到首次发送时携带数据发出(没有cookie时退回普通握手)
+			if (options.fastopen_connect) {
+				flag = 1;
+				is_success &= (setsockopt(socket_channel_, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, (const char *)&flag, sizeof(int)) == 0);
+			}
+#endif
+		}
+		return is_success;
+	}
+
+	//塞住/推出连接(TCP_CORK, 塞住期间不发送未满的报文段), 不支持时返回false
+	bool SocketChannel::SetCork(bool is_cork) {
+#ifdef TCP_CORK
+		int flag = (is_cork ? 1 : 0);
+		return (-1 != socket_channel_ && setsockopt(socket_channel_, IPPROTO_TCP, TCP_CORK, &flag, sizeof(flag)) == 0);
+#else
+		return false;
+#endif
+	}
+	
 	bool SocketChannel::SetNonBlock() {
 		if (-1 == socket_channel_) {
       return false;
@@ -386,8 +657,9 @@ namespace lim {
 		}
 		
 		int ret = SSL_do_handshake(ssl_handle_);
-		if (ret == 1) { //ֳɹ
+		if (ret == 1) { //握手成功
 			is_handshaked_ = true;
+			ssl_context_->HandshakeDone(ssl_handle_);
 			return true;
 		}
 		
@@ -403,23 +675,34 @@ namespace lim {
     }
 	}
 	
+	//握手后发送方向是否已由内核TLS加密(此时可直接使用send/sendmsg/sendfile发送明文)
+	bool SocketChannel::IsKernelTLSSend() {
+		if (ssl_handle_ == NULL || !is_handshaked_) {
+			return false;
+		}
+#ifdef BIO_get_ktls_send
+		return (BIO_get_ktls_send(SSL_get_wbio(ssl_handle_)) != 0);
+#else
+		return false;
+#endif
+	}
+
 	int SocketChannel::SSLReadBytes(ByteBuffer &buffer, int &waiton_flag) {
 		waiton_flag = 0;
 		if (-1 == socket_channel_ || ssl_context_ == NULL || ssl_handle_ == NULL) {
 			return -1;
 		}
 
-		int total_read_length = 0;	
-		const int kDefaultReadBufferSize = 1024;
-		char read_buffer[kDefaultReadBufferSize] = { 0 };
-		int read_buffer_size = (buffer.WritableBytes() > kDefaultReadBufferSize ? kDefaultReadBufferSize : buffer.WritableBytes());
-		
-		while (read_buffer_size > 0) {
+		//直接解密到接收缓冲区的数据区
+		int total_read_length = 0;
+		while (buffer.WritableBytes() > 0) {
+			int read_buffer_size = 0;
+			int reserve_size = (buffer.WritableBytes() < SOCKET_CHANNEL_SSL_READ_SIZE ? buffer.WritableBytes() : SOCKET_CHANNEL_SSL_READ_SIZE);
+			char *read_buffer = buffer.ReserveWritable(reserve_size, read_buffer_size);
 			int read_length = SSL_read(ssl_handle_, read_buffer, read_buffer_size);
 			if (read_length > 0) {
 				total_read_length += read_length;
-				buffer.WriteBytes(read_buffer, read_length);
-				read_buffer_size = (buffer.WritableBytes() > kDefaultReadBufferSize ? kDefaultReadBufferSize : buffer.WritableBytes());
+				buffer.CommitWrite(read_length);
 			} else {
 				int error_code = SSL_get_error(ssl_handle_, read_length);
 				if (error_code == SSL_ERROR_WANT_READ) {
@@ -441,18 +724,77 @@ namespace lim {
 			return -1;
 		}
 
+		//直接从数据区加密发送, 未发送成功的数据留在buffer中(重试时参数不变)
 		int total_write_length = 0;
-		const int kDefaultWriteBufferSize = 1024;
-		char write_buffer[kDefaultWriteBufferSize] = { 0 };
-		int write_buffer_size = (buffer.ReadableBytes() > kDefaultWriteBufferSize ? kDefaultWriteBufferSize : buffer.ReadableBytes());
-		buffer.ReadBytes(write_buffer, write_buffer_size);
+		while (buffer.ReadableBytes() > 0) {
+			int write_length = SSL_write(ssl_handle_, buffer.ReadableData(), buffer.ReadableBytes());
+			if (write_length > 0) {
+				total_write_length += write_length;
+				buffer.SkipBytes(write_length);
+			} else {
+				int error_code = SSL_get_error(ssl_handle_, write_length);
+				if (error_code == SSL_ERROR_WANT_READ) {
+					waiton_flag = SSL_ERROR_WANT_READ;
+				} else if (error_code == SSL_ERROR_WANT_WRITE) {
+					waiton_flag = SSL_ERROR_WANT_WRITE;
+				} else {
+					total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+				}
+				break;
+			}
+		}
+		return total_write_length;
+	}
+
+	int SocketChannel::SSLWriteBytes(CompositeByteBuffer &buffer, int &waiton_flag) {
+		waiton_flag = 0;
+		if (-1 == socket_channel_ || ssl_context_ == NULL || ssl_handle_ == NULL) {
+			return -1;
+		}
+
+		//直接从组件数据区加密发送, 未发送成功的数据留在buffer中(重试时参数不变)
+		int total_write_length = 0;
+		while (buffer.ComponentNum() > 0) {
+			ByteBuffer &component = buffer.Component(0);
+			int write_length = SSL_write(ssl_handle_, component.ReadableData(), component.ReadableBytes());
+			if (write_length > 0) {
+				total_write_length += write_length;
+				buffer.SkipBytes(write_length);
+			} else {
+				int error_code = SSL_get_error(ssl_handle_, write_length);
+				if (error_code == SSL_ERROR_WANT_READ) {
+					waiton_flag = SSL_ERROR_WANT_READ;
+				} else if (error_code == SSL_ERROR_WANT_WRITE) {
+					waiton_flag = SSL_ERROR_WANT_WRITE;
+				} else {
+					total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+				}
+				break;
+			}
+		}
+		return total_write_length;
+	}
 
-		while (write_buffer_size > 0) {
-			int write_length = SSL_write(ssl_handle_, write_buffer, write_buffer_size);
+	//分块读取文件后加密发送(未发送成功的数据块保留在region中, 重试时参数不变)
+	int64_t SocketChannel::SSLWriteFile(FileRegion &region, int &waiton_flag) {
+		waiton_flag = 0;
+		if (-1 == socket_channel_ || ssl_context_ == NULL || ssl_handle_ == NULL) {
+			return -1;
+		}
+
+		int64_t total_write_length = 0;
+		while (region.ReadableBytes() > 0) {
+			int chunk_size = 0;
+			char *chunk = region.ReadableChunk(chunk_size);
+			if (chunk == NULL) { //文件被截断或读取出错
+				total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+				break;
+			}
+
+			int write_length = SSL_write(ssl_handle_, chunk, chunk_size);
 			if (write_length > 0) {
 				total_write_length += write_length;
-				write_buffer_size = (buffer.ReadableBytes() > kDefaultWriteBufferSize ? kDefaultWriteBufferSize : buffer.ReadableBytes());
-				buffer.ReadBytes(write_buffer, write_buffer_size);
+				region.SkipBytes(write_length);
 			} else {
 				int error_code = SSL_get_error(ssl_handle_, write_length);
 				if (error_code == SSL_ERROR_WANT_READ) {
@@ -473,7 +815,7 @@ namespace lim {
 			return false;
 		}
 		
-    //Ҫ֤HostName
+    //不需要验证HostName
     if (!ssl_context_->IsVerifyHostName()) {
       return true;
     }
@@ -553,17 +895,39 @@ namespace lim {
       return -1;
     }
 
+		//直接接收到数据区, 数据区尾部空间不足时同时读入栈上的扩展缓冲区(一次系统调用读取更多数据)
 		int total_read_length = 0;
-		const int kDefaultReadBufferSize = 1024;
-		char read_buffer[kDefaultReadBufferSize] = { 0 };
-		int read_buffer_size = (buffer.WritableBytes() > kDefaultReadBufferSize ? kDefaultReadBufferSize : buffer.WritableBytes());
-
-		while (read_buffer_size > 0) {
+		char extra_buffer[SOCKET_CHANNEL_EXTRA_READ_SIZE];
+		while (buffer.WritableBytes() > 0) {
+			int read_buffer_size = 0;
+			int reserve_size = (buffer.WritableBytes() < SOCKET_CHANNEL_READ_SIZE ? buffer.WritableBytes() : SOCKET_CHANNEL_READ_SIZE);
+			char *read_buffer = buffer.ReserveWritable(reserve_size, read_buffer_size);
+			int extra_buffer_size = buffer.WritableBytes() - read_buffer_size;
+			extra_buffer_size = (extra_buffer_size < SOCKET_CHANNEL_EXTRA_READ_SIZE ? extra_buffer_size : SOCKET_CHANNEL_EXTRA_READ_SIZE);
+#ifndef _WIN32
+			struct iovec iov[2];
+			iov[0].iov_base = read_buffer;
+			iov[0].iov_len = read_buffer_size;
+			iov[1].iov_base = extra_buffer;
+			iov[1].iov_len = extra_buffer_size;
+			int read_length = (int)readv(socket_channel_, iov, (extra_buffer_size > 0 ? 2 : 1));
+#else
+			extra_buffer_size = 0;
 			int read_length = recv(socket_channel_, read_buffer, read_buffer_size, 0);
+#endif
 			if (read_length > 0) {
 				total_read_length += read_length;
-				buffer.WriteBytes(read_buffer, read_length);
-				read_buffer_size = (buffer.WritableBytes() > kDefaultReadBufferSize ? kDefaultReadBufferSize : buffer.WritableBytes());
+				if (read_length <= read_buffer_size) {
+					buffer.CommitWrite(read_length);
+				} else {
+					buffer.CommitWrite(read_buffer_size);
+					buffer.WriteBytes(extra_buffer, read_length - read_buffer_size);
+				}
+
+				//没有读满说明内核接收缓冲区已读完(边缘触发下新数据到达时会再次通知)
+				if (read_length < read_buffer_size + extra_buffer_size) {
+					break;
+				}
 			} else if (read_length == 0) {//socket closed
 				total_read_length = (total_read_length == 0 ? -1 : total_read_length);
 				break;
@@ -587,18 +951,186 @@ namespace lim {
       return -1;
     }
 
+		//直接从数据区发送, 按实际发送的字节数移动读偏移, 发送缓冲区满时未发送的数据留在buffer中
 		int total_write_length = 0;
-		const int kDefaultWriteBufferSize = 1024;
-		char write_buffer[kDefaultWriteBufferSize] = { 0 };
-		int write_buffer_size = (buffer.ReadableBytes() > kDefaultWriteBufferSize ? kDefaultWriteBufferSize : buffer.ReadableBytes());
-		buffer.ReadBytes(write_buffer, write_buffer_size);
+		while (buffer.ReadableBytes() > 0) {
+			int write_buffer_size = buffer.ReadableBytes();
+			int write_length = send(socket_channel_, buffer.ReadableData(), write_buffer_size, 0);
+			if (write_length > 0) {
+				total_write_length += write_length;
+				buffer.SkipBytes(write_length);
+				if (write_length < write_buffer_size) { //发送缓冲区已满
+					break;
+				}
+			} else if (write_length == 0) {//socket closed
+				total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+				break;
+			} else {
+#ifndef _WIN32
+				if (errno != EAGAIN)
+#else
+				if (GetLastError() != WSAEWOULDBLOCK)
+#endif 
+					total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+
+				break;
+			}
+		}
+
+		return total_write_length;
+	}
+
+	//按组件聚集写(一次系统调用发送多个组件, 发送缓冲区满时未发送的数据留在buffer中)
+	int SocketChannel::WriteBytes(CompositeByteBuffer &buffer) {
+		CompositeByteBuffer *buffers[1] = { &buffer };
+		return WriteBytes(buffers, 1);
+	}
+
+	/**
+	*按顺序聚集写多个缓冲区(一次系统调用最多发送SOCKET_CHANNEL_IOV_NUM个组件)
+	* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+	* @param buffer_num 缓冲区个数
+	* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+	*/
+	int SocketChannel::WriteBytes(CompositeByteBuffer **buffers, int buffer_num) {
+		int zero_copy_num = 0;
+		return GatherWriteBytes(buffers, buffer_num, NULL, zero_copy_num);
+	}
 
-		while (write_buffer_size > 0) {
-			int write_length = send(socket_channel_, write_buffer, write_buffer_size, 0);
+	//启用零拷贝发送(SO_ZEROCOPY, Linux 4.14及以上), 不支持时返回false
+	bool SocketChannel::EnableZeroCopy() {
+#ifdef SOCKET_CHANNEL_ZERO_COPY
+		int flag = 1;
+		return (-1 != socket_channel_ && setsockopt(socket_channel_, SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(flag)) == 0);
+#else
+		return false;
+#endif
+	}
+
+	/**
+	*以MSG_ZEROCOPY聚集写多个缓冲区(已发送的数据以共享切片移入zero_copy_buffer, 收到完成通知前必须保持有效)
+	* @param buffers 发送缓冲区数组, 按发送的字节数依次消费
+	* @param buffer_num 缓冲区个数
+	* @param zero_copy_buffer 追加已发送数据的共享切片
+	* @param zero_copy_num 返回成功的零拷贝发送次数(每次发送占用一个完成通知序号)
+	* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+	*/
+	int SocketChannel::WriteBytes(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer &zero_copy_buffer, int &zero_copy_num) {
+		zero_copy_num = 0;
+		return GatherWriteBytes(buffers, buffer_num, &zero_copy_buffer, zero_copy_num);
+	}
+
+	/**
+	*读取错误队列中的零拷贝完成通知
+	* @param complete_seq 传入已知的下一个未完成发送序号, 返回更新后的值(取各通知中的最大值, 序号回绕安全)
+	* @return 出错返回-1, 否则返回读取的通知数
+	*/
+	int SocketChannel::ReadZeroCopyCompletions(uint32_t &complete_seq) {
+#ifdef SOCKET_CHANNEL_ZERO_COPY
+		if (-1 == socket_channel_) {
+			return -1;
+		}
+
+		int completion_num = 0;
+		while (true) {
+			char control[128];
+			struct msghdr msg;
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_control = control;
+			msg.msg_controllen = sizeof(control);
+			if (recvmsg(socket_channel_, &msg, MSG_ERRQUEUE) == -1) {
+				return (errno == EAGAIN ? completion_num : -1);
+			}
+
+			for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+				if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+					!(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+					continue;
+				}
+
+				//ee_info~ee_data为本次通知完成的发送序号范围
+				struct sock_extended_err *error = (struct sock_extended_err*)CMSG_DATA(cmsg);
+				if (error->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+					//通知可能乱序到达, 只向前推进(按回绕比较)
+					if ((int32_t)(error->ee_data + 1 - complete_seq) > 0) {
+						complete_seq = error->ee_data + 1;
+					}
+					completion_num++;
+				}
+			}
+		}
+#else
+		return 0;
+#endif
+	}
+
+	//聚集写多个缓冲区(zero_copy_buffer非NULL时以MSG_ZEROCOPY发送)
+	int SocketChannel::GatherWriteBytes(CompositeByteBuffer **buffers, int buffer_num, CompositeByteBuffer *zero_copy_buffer, int &zero_copy_num) {
+		if (-1 == socket_channel_) {
+      return -1;
+    }
+
+		int total_write_length = 0;
+		int first_buffer = 0;
+		while (true) {
+			while (first_buffer < buffer_num && buffers[first_buffer]->ReadableBytes() == 0) {
+				first_buffer++;
+			}
+			if (first_buffer == buffer_num) {
+				break;
+			}
+
+			int write_buffer_size = 0;
+			int iov_num = 0;
+#ifndef _WIN32
+			struct iovec iov[SOCKET_CHANNEL_IOV_NUM];
+			for (int i = first_buffer; i < buffer_num && iov_num < SOCKET_CHANNEL_IOV_NUM; i++) {
+				for (int j = 0; j < buffers[i]->ComponentNum() && iov_num < SOCKET_CHANNEL_IOV_NUM; j++) {
+					iov[iov_num].iov_base = buffers[i]->Component(j).ReadableData();
+					iov[iov_num].iov_len = buffers[i]->Component(j).ReadableBytes();
+					write_buffer_size += (int)iov[iov_num++].iov_len;
+				}
+			}
+
+			struct msghdr msg;
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = iov;
+			msg.msg_iovlen = iov_num;
+			int flags = 0;
+#ifdef SOCKET_CHANNEL_ZERO_COPY
+			flags = (zero_copy_buffer != NULL ? MSG_ZEROCOPY : 0);
+#endif
+			int write_length = (int)sendmsg(socket_channel_, &msg, flags);
+#ifdef SOCKET_CHANNEL_ZERO_COPY
+			if (write_length == -1 && errno == ENOBUFS && zero_copy_buffer != NULL) { //未完成的通知过多(超过optmem限制), 本次拷贝发送
+				zero_copy_buffer = NULL;
+				continue;
+			}
+#endif
+#else
+			WSABUF wsa_buffers[SOCKET_CHANNEL_IOV_NUM];
+			for (int i = first_buffer; i < buffer_num && iov_num < SOCKET_CHANNEL_IOV_NUM; i++) {
+				for (int j = 0; j < buffers[i]->ComponentNum() && iov_num < SOCKET_CHANNEL_IOV_NUM; j++) {
+					wsa_buffers[iov_num].buf = buffers[i]->Component(j).ReadableData();
+					wsa_buffers[iov_num].len = buffers[i]->Component(j).ReadableBytes();
+					write_buffer_size += (int)wsa_buffers[iov_num++].len;
+				}
+			}
+
+			DWORD send_length = 0;
+			int write_length = (WSASend(socket_channel_, wsa_buffers, iov_num, &send_length, 0, NULL, NULL) == 0 ? (int)send_length : -1);
+#endif
 			if (write_length > 0) {
 				total_write_length += write_length;
-				write_buffer_size = (buffer.ReadableBytes() > kDefaultWriteBufferSize ? kDefaultWriteBufferSize : buffer.ReadableBytes());
-				buffer.ReadBytes(write_buffer, write_buffer_size);
+				//按顺序消费已发送的数据(零拷贝发送的数据移入zero_copy_buffer, 完成前保持有效)
+				for (int i = first_buffer, length = write_length; i < buffer_num && length > 0; i++) {
+					length -= (zero_copy_buffer != NULL ? buffers[i]->ReadSharedSlices(*zero_copy_buffer, length) : buffers[i]->SkipBytes(length));
+				}
+				zero_copy_num += (zero_copy_buffer != NULL ? 1 : 0);
+
+				if (write_length < write_buffer_size) { //发送缓冲区已满
+					break;
+				}
 			} else if (write_length == 0) {//socket closed
 				total_write_length = (total_write_length == 0 ? -1 : total_write_length);
 				break;
@@ -617,6 +1149,70 @@ namespace lim {
 		return total_write_length;
 	}
 
+	/**
+	*发送文件区域(Linux下由sendfile在内核中直接发送, 不支持时分块读取后发送)
+	* @param region 文件区域, 按发送的字节数消费
+	* @return 连接关闭或出错返回-1, 否则返回发送的字节数
+	*/
+	int64_t SocketChannel::WriteFile(FileRegion &region) {
+		if (-1 == socket_channel_ || !region.IsOpen()) {
+      return -1;
+    }
+
+#ifdef __linux__
+		bool is_chunked = false;
+#else
+		bool is_chunked = true;
+#endif
+		int64_t total_write_length = 0;
+		while (region.ReadableBytes() > 0) {
+			int64_t write_file_size = 0;
+			int64_t write_length = 0;
+			if (!is_chunked) {
+#ifdef __linux__
+				write_file_size = (region.ReadableBytes() < SOCKET_CHANNEL_SENDFILE_SIZE ? region.ReadableBytes() : SOCKET_CHANNEL_SENDFILE_SIZE);
+				off_t offset = (off_t)region.GetPosition();
+				write_length = sendfile(socket_channel_, region.GetFd(), &offset, (size_t)write_file_size);
+				if (write_length == -1 && (errno == EINVAL || errno == ENOSYS)) { //文件不支持sendfile, 改为分块读取后发送
+					is_chunked = true;
+					continue;
+				}
+#endif
+			} else {
+				int chunk_size = 0;
+				char *chunk = region.ReadableChunk(chunk_size);
+				if (chunk == NULL) { //文件被截断或读取出错
+					total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+					break;
+				}
+				write_file_size = chunk_size;
+				write_length = send(socket_channel_, chunk, chunk_size, 0);
+			}
+
+			if (write_length > 0) {
+				total_write_length += write_length;
+				region.SkipBytes(write_length);
+				if (write_length < write_file_size) { //发送缓冲区已满
+					break;
+				}
+			} else if (write_length == 0) {//socket closed(或文件被截断)
+				total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+				break;
+			} else {
+#ifndef _WIN32
+				if (errno != EAGAIN)
+#else
+				if (GetLastError() != WSAEWOULDBLOCK)
+#endif 
+					total_write_length = (total_write_length == 0 ? -1 : total_write_length);
+
+				break;
+			}
+		}
+
+		return total_write_length;
+	}
+
 	std::string SocketChannel::ToString() {
 		std::stringstream ss;
 		ss << "channel_id: " << socket_channel_;
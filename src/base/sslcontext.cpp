@@ -1,12 +1,127 @@
 #include <lim/base/sslcontext.h>
+#include <lim/base/time_utils.h>
+#include <string.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
 
 namespace lim {
-  SSLContext::SSLContext(bool is_client): is_verify_host_name_(false) {
+  #define SSL_SESSION_ID_CONTEXT "lim" /***服务端会话ID上下文, 复用会话时校验***/
+  #define SSL_SESSION_DEFAULT_TIMEOUT 300 /***默认会话有效时间(秒)***/
+
+  SSLSessionCache::SSLSessionCache(): shard_capacity_(0), timeout_sec_(SSL_SESSION_DEFAULT_TIMEOUT) {
+  }
+
+  /**
+  *设置缓存容量
+  * @param max_session_num 最大会话数(平均分配到各分片)
+  * @param timeout_sec 会话缓存时间(秒)
+  */
+  void SSLSessionCache::SetCapacity(int max_session_num, int timeout_sec) {
+    shard_capacity_ = (max_session_num + SSL_SESSION_CACHE_SHARD_NUM - 1) / SSL_SESSION_CACHE_SHARD_NUM;
+    timeout_sec_ = timeout_sec;
+  }
+
+  void SSLSessionCache::Put(const std::string &key, const std::string &session_data) {
+    if (shard_capacity_ <= 0) {
+      return;
+    }
+
+    CacheShard &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.entries.find(key);
+    if (iter != shard.entries.end()) {
+      shard.lru_list.erase(iter->second);
+      shard.entries.erase(iter);
+    }
+    //超出容量时淘汰最久未使用的会话
+    while ((int)shard.entries.size() >= shard_capacity_) {
+      shard.entries.erase(shard.lru_list.back().key);
+      shard.lru_list.pop_back();
+    }
+
+    CacheEntry entry;
+    entry.key = key;
+    entry.session_data = session_data;
+    entry.expire_time = SteadyMicroTime() + (int64_t)timeout_sec_ * 1000000;
+    shard.lru_list.push_front(entry);
+    shard.entries[key] = shard.lru_list.begin();
+  }
+
+  /**
+  *查询会话
+  * @param key 会话key
+  * @param session_data 返回序列化后的会话
+  * @return 未命中或已过期返回false
+  */
+  bool SSLSessionCache::Get(const std::string &key, std::string &session_data) {
+    CacheShard &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.entries.find(key);
+    if (iter == shard.entries.end()) {
+      return false;
+    }
+    if (iter->second->expire_time <= SteadyMicroTime()) {
+      shard.lru_list.erase(iter->second);
+      shard.entries.erase(iter);
+      return false;
+    }
+
+    shard.lru_list.splice(shard.lru_list.begin(), shard.lru_list, iter->second);
+    session_data = iter->second->session_data;
+    return true;
+  }
+
+  void SSLSessionCache::Remove(const std::string &key) {
+    CacheShard &shard = GetShard(key);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.entries.find(key);
+    if (iter != shard.entries.end()) {
+      shard.lru_list.erase(iter->second);
+      shard.entries.erase(iter);
+    }
+  }
+
+  SSLSessionCache::CacheShard &SSLSessionCache::GetShard(const std::string &key) {
+    return shards_[std::hash<std::string>()(key) % SSL_SESSION_CACHE_SHARD_NUM];
+  }
+
+  //序列化会话
+  static std::string SessionToBytes(SSL_SESSION *session) {
+    int length = i2d_SSL_SESSION(session, NULL);
+    if (length <= 0) {
+      return std::string();
+    }
+    std::string session_data(length, '\0');
+    unsigned char *data = (unsigned char*)&session_data[0];
+    i2d_SSL_SESSION(session, &data);
+    return session_data;
+  }
+
+  static SSL_SESSION *BytesToSession(const std::string &session_data) {
+    const unsigned char *data = (const unsigned char*)session_data.data();
+    return d2i_SSL_SESSION(NULL, &data, (long)session_data.size());
+  }
+
+  static void FreeSessionKey(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int index, long argl, void *argp) {
+    delete (std::string*)ptr;
+  }
+
+  SSLContext::SSLContext(bool is_client): is_verify_host_name_(false), is_session_cache_(false),
+    ticket_key_num_(0), ticket_rotation_sec_(0), handshake_num_(0), resumed_num_(0),
+    cache_hit_num_(0), cache_miss_num_(0) {
     is_client_ = is_client;
 		if (is_client)
 			context_ = SSL_CTX_new(SSLv23_client_method());
 		else
 			context_ = SSL_CTX_new(SSLv23_server_method());
+    SSL_CTX_set_app_data(context_, this);
+    if (!is_client) {
+      SSL_CTX_set_session_id_context(context_, (const unsigned char*)SSL_SESSION_ID_CONTEXT, strlen(SSL_SESSION_ID_CONTEXT));
+    }
 	}
 
   SSLContext::~SSLContext() {
@@ -14,8 +129,8 @@ namespace lim {
 	}
 
 	/**
-	*SSLʼ
-	* @return ʧܷfalse, ɹtrue
+	*SSL环境初始化
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::InitEnviroment() {
 		SSL_library_init(); 
@@ -25,18 +140,18 @@ namespace lim {
 	}
 
 	/**
-	*SSL
-	* @return ʧܷfalse, ɹtrue
+	*SSL环境销毁
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::FreeEnviroment() {
 		return true;
 	}
 	
 	/**
-	*CA֤
-	* @param ca_file һ PEM ʽ֤ļ·()
-	* @param ca_path һ PEM ʽļ·ļʹضĸʽ(Ϊ)
-	* @return ʧܷfalse, ɹtrue
+	*加载CA证书
+	* @param ca_file 包含一个或多个 PEM 格式的证书的文件的路径(必需)
+	* @param ca_path 一个或多个 PEM 格式文件的路径，不过文件名必须使用特定的格式(可为空)
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::LoadCALocations(const std::string &ca_file, const std::string &ca_path) {
 		const char *char_ca_file = (ca_file.empty() ? NULL : ca_file.c_str());
@@ -48,9 +163,9 @@ namespace lim {
 	}
 
 	/**
-	*֤飬ڷ͸Զ
-	* @param certificate_file PEM ʽ֤ļ
-	* @return ʧܷfalse, ɹtrue
+	*加载数字证书，用于发送给对端
+	* @param certificate_file PEM 格式数字证书文件
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::LoadCertificateFile(const std::string &certificate_file) {
 		if (SSL_CTX_use_certificate_file(context_, certificate_file.c_str(), SSL_FILETYPE_PEM) <= 0)
@@ -60,9 +175,9 @@ namespace lim {
 	}
 
 	/**
-	*˽Կļ
-	* @param private_key_file PEM ʽ˽Կļ
-	* @return ʧܷfalse, ɹtrue
+	*加载私钥文件
+	* @param private_key_file PEM 格式私钥文件
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::LoadPrivateKeyFile(const std::string &private_key_file) {
 		if (SSL_CTX_use_PrivateKey_file(context_, private_key_file.c_str(), SSL_FILETYPE_PEM) <= 0)
@@ -72,8 +187,8 @@ namespace lim {
 	}
 
 	/**
-	*֤ص˽Կ֤Ƿƥ
-	* @return ʧܷfalse, ɹtrue
+	*验证所加载的私钥和证书是否相匹配
+	* @return 失败返回false, 成功返回true
 	*/
 	bool SSLContext::CheckPrivateKey() {
 		if (!SSL_CTX_check_private_key(context_))
@@ -83,8 +198,8 @@ namespace lim {
 	}
 
 	/**
-	*Ƿ֤Զ
-	* @param is_verify_peer, Ƿ֤Զ
+	*设置是否验证对端
+	* @param is_verify_peer, 是否验证对端
 	*/
 	void SSLContext::SetVerifyPeer(int is_verify_peer) {
 		if (is_verify_peer) {
@@ -99,8 +214,8 @@ namespace lim {
 	}
 
   /**
-  *ǷУHostNameֻClientģʽ
-  * @param is_verify_host_name ǷУHostName
+  *是否校验HostName（只适用于Client模式）
+  * @param is_verify_host_name 是否校验HostName
   */
   void SSLContext::SetVerifyHostName(bool is_verify_host_name) {
     if (is_client_) {
@@ -115,5 +230,268 @@ namespace lim {
       return false;
     }
   }
-}
 
+  /**
+  *设置是否启用内核TLS(kTLS, 握手后由内核加解密记录, 需OpenSSL 3.0及内核tls模块支持, 不支持的加密套件仍在用户态加密)
+  * @param is_kernel_tls 是否启用内核TLS
+  * @return OpenSSL不支持时返回false
+  */
+  bool SSLContext::SetKernelTLS(bool is_kernel_tls) {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    if (is_kernel_tls) {
+      SSL_CTX_set_options(context_, SSL_OP_ENABLE_KTLS);
+    } else {
+      SSL_CTX_clear_options(context_, SSL_OP_ENABLE_KTLS);
+    }
+    return true;
+#else
+    return !is_kernel_tls;
+#endif
+  }
+
+  /**
+  *启用会话缓存(所有EventLoop共享同一个SSLContext, 因此共享同一份缓存)
+  * 服务端: 按会话ID缓存会话, 替代OpenSSL内置的单锁缓存
+  * 客户端: 按"主机:端口"缓存服务端下发的会话, Connect时自动复用
+  * @param max_session_num 最大会话数
+  * @param timeout_sec 会话有效时间(秒)
+  */
+  void SSLContext::SetSessionCache(int max_session_num, int timeout_sec) {
+    session_cache_.SetCapacity(max_session_num, timeout_sec);
+    is_session_cache_ = (max_session_num > 0);
+    if (!is_session_cache_) {
+      SSL_CTX_set_session_cache_mode(context_, (is_client_ ? SSL_SESS_CACHE_OFF : SSL_SESS_CACHE_SERVER));
+      SSL_CTX_sess_set_new_cb(context_, NULL);
+      SSL_CTX_sess_set_get_cb(context_, NULL);
+      SSL_CTX_sess_set_remove_cb(context_, NULL);
+      return;
+    }
+
+    SSL_CTX_set_timeout(context_, timeout_sec);
+    SSL_CTX_sess_set_new_cb(context_, NewSessionCallback);
+    if (is_client_) {
+      SSL_CTX_set_session_cache_mode(context_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+    } else {
+      SSL_CTX_set_session_cache_mode(context_, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_get_cb(context_, GetSessionCallback);
+      SSL_CTX_sess_set_remove_cb(context_, RemoveSessionCallback);
+    }
+  }
+
+  /**
+  *设置会话票据密钥轮换周期(只适用于Server模式), 旧密钥在之后的轮换周期内仍可解密票据(并签发新票据)
+  * @param rotation_sec 轮换周期(秒), 小于等于0时关闭会话票据, 只通过会话缓存复用
+  * @return 失败返回false
+  */
+  bool SSLContext::SetTicketKeyRotation(int rotation_sec) {
+    if (is_client_) {
+      return false;
+    }
+
+    if (rotation_sec <= 0) {
+      SSL_CTX_set_options(context_, SSL_OP_NO_TICKET);
+      return true;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(ticket_mutex_);
+      ticket_rotation_sec_ = rotation_sec;
+    }
+    RotateTicketKeys();
+    SSL_CTX_clear_options(context_, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    return SSL_CTX_set_tlsext_ticket_key_evp_cb(context_, TicketKeyCallback) == 1;
+#else
+    return SSL_CTX_set_tlsext_ticket_key_cb(context_, TicketKeyCallback) == 1;
+#endif
+  }
+
+  //立即生成新的会话票据密钥
+  void SSLContext::RotateTicketKeys() {
+    std::lock_guard<std::mutex> guard(ticket_mutex_);
+    AddTicketKey();
+  }
+
+  //获取会话复用统计
+  void SSLContext::GetSessionStats(SSLSessionStats &stats) {
+    stats.handshake_num = handshake_num_;
+    stats.resumed_num = resumed_num_;
+    stats.cache_hit_num = cache_hit_num_;
+    stats.cache_miss_num = cache_miss_num_;
+  }
+
+  /**
+  *客户端连接前设置待复用的会话
+  * @param ssl_handle SSL连接
+  * @param session_key 会话key("主机:端口")
+  */
+  void SSLContext::PrepareClientSession(SSL *ssl_handle, const std::string &session_key) {
+    if (!is_client_ || !is_session_cache_) {
+      return;
+    }
+
+    //保存会话key, 会话(TLS1.3为握手后的NewSessionTicket)到达时按key缓存
+    SSL_set_ex_data(ssl_handle, SessionKeyIndex(), new std::string(session_key));
+
+    std::string session_data;
+    if (!session_cache_.Get(session_key, session_data)) {
+      cache_miss_num_++;
+      return;
+    }
+    cache_hit_num_++;
+
+    SSL_SESSION *session = BytesToSession(session_data);
+    if (session != NULL) {
+      SSL_set_session(ssl_handle, session);
+      SSL_SESSION_free(session);
+    }
+  }
+
+  //握手完成, 更新统计
+  void SSLContext::HandshakeDone(SSL *ssl_handle) {
+    handshake_num_++;
+    if (SSL_session_reused(ssl_handle)) {
+      resumed_num_++;
+    }
+  }
+
+  int SSLContext::NewSessionCallback(SSL *ssl_handle, SSL_SESSION *session) {
+    SSLContext *context = (SSLContext*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl_handle));
+    std::string session_key;
+    if (context->is_client_) {
+      std::string *key = (std::string*)SSL_get_ex_data(ssl_handle, SessionKeyIndex());
+      if (key == NULL) {
+        return 0;
+      }
+      session_key = *key;
+    } else {
+      unsigned int length = 0;
+      const unsigned char *session_id = SSL_SESSION_get_id(session, &length);
+      session_key.assign((const char*)session_id, length);
+    }
+
+    std::string session_data = SessionToBytes(session);
+    if (!session_data.empty()) {
+      context->session_cache_.Put(session_key, session_data);
+    }
+    return 0; //不持有session引用
+  }
+
+  SSL_SESSION *SSLContext::GetSessionCallback(SSL *ssl_handle, const unsigned char *session_id, int length, int *copy) {
+    SSLContext *context = (SSLContext*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl_handle));
+    *copy = 0; //返回新反序列化的会话, 引用交给OpenSSL
+
+    std::string session_data;
+    if (!context->session_cache_.Get(std::string((const char*)session_id, length), session_data)) {
+      context->cache_miss_num_++;
+      return NULL;
+    }
+    context->cache_hit_num_++;
+    return BytesToSession(session_data);
+  }
+
+  void SSLContext::RemoveSessionCallback(SSL_CTX *ssl_context, SSL_SESSION *session) {
+    SSLContext *context = (SSLContext*)SSL_CTX_get_app_data(ssl_context);
+    unsigned int length = 0;
+    const unsigned char *session_id = SSL_SESSION_get_id(session, &length);
+    context->session_cache_.Remove(std::string((const char*)session_id, length));
+  }
+
+  /**
+  *会话票据加解密回调
+  * @return 加密成功返回1; 解密时密钥不存在返回0(完整握手), 当前密钥返回1, 旧密钥返回2(复用并签发新票据)
+  */
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  int SSLContext::TicketKeyCallback(SSL *ssl_handle, unsigned char *key_name, unsigned char *iv,
+    EVP_CIPHER_CTX *cipher_context, EVP_MAC_CTX *mac_context, int is_encrypt) {
+#else
+  int SSLContext::TicketKeyCallback(SSL *ssl_handle, unsigned char *key_name, unsigned char *iv,
+    EVP_CIPHER_CTX *cipher_context, HMAC_CTX *hmac_context, int is_encrypt) {
+#endif
+    SSLContext *context = (SSLContext*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl_handle));
+    TicketKey key;
+    int ret = context->FindTicketKey(key_name, is_encrypt != 0, key);
+    if (ret < 0) {
+      return (is_encrypt ? -1 : 0);
+    }
+
+    if (is_encrypt) {
+      if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1 ||
+        !EVP_EncryptInit_ex(cipher_context, EVP_aes_256_cbc(), NULL, key.aes_key, iv)) {
+        return -1;
+      }
+    } else if (!EVP_DecryptInit_ex(cipher_context, EVP_aes_256_cbc(), NULL, key.aes_key, iv)) {
+      return -1;
+    }
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    OSSL_PARAM params[3];
+    params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmac_key, sizeof(key.hmac_key));
+    params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char*)"SHA256", 0);
+    params[2] = OSSL_PARAM_construct_end();
+    if (!EVP_MAC_CTX_set_params(mac_context, params)) {
+      return -1;
+    }
+#else
+    if (!HMAC_Init_ex(hmac_context, key.hmac_key, sizeof(key.hmac_key), EVP_sha256(), NULL)) {
+      return -1;
+    }
+#endif
+    return (is_encrypt || ret == 0 ? 1 : 2);
+  }
+
+  //客户端会话key在SSL连接上的扩展数据索引
+  int SSLContext::SessionKeyIndex() {
+    static int index = SSL_get_ex_new_index(0, NULL, NULL, NULL, FreeSessionKey);
+    return index;
+  }
+
+  /**
+  *查找会话票据密钥(加密时按轮换周期自动轮换)
+  * @param key_name 加密时返回密钥名称, 解密时传入票据中的密钥名称
+  * @param key 返回密钥
+  * @return 解密时密钥不存在返回-1, 为当前密钥返回0, 为旧密钥返回1
+  */
+  int SSLContext::FindTicketKey(unsigned char *key_name, bool is_encrypt, TicketKey &key) {
+    std::lock_guard<std::mutex> guard(ticket_mutex_);
+    if (is_encrypt && (ticket_key_num_ == 0 ||
+      SteadyMicroTime() - ticket_keys_[0].create_time >= (int64_t)ticket_rotation_sec_ * 1000000)) {
+      AddTicketKey();
+    }
+
+    if (ticket_key_num_ == 0) {
+      return -1;
+    }
+    if (is_encrypt) {
+      key = ticket_keys_[0];
+      memcpy(key_name, key.name, sizeof(key.name));
+      return 0;
+    }
+
+    for (int i = 0; i < ticket_key_num_; i++) {
+      if (memcmp(key_name, ticket_keys_[i].name, sizeof(ticket_keys_[i].name)) == 0) {
+        key = ticket_keys_[i];
+        return (i == 0 ? 0 : 1);
+      }
+    }
+    return -1;
+  }
+
+  //生成新密钥作为当前密钥, 淘汰最旧的密钥(调用方持有ticket_mutex_)
+  void SSLContext::AddTicketKey() {
+    TicketKey key;
+    if (RAND_bytes(key.name, sizeof(key.name)) != 1 || RAND_bytes(key.aes_key, sizeof(key.aes_key)) != 1 ||
+      RAND_bytes(key.hmac_key, sizeof(key.hmac_key)) != 1) {
+      return;
+    }
+    key.create_time = SteadyMicroTime();
+
+    for (int i = SSL_TICKET_KEY_NUM - 1; i > 0; i--) {
+      ticket_keys_[i] = ticket_keys_[i - 1];
+    }
+    ticket_keys_[0] = key;
+    if (ticket_key_num_ < SSL_TICKET_KEY_NUM) {
+      ticket_key_num_++;
+    }
+  }
+}
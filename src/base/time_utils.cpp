@@ -11,6 +11,12 @@ namespace lim {
     return tmp.count();
   }
 
+  //单调时钟(微秒),用于定时器截止时间
+  int64_t SteadyMicroTime() {
+    auto tmp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    return tmp.count();
+  }
+
 	std::string GetCurrentTimeString(const char* format) {
 		int64_t millisec = CurrentMilliTime();
 		return TimeToString(millisec, format);
@@ -27,41 +33,41 @@ namespace lim {
 	
 		const int kArrayDaysPerMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
-		//ǰʱʱ
+		//当前时间加上时区
 		if (tb_time.dstflag == 0) {
 			tb_time.time -= tb_time.timezone*60;
 		}
 	
-		//ȡʱ
+		//取秒时间
 		tm_time.tm_sec = tb_time.time%60;
 	
-		//ȡʱ
+		//取分钟时间
 		tm_time.tm_min = (tb_time.time/60)%60;
 
-		//ȡȥٸСʱ
+		//取过去多少个小时
 		int total_hours = (int)(tb_time.time/3600);
 
-		//ȡȥٸ
+		//取过去多少个四年
 		int four_year_count = total_hours /((365*4+1) * 24L);
 	
-		//
+		//计算年份
 		tm_time.tm_year = (four_year_count << 2)+70;
 		
-		//ʣµСʱ
+		//四年中剩下的小时数
 		int left_hours = total_hours %((365*4+1) * 24L);
 
-		//ȡһڵĵڼ(1970-1-14)
+		//取一星期的第几天(1970-1-1是4)
 		tm_time.tm_wday = (total_hours/24 + 4) % 7;
 	
   
-		//УӰݣһʣµСʱ
+		//校正闰年影响的年份，计算一年中剩下的小时数
 		for (;;) {
-			//һСʱ
+			//一年的小时数
 			int total_hours_per_year = 365 * 24;
 
-			//ж
+			//判断闰年
 			if ((tm_time.tm_year & 3) == 0) {
-				//꣬һ24Сʱһ
+				//是闰年，一年则多24小时，即一天
 				total_hours_per_year += 24;
 			}
 
@@ -73,19 +79,19 @@ namespace lim {
 			left_hours -= total_hours_per_year;
 		}
 
-		//ȡСʱʱ
+		//取小时时间
 		tm_time.tm_hour = left_hours%24;
 	
-		//һʣµ
+		//一年中剩下的天数
 		int left_days_of_one_year = left_hours/24;
 
-		//ٶΪ
+		//假定为闰年
 		left_days_of_one_year++;
 
-		//ȡһĵڼ(ٶΪ)
+		//取一年的第几天(假定为非闰年)
 		tm_time.tm_yday = left_days_of_one_year % 365;
 	
-		//У·ݣ
+		//校正润年的误差，计算月份，日期
 		if ((tm_time.tm_year & 3) == 0)	{
 			tm_time.tm_yday --;
 		
@@ -93,7 +99,7 @@ namespace lim {
 				left_days_of_one_year--;
 			} else {
 				if (left_days_of_one_year == 60) {
-					//
+					//计算月日
 					tm_time.tm_mon = 1;
 					tm_time.tm_mday = 29;
 
@@ -111,7 +117,7 @@ namespace lim {
 			}
 		}
 
-		//
+		//计算月日
 		for (tm_time.tm_mon = 0; kArrayDaysPerMonth[tm_time.tm_mon] < left_days_of_one_year; tm_time.tm_mon++) {
 			left_days_of_one_year -= kArrayDaysPerMonth[tm_time.tm_mon];
 		}
@@ -0,0 +1,270 @@
+#include <lim/base/timer_wheel.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <string.h>
+
+namespace lim {
+	#define TIMER_WHEEL_MAX_DELTA (((int64_t)1 << (TIMER_WHEEL_LEVEL_NUM * TIMER_WHEEL_SLOT_BITS)) - 1)
+
+	static inline int CountTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (int)index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	static inline void InitListHead(TimerWheelNode *head) {
+		head->prev = head->next = head;
+	}
+
+	/**
+	*时间轮构造函数
+	* @param current_time 当前时间(微秒)
+	* @param tick_microsec 每个tick的时长(微秒)
+	*/
+	TimerWheel::TimerWheel(int64_t current_time, int64_t tick_microsec):
+		tick_microsec_(tick_microsec), node_count_(0), wheel_node_count_(0) {
+		current_tick_ = current_time / tick_microsec_;
+		for (int level = 0; level < TIMER_WHEEL_LEVEL_NUM; level++) {
+			for (int index = 0; index < TIMER_WHEEL_SLOT_NUM; index++) {
+				InitListHead(&slots_[level][index]);
+			}
+		}
+		memset(slot_bitmaps_, 0, sizeof(slot_bitmaps_));
+		InitListHead(&expired_);
+	}
+
+	/**
+	*加入时间轮(已在时间轮中则重新加入)
+	* @param node 时间轮节点
+	* @param expire_time 到期时间(微秒)
+	*/
+	void TimerWheel::Add(TimerWheelNode *node, int64_t expire_time) {
+		if (node->is_linked) {
+			Remove(node);
+		}
+
+		//向上取整,保证定时器不会提前触发
+		node->expire_tick = (expire_time + tick_microsec_ - 1) / tick_microsec_;
+		if (node->expire_tick < current_tick_) {
+			node->expire_tick = current_tick_;
+		}
+
+		Link(node);
+		node->is_linked = true;
+		node_count_++;
+	}
+
+	//从时间轮中移除
+	void TimerWheel::Remove(TimerWheelNode *node) {
+		if (!node->is_linked) {
+			return;
+		}
+
+		Unlink(node);
+		node->is_linked = false;
+		node_count_--;
+	}
+
+	//按到期tick放入对应层级的槽位
+	void TimerWheel::Link(TimerWheelNode *node) {
+		int64_t expire_tick = node->expire_tick;
+		if (expire_tick < current_tick_) {
+			expire_tick = current_tick_;
+		} else if (expire_tick - current_tick_ > TIMER_WHEEL_MAX_DELTA) {
+			//超出时间轮范围,先放入最高层,降级时再重新计算
+			expire_tick = current_tick_ + TIMER_WHEEL_MAX_DELTA;
+		}
+
+		int64_t delta = expire_tick - current_tick_;
+		int level = 0;
+		while (level < TIMER_WHEEL_LEVEL_NUM - 1 && delta >= ((int64_t)1 << ((level + 1) * TIMER_WHEEL_SLOT_BITS))) {
+			level++;
+		}
+		int index = (int)((expire_tick >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOT_NUM - 1));
+
+		TimerWheelNode *head = &slots_[level][index];
+		node->prev = head->prev;
+		node->next = head;
+		head->prev->next = node;
+		head->prev = node;
+		node->slot_level = level;
+		node->slot_index = index;
+
+		slot_bitmaps_[level][index / 64] |= ((uint64_t)1 << (index % 64));
+		wheel_node_count_++;
+	}
+
+	void TimerWheel::Unlink(TimerWheelNode *node) {
+		node->prev->next = node->next;
+		node->next->prev = node->prev;
+		node->prev = node->next = node;
+
+		if (node->slot_level < 0) {
+			return;
+		}
+
+		TimerWheelNode *head = &slots_[node->slot_level][node->slot_index];
+		if (head->next == head) {
+			slot_bitmaps_[node->slot_level][node->slot_index / 64] &= ~((uint64_t)1 << (node->slot_index % 64));
+		}
+		wheel_node_count_--;
+	}
+
+	//将高层槽位中的节点重新分配到低层
+	void TimerWheel::Cascade(int level, int index) {
+		TimerWheelNode *head = &slots_[level][index];
+		TimerWheelNode list;
+		if (head->next == head) {
+			return;
+		}
+
+		//先整体摘下链表,再逐个重新放入
+		list.next = head->next;
+		list.prev = head->prev;
+		list.next->prev = &list;
+		list.prev->next = &list;
+		InitListHead(head);
+		slot_bitmaps_[level][index / 64] &= ~((uint64_t)1 << (index % 64));
+
+		while (list.next != &list) {
+			TimerWheelNode *node = list.next;
+			list.next = node->next;
+			node->next->prev = &list;
+
+			wheel_node_count_--;
+			Link(node);
+		}
+	}
+
+	//从start开始循环查找第一个非空槽位,没有返回-1
+	int TimerWheel::FindNextSlot(int level, int start) {
+		const int kWordNum = TIMER_WHEEL_SLOT_NUM / 64;
+		for (int i = 0; i <= kWordNum; i++) {
+			int word_index = (start / 64 + i) % kWordNum;
+			uint64_t word = slot_bitmaps_[level][word_index];
+			if (i == 0) {
+				word &= (~(uint64_t)0 << (start % 64));
+			} else if (i == kWordNum) {
+				word &= ~(~(uint64_t)0 << (start % 64));
+			}
+
+			if (word != 0) {
+				return word_index * 64 + CountTrailingZeros(word);
+			}
+		}
+		return -1;
+	}
+
+	//槽位下一次被处理的tick
+	int64_t TimerWheel::FirstSlotTick(int level, int index) {
+		int shift = level * TIMER_WHEEL_SLOT_BITS;
+		int64_t base = (current_tick_ >> (shift + TIMER_WHEEL_SLOT_BITS)) << (shift + TIMER_WHEEL_SLOT_BITS);
+		int64_t tick = base + ((int64_t)index << shift);
+		if (tick < current_tick_) {
+			tick += ((int64_t)1 << (shift + TIMER_WHEEL_SLOT_BITS));
+		}
+		return tick;
+	}
+
+	//下一次需要处理的tick
+	int64_t TimerWheel::NextEventTick() {
+		int64_t next_tick = -1;
+		for (int level = 0; level < TIMER_WHEEL_LEVEL_NUM; level++) {
+			int shift = level * TIMER_WHEEL_SLOT_BITS;
+			int index = (int)((current_tick_ >> shift) & (TIMER_WHEEL_SLOT_NUM - 1));
+			//当前tick不在本层边界上时,当前槽位属于下一轮
+			if ((current_tick_ & (((int64_t)1 << shift) - 1)) != 0) {
+				index = (index + 1) % TIMER_WHEEL_SLOT_NUM;
+			}
+
+			int slot = FindNextSlot(level, index);
+			if (slot < 0) {
+				continue;
+			}
+
+			int64_t tick = FirstSlotTick(level, slot);
+			if (next_tick < 0 || tick < next_tick) {
+				next_tick = tick;
+			}
+		}
+		return next_tick;
+	}
+
+	//推进时间轮到指定tick
+	void TimerWheel::Advance(int64_t current_tick) {
+		while (wheel_node_count_ > 0) {
+			int64_t tick = NextEventTick();
+			if (tick < 0 || tick > current_tick) {
+				break;
+			}
+			current_tick_ = tick;
+
+			//逐层降级:低层转完一圈时处理上一层对应槽位
+			for (int level = 1; level < TIMER_WHEEL_LEVEL_NUM; level++) {
+				int shift = level * TIMER_WHEEL_SLOT_BITS;
+				if ((tick & (((int64_t)1 << shift) - 1)) != 0) {
+					break;
+				}
+				Cascade(level, (int)((tick >> shift) & (TIMER_WHEEL_SLOT_NUM - 1)));
+			}
+
+			//当前槽位整体移入到期链表
+			int index = (int)(tick & (TIMER_WHEEL_SLOT_NUM - 1));
+			TimerWheelNode *head = &slots_[0][index];
+			while (head->next != head) {
+				TimerWheelNode *node = head->next;
+				Unlink(node);
+
+				node->slot_level = -1;
+				node->prev = expired_.prev;
+				node->next = &expired_;
+				expired_.prev->next = node;
+				expired_.prev = node;
+			}
+			current_tick_ = tick + 1;
+		}
+
+		if (current_tick_ <= current_tick) {
+			current_tick_ = current_tick + 1;
+		}
+	}
+
+	/**
+	*获取下一次需要处理的时间(到期或降级)
+	* @return 时间轮为空返回-1, 否则返回时间(微秒)
+	*/
+	int64_t TimerWheel::NextExpireTime() {
+		if (expired_.next != &expired_) {
+			return (current_tick_ - 1) * tick_microsec_;
+		}
+
+		if (wheel_node_count_ == 0) {
+			return -1;
+		}
+		return NextEventTick() * tick_microsec_;
+	}
+
+	/**
+	*推进时间轮并取出一个到期节点
+	* @param current_time 当前时间(微秒)
+	* @return 没有到期节点返回NULL
+	*/
+	TimerWheelNode *TimerWheel::PopExpired(int64_t current_time) {
+		if (expired_.next == &expired_) {
+			Advance(current_time / tick_microsec_);
+		}
+
+		if (expired_.next == &expired_) {
+			return NULL;
+		}
+
+		TimerWheelNode *node = expired_.next;
+		Remove(node);
+		return node;
+	}
+}
@@ -5,10 +5,10 @@
 
 namespace lim {
 	/**
-	*Http
-	* @param max_first_line_size 󳤶
-	* @param max_header_size header󳤶
-	* @param max_content_size content󳤶
+	*Http解码器基类
+	* @param max_first_line_size 首行数据最大长度
+	* @param max_header_size header最大长度
+	* @param max_content_size content最大长度
 	*/
 	HttpBaseDecoder::HttpBaseDecoder(int max_first_line_size, int max_header_size, int max_content_size): 
 		current_state_(READ_INITIAL), chunk_size_(0), max_first_line_size_(max_first_line_size), 
@@ -29,20 +29,21 @@ namespace lim {
 			if (current_state_ != READ_CHUNKED_CONTENT) {
 				content.IsLast() = true;
 			}
-			length = content.Content().WriteBytes(buffer, (int)chunk_size_);
+			content.Content() = buffer.ReadSlice((int)chunk_size_);
 		} else {
-			length = content.Content().WriteBytes(buffer);
+			content.Content() = buffer.ReadSlice();
 		}
+		length = content.Content().ReadableBytes();
 		chunk_size_ -= length;
 		return length;
 	}
 
 	/**
-	*뺯
-	* @param buffer ݻ
-	* @param message_callback messageص
-	* @param error_callback Ϣص
-	* @param is_socket_closed socketǷѶϿ
+	*解码函数
+	* @param buffer 数据缓冲区
+	* @param message_callback 解码后的message回调函数
+	* @param error_callback 错误信息回调函数
+	* @param is_socket_closed socket连接是否已断开
 	*/
 	bool HttpBaseDecoder::Decode(ByteBuffer &buffer,
                             HandleMessageCallback &message_callback, 
@@ -285,7 +286,8 @@ namespace lim {
 					variable_content.IsLast() = true;
 				}
 					
-				bytes_for_current_state_ += variable_content.Content().WriteBytes(buffer);
+				variable_content.Content() = buffer.ReadSlice();
+				bytes_for_current_state_ += variable_content.Content().ReadableBytes();
 				if (max_content_size_ >= 0 && (max_content_size_ < bytes_for_current_state_)) {
 					//content size too long
 					HttpMessageError error_mssage("http content is too long");
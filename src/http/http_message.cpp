@@ -159,6 +159,32 @@ namespace lim {
 		return length;
 	}
 
+	//content以切片方式作为独立组件, 不拷贝
+	int HttpContent::ToBytes(CompositeByteBuffer &buffer) {
+		if (!IsChunked()) {
+			return buffer.AddComponent(content_);
+		}
+
+		int length = 0;
+		if (content_.ReadableBytes() > 0) {
+			std::stringstream ss;
+			ss << std::hex << content_.ReadableBytes() << "\r\n";
+			length += buffer.WriteBytes(ss.str().c_str(), ss.str().length());
+			length += buffer.AddComponent(content_);
+			length += buffer.WriteBytes("\r\n", strlen("\r\n"));
+		}
+
+		if (IsLast()) {
+			//the last chunked and trailing headers
+			ByteBuffer last_chunked;
+			last_chunked.WriteBytes("0", strlen("0"));
+			last_chunked.WriteBytes("\r\n", strlen("\r\n"));
+			TrailingHeaders().ToBytes(last_chunked);
+			length += buffer.AddComponent(last_chunked);
+		}
+		return length;
+	}
+
 	HttpRequest::HttpRequest(const std::string &method, const std::string &uri, const std::string &version):
 		http_request_line_(method, uri, version) {
 
@@ -196,6 +222,18 @@ namespace lim {
 		return length;
 	}
 
+	//首行及header为一个组件, content以切片方式追加
+	int HttpFullRequest::ToBytes(CompositeByteBuffer &buffer) {
+		ByteBuffer header_buffer;
+		int length = http_request_line_.ToBytes(header_buffer);
+		length += http_headers_.ToBytes(header_buffer);
+		buffer.AddComponent(header_buffer);
+
+		http_content_.IsChunked() = http_headers_.IsChunked();
+		length += http_content_.ToBytes(buffer);
+		return length;
+	}
+
 	HttpFullResponse::HttpFullResponse(int status_code, const std::string &reason_phrase, const std::string &version):
 		HttpResponse(status_code, reason_phrase, version) {
 
@@ -210,5 +248,16 @@ namespace lim {
 		length += http_content_.ToBytes(buffer);
 		return length;
 	}
-}
 
+	//首行及header为一个组件, content以切片方式追加
+	int HttpFullResponse::ToBytes(CompositeByteBuffer &buffer) {
+		ByteBuffer header_buffer;
+		int length = http_status_line_.ToBytes(header_buffer);
+		length += http_headers_.ToBytes(header_buffer);
+		buffer.AddComponent(header_buffer);
+
+		http_content_.IsChunked() = http_headers_.IsChunked();
+		length += http_content_.ToBytes(buffer);
+		return length;
+	}
+}
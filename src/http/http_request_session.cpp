@@ -6,10 +6,10 @@
 
 namespace lim {
 	/**
-	*Http
-	* @param max_first_line_size 󳤶
-	* @param max_header_size header󳤶
-	* @param max_content_size content󳤶
+	*Http请求解码器
+	* @param max_first_line_size 首行数据最大长度
+	* @param max_header_size header最大长度
+	* @param max_content_size content最大长度
 	*/
 	HttpRequestDecoder::HttpRequestDecoder(int max_first_line_size, 
 																							int max_header_size, 
@@ -55,12 +55,12 @@ namespace lim {
 		http_request_->Headers().SetHeaderValue(header_name, header_value);
 	}
 
-	//http message
+	//http message处理函数
 	bool HttpRequestDecoder::DoHttpMessage(HandleMessageCallback &message_callback) {
 		return message_callback(*http_request_);
 	}
 
-	//http content
+	//http content处理函数
 	bool HttpRequestDecoder::DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback) {
 		return message_callback(content);
 	}
@@ -71,10 +71,10 @@ namespace lim {
 	}
 
 	/**
-	*httpӦ(ԶServerͷϢ)
-	* @param response httpӦ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送http响应报文(自动加上Server头信息)
+	* @param response http响应报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool HttpRequestSession::WriteHttpResponse(HttpResponse &response, WriteCompleteCallback callback) {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig&)config_;
@@ -83,16 +83,36 @@ namespace lim {
 	}
 
 	/**
-	*http bodyӦ
-	* @param content http bodyӦ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送http body响应报文
+	* @param content http body响应报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool HttpRequestSession::WriteHttpConent(HttpContent &content, WriteCompleteCallback callback) {
 		return WriteMessage(content, callback);
 	}
+
+	/**
+	*发送http响应报文及文件内容(按文件区域长度设置Content-Length, 文件内容由sendfile直接发送, 可用于Range请求)
+	* @param response http响应报文(只包含首行及header)
+	* @param region 文件区域(由会话接管, 发送结束后释放)
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
+	*/
+	bool HttpRequestSession::WriteHttpFile(HttpResponse &response, FileRegion *region, WriteCompleteCallback callback) {
+		if (region == NULL || !region->IsOpen()) {
+			delete region;
+			return false;
+		}
+
+		HttpBootstrapConfig &config = (HttpBootstrapConfig&)config_;
+		response.Headers().SetHeaderValue("Server", config.GetServerName());
+		response.Headers().RemoveHeader("Transfer-Encoding");
+		response.Headers().SetHeaderValue("Content-Length", std::to_string(region->ReadableBytes()));
+		return WriteFile(response, region, callback);
+	}
 	
-	//Ľ
+	//创建报文解码器
 	MessageDecoder *HttpRequestSession::CreateDecoder() {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig &)config_;
 		int max_first_line_size = config.GetMaxFirstLineSize();
@@ -102,10 +122,10 @@ namespace lim {
 	}
 
 	/**
-	*עᴦ·
-	* @param method 
-	* @param path ·
-	* @param handle ص
+	*注册处理路由
+	* @param method 方法名称
+	* @param path 路径
+	* @param handle 回调函数
 	*/
 	bool HttpRequestSession::RegistHandleRouter(const std::string &method, const std::string &path, HttpRequstHandle &handle) {
 		if (handle == NULL) {
@@ -120,7 +140,7 @@ namespace lim {
 		return true;
 	}
 
-	//ıĴ
+	//解码后的报文处理函数
 	bool HttpRequestSession::HandleMessage(Message &message) {
 		if (typeid(message) == typeid(HttpContent)) {
 			if (current_handle_ == NULL) {
@@ -172,15 +192,20 @@ namespace lim {
 		return true;
 	}
 
-	//http message
+	//http message处理函数
 	bool HttpFullRequestDecoder::DoHttpMessage(HandleMessageCallback &message_callback) {
 		return true;
 	}
 
-	//http content
+	//http content处理函数
 	bool HttpFullRequestDecoder::DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback) {
 		HttpFullRequest *request = (HttpFullRequest *)http_request_;
-		content.ToBytes(request->Content().Content());
+		if (request->Content().Content().ReadableBytes() == 0) {
+			//第一段content直接共享切片, 避免拷贝
+			request->Content().Content() = content.Content();
+		} else {
+			content.ToBytes(request->Content().Content());
+		}
 		if (content.IsLast()) 
 			return message_callback(*request);
 		else
@@ -192,7 +217,7 @@ namespace lim {
 		
 	}
 
-	//Ľ
+	//创建报文解码器
 	MessageDecoder *HttpFullRequestSession::CreateDecoder() {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig &)config_;
 		int max_first_line_size = config.GetMaxFirstLineSize();
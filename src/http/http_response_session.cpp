@@ -7,10 +7,10 @@
 
 namespace lim {	
 	/**
-	*HttpӦ
-	* @param max_first_line_size 󳤶
-	* @param max_header_size header󳤶
-	* @param max_content_size content󳤶
+	*Http响应解码器
+	* @param max_first_line_size 首行数据最大长度
+	* @param max_header_size header最大长度
+	* @param max_content_size content最大长度
 	*/
 	HttpResponseDecoder::HttpResponseDecoder(int max_first_line_size, int max_header_size, int max_content_size): 
 		http_response_(NULL), HttpBaseDecoder(max_first_line_size, max_header_size, max_content_size) {
@@ -64,12 +64,12 @@ namespace lim {
 		http_response_->Headers().SetHeaderValue(header_name, header_value);
 	}
 
-	//http message
+	//http message处理函数
 	bool HttpResponseDecoder::DoHttpMessage(HandleMessageCallback &message_callback) {
 		return message_callback(*http_response_);
 	}
 
-	//http content
+	//http content处理函数
 	bool HttpResponseDecoder::DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback) {
 		return message_callback(content);
 	}
@@ -80,10 +80,10 @@ namespace lim {
 	}
 
 	/**
-	*http(ԶUser-AgentHostͷϢ)
-	* @param response httpӦ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送http请求报文(自动加上User-Agent、Host头信息)
+	* @param response http响应报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool HttpResponseSession::WriteHttpRequest(HttpRequest &request, WriteCompleteCallback callback) {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig&)config_;
@@ -97,16 +97,16 @@ namespace lim {
 	}
 
 	/**
-	*http body
-	* @param content http body
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送http body请求报文
+	* @param content http body请求报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool HttpResponseSession::WriteHttpConent(HttpContent &content, WriteCompleteCallback callback) {
 		return WriteMessage(content, callback);
 	}
 		
-	//Ľ
+	//创建报文解码器
 	MessageDecoder *HttpResponseSession::CreateDecoder() {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig &)config_;
 		int max_first_line_size = config.GetMaxFirstLineSize();
@@ -143,15 +143,20 @@ namespace lim {
 		return true;
 	}
 
-	//http message
+	//http message处理函数
 	bool HttpFullResponseDecoder::DoHttpMessage(HandleMessageCallback &message_callback) {
 		return true;
 	}
 
-	//http content
+	//http content处理函数
 	bool HttpFullResponseDecoder::DoHttpContent(HttpContent &content, HandleMessageCallback &message_callback) {
 		HttpFullResponse *response = (HttpFullResponse *)http_response_;
-		content.ToBytes(response->Content().Content());
+		if (response->Content().Content().ReadableBytes() == 0) {
+			//第一段content直接共享切片, 避免拷贝
+			response->Content().Content() = content.Content();
+		} else {
+			content.ToBytes(response->Content().Content());
+		}
 		if (content.IsLast()) 
 			return message_callback(*response);
 		else
@@ -163,7 +168,7 @@ namespace lim {
 		
 	}
 
-	//Ľ
+	//创建报文解码器
 	MessageDecoder *HttpFullResponseSession::CreateDecoder() {
 		HttpBootstrapConfig &config = (HttpBootstrapConfig &)config_;
 		int max_first_line_size = config.GetMaxFirstLineSize();
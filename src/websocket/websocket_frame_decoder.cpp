@@ -66,17 +66,17 @@ namespace lim {
 		return clone_frame;
 	}
 
-	//websocket frame
+	//websocket frame处理函数
 	bool WebSocketFrameDecoder::DoContent(WebSocketFrame &frame, HandleMessageCallback &message_callback, HandleErrorCallback &error_callback) {
 		return message_callback(frame);
 	}
 
 	/**
-	*뺯
-	* @param buffer ݻ
-	* @param message_callback messageص
-	* @param error_callback Ϣص
-	* @param is_socket_closed socketǷѶϿ
+	*解码函数
+	* @param buffer 数据缓冲区
+	* @param message_callback 解码后的message回调函数
+	* @param error_callback 错误信息回调函数
+	* @param is_socket_closed socket连接是否已断开
 	*/
 	bool WebSocketFrameDecoder::Decode(ByteBuffer &buffer, 
                                     HandleMessageCallback &message_callback, 
@@ -147,14 +147,13 @@ namespace lim {
           return true;
         }
 				
-        ByteBuffer content;
+        ByteBuffer content = buffer.ReadSlice((int)frame_payload_length_);
         if (frame_masked_) {
+          //切片独占这段数据, 直接原地解掩码
+          char *data = content.ReadableData();
           for (int64_t i = 0; i < frame_payload_length_; i++) {
-            uint8_t data = buffer.ReadUInt8();
-            content.WriteUInt8(data ^ frame_mask_[(int)(i % 4)]);
+            data[i] ^= frame_mask_[(int)(i % 4)];
           }
-        } else {
-          content.WriteBytes(buffer);
         }
 
         WebSocketFrame *frame = CreateWebSocketFream(content);
@@ -191,7 +190,7 @@ namespace lim {
     }
   }
 
-	//websocket frame
+	//websocket frame处理函数
   bool WebSocketFullFrameDecoder::DoContent(WebSocketFrame &frame, HandleMessageCallback &message_callback, HandleErrorCallback &error_callback) {
     if (full_frames_[frame.FrameOpCode()] == NULL) {
       full_frames_[frame.FrameOpCode()] = CloneWebSocketFream(frame);
@@ -12,7 +12,8 @@ namespace lim {
 
 	}
 
-	int WebSocketFrame::ToBytes(ByteBuffer &buffer) {
+	//写frame头部(不包含掩码)
+	void WebSocketFrame::WriteFrameHeader(ByteBuffer &buffer) {
 		int length = frame_content_.ReadableBytes();
     
 		uint8_t first_byte = 0;
@@ -51,7 +52,12 @@ namespace lim {
 			buffer.WriteUInt8(second_byte);
 			buffer.WriteUInt64(length);
 		}
-		
+	}
+
+	int WebSocketFrame::ToBytes(ByteBuffer &buffer) {
+		int length = frame_content_.ReadableBytes();
+		WriteFrameHeader(buffer);
+
 		//write payload
 		if (frame_masked_) {
 			std::srand((unsigned int)(time(NULL)));
@@ -71,6 +77,22 @@ namespace lim {
 		return 0;
 	}
 
+	//不带掩码时payload以切片方式作为独立组件, 不拷贝
+	int WebSocketFrame::ToBytes(CompositeByteBuffer &buffer) {
+		if (frame_masked_) {
+			ByteBuffer frame_buffer;
+			ToBytes(frame_buffer);
+			buffer.AddComponent(frame_buffer);
+			return 0;
+		}
+
+		ByteBuffer header_buffer;
+		WriteFrameHeader(header_buffer);
+		buffer.AddComponent(header_buffer);
+		buffer.AddComponent(frame_content_);
+		return 0;
+	}
+
 	ContinuationWebSocketFrame::ContinuationWebSocketFrame(bool frame_final_flag, int frame_rsv):
 		WebSocketFrame(0, frame_final_flag, frame_rsv) {
 
@@ -15,10 +15,10 @@ namespace lim {
 	}
 
 	/**
-	*websocket frame
-	* @param websocket frameӦ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送websocket frame报文
+	* @param websocket frame响应报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool WebSocketRequestSession::WriteWebSocketFrame(WebSocketFrame &frame, WriteCompleteCallback callback) {
 		frame.FrameMasked() = false;
@@ -26,9 +26,9 @@ namespace lim {
 	}
 	
 	/**
-	*עᴦ·
-	* @param path ·
-	* @param handle ص
+	*注册处理路由
+	* @param path 路径
+	* @param handle 回调函数
 	*/
 	bool WebSocketRequestSession::RegistHandleRouter(const std::string &path, WebSocketFrameHandle &handle) {
 		if (handle == NULL) {
@@ -43,7 +43,7 @@ namespace lim {
 		return true;
 	}
 
-	//Ľ
+	//创建报文解码器
 	MessageDecoder* WebSocketRequestSession::CreateDecoder() {
 		delete message_decoder_;
 		message_decoder_ = NULL;
@@ -60,7 +60,7 @@ namespace lim {
 		}
 	}
 
-	//ִ
+	//握手处理
 	bool WebSocketRequestSession::Handshake(HttpFullRequest& request) {
 		if (strcasecmp(request.RequestLine().GetMethod().c_str(), "GET")) {
 			HttpFullResponse http_response(403, "Forbidden", "HTTP/1.1");
@@ -134,7 +134,7 @@ namespace lim {
 		return true;
 	}
 
-	//ıĴ
+	//解码后的报文处理函数
 	bool WebSocketRequestSession::HandleMessage(Message &message) {
 		if (typeid(message) == typeid(HttpFullRequest)) {    
 			bool is_ok = Handshake((HttpFullRequest&)message);
@@ -153,7 +153,7 @@ namespace lim {
 
 	}
 
-	//Ľ
+	//创建报文解码器
 	MessageDecoder* WebSocketFullRequestSession::CreateDecoder() {
 		delete message_decoder_;
 		message_decoder_ = NULL;
@@ -16,17 +16,17 @@ namespace lim {
 	}
 
 	/**
-	*websocket frame
-	* @param websocket frameӦ
-	* @param callback ͽĻص
-	* @return ʧܷfalse, ɹtrue
+	*发送websocket frame报文
+	* @param websocket frame响应报文
+	* @param callback 发送结束后的回调函数
+	* @return 失败返回false, 成功返回true
 	*/
 	bool WebSocketResponseSession::WriteWebSocketFrame(WebSocketFrame &frame, WriteCompleteCallback callback) {
 		frame.FrameMasked() = true;
 		return WriteMessage(frame, callback);
 	}
 	
-	//Ľ
+	//创建报文解码器
 	MessageDecoder* WebSocketResponseSession::CreateDecoder() {
 		delete message_decoder_;
 		message_decoder_ = NULL;
@@ -43,7 +43,7 @@ namespace lim {
 		}
 	}
 
-	//ֱ
+	//发送握手报文
   void WebSocketResponseSession::DoHandshake(const std::string &path, std::map< std::string, std::string> *header) {
 		//generate sec_websocket_key
 		std::srand((unsigned int)(time(NULL)));
@@ -72,7 +72,7 @@ namespace lim {
 		WriteHttpRequest(request, NULL);
 	}
 	
-	//ִ
+	//握手处理
 	bool WebSocketResponseSession::Handshake(HttpFullResponse& response) {
 		if (response.StatusLine().GetStatusCode() != 101) {
 			std::stringstream ss;
@@ -112,12 +112,12 @@ namespace lim {
 		return true;
 	}
 
-  //ֳɹ
+  //握手成功后
   void WebSocketResponseSession::HandleHandshaked() {
 
   }
 
-	//ıĴ
+	//解码后的报文处理函数
 	bool WebSocketResponseSession::HandleMessage(Message &message) {
 		if (typeid(message) == typeid(HttpFullResponse)) {    
 			bool is_ok = Handshake((HttpFullResponse&)message);
@@ -137,7 +137,7 @@ namespace lim {
 
 	}
 
-	//Ľ
+	//创建报文解码器
 	MessageDecoder* WebSocketFullResponseSession::CreateDecoder() {
 		delete message_decoder_;
 		message_decoder_ = NULL;